@@ -313,6 +313,7 @@ extern "C"
 {
 #  include <dlfcn.h>
 #  include <sys/wait.h>
+#  include <sys/resource.h>
 #  include <regex.h>
 #  include <stdint.h>
 }
@@ -1298,11 +1299,14 @@ constexpr char array_index(size_t n, const char (&array)[N])
       translator(set_timeout),    /*  7 */       \
       translator(cancel_timeout), /*  8 */       \
       translator(begin_test),     /*  9 */       \
-      translator(end_test)        /* 10 */
+      translator(end_test),       /* 10 */       \
+      translator(metric),         /* 11 */       \
+      translator(truncated)       /* 12 */
 
     typedef enum {
       CRPCUT_COMM_MSGS(CRPCUT_VERBATIM),
-      kill_me = 0x100
+      kill_me = 0x100,
+      continued = 0x200 // more frames of the same message follow
     } type;
   }
 
@@ -1384,6 +1388,13 @@ constexpr char array_index(size_t n, const char (&array)[N])
       virtual const data_writer &
       write_loop(const void *buff, size_t len,
                  const char *context = "write_loop") const;
+      // The frames of one message are written between begin_message()
+      // and end_message(), so that a writer shared by several threads or
+      // processes can keep them together. max_frame() is the largest
+      // frame, header included, that is written in one piece.
+      virtual void begin_message() const;
+      virtual void end_message() const;
+      virtual size_t max_frame() const;
     };
 
 
@@ -1399,14 +1410,20 @@ constexpr char array_index(size_t n, const char (&array)[N])
 
     // protocol is type -> size_t(length) -> char[length]. length may be 0.
 
+    class failure_filter;
+
     class reporter
     {
-      data_writer  *writer_;
-      data_reader  *reader_;
-      std::ostream &default_out_;
+      data_writer    *writer_;
+      data_reader    *reader_;
+      std::ostream   &default_out_;
+      failure_filter *filter_;
 
       typedef crpcut_test_monitor tm;
     public:
+      // Messages longer than a frame are sent as several frames, all
+      // but the last of type t | continued.
+      static const size_t frame_size = 16384;
       static datatypes::fixed_string no_location()
       {
         datatypes::fixed_string n = { 0, 0 };
@@ -1415,6 +1432,8 @@ constexpr char array_index(size_t n, const char (&array)[N])
       virtual ~reporter();
       reporter(std::ostream &default_out = std::cout);
       void set_writer(data_writer *w);
+      // Failures are coalesced by the filter, if one is set.
+      void set_failure_filter(failure_filter *f);
       void operator()(type                       t,
                       const std::ostringstream  &os,
                       datatypes::fixed_string    location = no_location(),
@@ -1457,6 +1476,7 @@ constexpr char array_index(size_t n, const char (&array)[N])
                         const char             *msg,
                         size_t                  len,
                         datatypes::fixed_string location) const;
+      void send_failure_summary(const crpcut_test_monitor *mon) const;
 
       template <typename T>
       void read(T& t) const;
@@ -1509,6 +1529,15 @@ constexpr char array_index(size_t n, const char (&array)[N])
 
   } // namespace comm
 
+  namespace isolate {
+    // namespaces a test process can be started in, see ISOLATED_NAMESPACES
+    typedef enum {
+      network = 1, // only a loopback interface
+      tmp     = 2, // private mount namespace with an empty /tmp
+      pid     = 4  // own process id namespace
+    } type;
+  }
+
   namespace policies {
 
     class crpcut_exception_translator
@@ -1562,6 +1591,15 @@ constexpr char array_index(size_t n, const char (&array)[N])
       class crpcut_default_handler;
     }
 
+    namespace isolation {
+      class crpcut_none;
+    }
+
+    namespace limits {
+      class crpcut_no_memory_max;
+      class crpcut_no_cpu_max;
+    }
+
     namespace timeout {
       typedef enum { realtime, cputime } type;
 
@@ -1588,6 +1626,9 @@ constexpr char array_index(size_t n, const char (&array)[N])
       typedef void crpcut_run_wrapper;
 
       typedef core_dumps::crpcut_default_handler crpcut_core_dump_handler;
+      typedef isolation::crpcut_none crpcut_isolation_handler;
+      typedef limits::crpcut_no_memory_max crpcut_memory_limit;
+      typedef limits::crpcut_no_cpu_max crpcut_cpu_limit;
       typedef deaths::crpcut_none crpcut_expected_death_cause;
 
       typedef dependencies::crpcut_none crpcut_dependency;
@@ -1615,6 +1656,54 @@ constexpr char array_index(size_t n, const char (&array)[N])
         virtual bool crpcut_core_dumps_allowed() const;
       };
     }
+
+    namespace isolation {
+      class crpcut_none
+      {
+      public:
+        virtual ~crpcut_none();
+        virtual unsigned crpcut_isolated_namespaces() const;
+      };
+
+      template <unsigned flags>
+      class namespaces : public virtual crpcut_none
+      {
+      public:
+        virtual unsigned crpcut_isolated_namespaces() const { return flags; }
+      };
+    }
+
+    namespace limits {
+      class crpcut_no_memory_max
+      {
+      public:
+        virtual ~crpcut_no_memory_max();
+        virtual unsigned long crpcut_memory_max() const;
+      };
+
+      template <unsigned long bytes>
+      class memory_max : public virtual crpcut_no_memory_max
+      {
+      public:
+        virtual unsigned long crpcut_memory_max() const { return bytes; }
+      };
+
+      class crpcut_no_cpu_max
+      {
+      public:
+        virtual ~crpcut_no_cpu_max();
+        virtual unsigned long crpcut_cpu_quota_us() const;
+        virtual unsigned long crpcut_cpu_period_us() const;
+      };
+
+      template <unsigned long quota_us, unsigned long period_us>
+      class cpu_max : public virtual crpcut_no_cpu_max
+      {
+      public:
+        virtual unsigned long crpcut_cpu_quota_us() const { return quota_us; }
+        virtual unsigned long crpcut_cpu_period_us() const { return period_us; }
+      };
+    }
     namespace deaths {
 
       class crpcut_none
@@ -1753,6 +1842,27 @@ constexpr char array_index(size_t n, const char (&array)[N])
       no_core_file();
     };
 
+    template <unsigned flags>
+    class isolated_namespaces : protected virtual crpcut_default_policy
+    {
+    protected:
+      typedef isolation::namespaces<flags> crpcut_isolation_handler;
+    };
+
+    template <unsigned long bytes>
+    class cgroup_memory_max : protected virtual crpcut_default_policy
+    {
+    protected:
+      typedef limits::memory_max<bytes> crpcut_memory_limit;
+    };
+
+    template <unsigned long quota_us, unsigned long period_us>
+    class cgroup_cpu_max : protected virtual crpcut_default_policy
+    {
+    protected:
+      typedef limits::cpu_max<quota_us, period_us> crpcut_cpu_limit;
+    };
+
     namespace dependencies {
 
       class basic_enforcer;
@@ -2033,15 +2143,34 @@ constexpr char array_index(size_t n, const char (&array)[N])
     virtual bool do_read_data();
   };
 
+  class report_ring;
   class report_reader : public fdreader
   {
   public:
+    // A message is kept up to this length. What is left out is
+    // presented as truncated.
+    static const size_t max_message = 1024*1024;
     report_reader(crpcut_test_monitor *r);
+    ~report_reader();
     using fdreader::set_fd;
+    void set_channel(report_ring *ring, bool packets);
+    virtual ssize_t read(void *buff, size_t len) const;
+    virtual void close();
   private:
     void set_timeout(void *buff, size_t len);
     void cancel_timeout();
+    bool drain_ring(int t, size_t len, char *buff, size_t left_out);
+    bool handle_frame(int t, size_t len, char *buff, size_t left_out);
+    void present_left_out(int t);
+    bool handle_message(comm::type t, size_t len, char *buff);
     virtual bool do_read_data();
+    report_ring    *ring_;
+    bool            packets_;
+    mutable char   *packet_;
+    mutable size_t  packet_len_;
+    mutable size_t  packet_pos_;
+    std::string     partial_; // frames of a message not yet complete
+    size_t          left_out_; // bytes of the message not kept
   };
 
   class timeboxed
@@ -2061,6 +2190,12 @@ constexpr char array_index(size_t n, const char (&array)[N])
     bool          crpcut_deadline_set_;
   };
 
+  class cgroup;
+  class perf_counters;
+  class output_capture;
+  class output_cap;
+  class profile;
+  class stack_snapshot;
   class process_control;
   process_control *process_control_root();
   class filesystem_operations;
@@ -2073,6 +2208,9 @@ constexpr char array_index(size_t n, const char (&array)[N])
     : public virtual policies::deaths::crpcut_none,
       public virtual policies::dependencies::crpcut_base,
       public virtual policies::core_dumps::crpcut_default_handler,
+      public virtual policies::isolation::crpcut_none,
+      public virtual policies::limits::crpcut_no_memory_max,
+      public virtual policies::limits::crpcut_no_cpu_max,
       public timeboxed,
       public datatypes::list_elem<crpcut_test_case_registrator>,
       public crpcut_test_monitor
@@ -2100,12 +2238,17 @@ constexpr char array_index(size_t n, const char (&array)[N])
     virtual void setup(poll<fdreader> &poller,
                        int             in_fd,
                        int             stdout_fd,
-                       int             stderr_fd) = 0;
+                       int             stderr_fd,
+                       report_ring    *ring,
+                       bool            packets) = 0;
     void set_test_environment(test_environment *env);
     datatypes::fixed_string get_location() const;
     void manage_death();
     using datatypes::list_elem<crpcut_test_case_registrator>::unlink;
     void kill();
+    void suspected_deadlock(unsigned long      idle_ms,
+                            const std::string &threads,
+                            bool               kill);
     void clear_deadline();
     void unregister_fds();
     void set_wd(unsigned n);
@@ -2128,6 +2271,12 @@ constexpr char array_index(size_t n, const char (&array)[N])
     void set_death_note();
     void send_to_presentation(comm::type t, size_t len, const char *buff) const;
     void set_pid(pid_t pid);
+    void set_cgroup(cgroup *c);
+    void set_perf_counters(perf_counters *c);
+    void set_output_capture(output_capture *c);
+    void set_output_cap(output_cap *c);
+    void set_profile(profile *p);
+    void set_stack_snapshot(stack_snapshot *s);
   protected:
     crpcut_test_case_registrator(const char *name = 0, namespace_info *ns = 0);
     void manage_test_case_execution(crpcut_test_case_base*);
@@ -2140,6 +2289,13 @@ constexpr char array_index(size_t n, const char (&array)[N])
     bool check_exit_status(int status, std::ostream &out);
     bool report_nonempty_working_dir(const char* dirname);
     bool cputime_timeout(unsigned long us) const;
+    void report_cgroup_usage();
+    void report_perf_counters();
+    void report_runner_stats(unsigned long death_us);
+    void report_rusage(const struct rusage &usage, unsigned long cputime_us);
+    void report_stacks();
+    void present_captured_output();
+    void present_truncated_output();
     std::ostream &print_name(std::ostream &) const ;
 
     const char                   *name_;
@@ -2160,6 +2316,12 @@ constexpr char array_index(size_t n, const char (&array)[N])
     comm::reporter               *reporter_;
     process_control              *process_;
     filesystem_operations        *filesystem_;
+    cgroup                       *cgroup_;
+    perf_counters                *counters_;
+    output_capture               *capture_;
+    output_cap                   *cap_;
+    profile                      *profile_;
+    stack_snapshot               *stack_snapshot_;
   };
 
   namespace cli {
@@ -2411,13 +2573,9 @@ constexpr char array_index(size_t n, const char (&array)[N])
           stream_param(os, prefix[prev], n2, v2);
           std::string s(os.str());
           os.str(std::string());
-          size_t len = s.length();
-          char *p = static_cast<char *>(alloca(len));
-          s.copy(p, len);
-          std::string().swap(s);
           os.~ostringstream();
           new (&os) ostringstream();
-          this->report_(action, p, len, location_, mon_);
+          this->report_(action, s.data(), s.length(), location_, mon_);
         }
       }
   private:
@@ -3694,11 +3852,8 @@ constexpr char array_index(size_t n, const char (&array)[N])
       os.str().swap(s);
       os.~ostringstream();
       new (&os) ostringstream(); // Just how ugly is this?
-      size_t len = s.length();
-      char *p = static_cast<char*>(alloca(len));
-      s.copy(p, len);
+      report_(type, s.data(), s.length(), location_, mon_);
       std::string().swap(s);
-      report_(type, p, len, location_, mon_);
       heap::set_limit(heap_limit);
     }
 
@@ -4418,6 +4573,177 @@ constexpr char array_index(size_t n, const char (&array)[N])
       comm::reporter            &reporter_;
       const crpcut_test_monitor *mon_;
     };
+
+    class counter_base
+    {
+    public:
+      typedef enum {
+        instructions, cycles, branch_misses, cache_misses
+      } event;
+      struct max
+      {
+        static const char *name();
+        static bool busted(unsigned long long count, unsigned long long limit);
+      };
+      ~counter_base();
+      operator bool() const { return false; }
+      void silence_warning() const {}
+    protected:
+      counter_base(event e, unsigned long long limit,
+                   datatypes::fixed_string location);
+      counter_base(const counter_base &r); // takes over the counter
+      // false if no counter could be opened
+      bool read(unsigned long long &count) const;
+      // false once a copy has taken over the counter
+      bool owner() const { return owner_; }
+      // e.g. "INSTRUCTIONS"
+      const char *event_name() const;
+      // 0, or the name of the software event counted in its place
+      const char *fallback_name() const;
+
+      int mutable                   fd_;
+      bool mutable                  owner_;
+      const event                   event_;
+      bool                          fallback_;
+      unsigned long long const      limit_;
+      const datatypes::fixed_string location_;
+    private:
+      counter_base& operator=(const counter_base&);
+    };
+    template <comm::type action, typename cond, counter_base::event e>
+    class counter : public counter_base
+    {
+    public:
+      template <size_t N>
+      counter(unsigned long long limit, const char (&location)[N],
+              comm::reporter &reporter = comm::report,
+              const crpcut_test_monitor *mon = crpcut_test_monitor::current_test())
+        : counter_base(e, limit, datatypes::fixed_string::make(location)),
+          reporter_(reporter),
+          mon_(mon)
+      {
+      }
+      ~counter()
+      {
+        if (!owner()) return;
+        unsigned long long count = 0;
+        const bool measured = read(count);
+        const char *fallback = fallback_name();
+        if (measured && !fallback)
+          {
+            if (!cond::busted(count, limit_)) return;
+            comm::direct_reporter<action> out(location_, reporter_, mon_);
+            describe(out);
+            out << "\nActual count was " << count;
+            return;
+          }
+        // A software counter counts something else, so the limit is
+        // not held against it, and the count is only told.
+        comm::direct_reporter<comm::info> out(location_, reporter_, mon_);
+        describe(out);
+        if (!measured)
+          {
+            out << "\nNot checked, no performance counter could be opened";
+            return;
+          }
+        out << "\nNot checked, no hardware counter. Counted "
+            << fallback << ": " << count;
+      }
+    private:
+      template <typename R>
+      void describe(R &out) const
+      {
+        out << crpcut_check_name<action>::string()
+            << "_SCOPE_" << cond::name()
+            << "_" << event_name() << "(" << limit_ << ")";
+      }
+
+      comm::reporter            &reporter_;
+      const crpcut_test_monitor *mon_;
+    };
+
+    class usage_base
+    {
+    public:
+      struct max
+      {
+        static const char *name();
+        static bool busted(unsigned long count, unsigned long limit);
+      };
+      // Counts of the calling thread, from getrusage()
+      struct major_faults
+      {
+        static const char *name();
+        static unsigned long now();
+      };
+      struct minor_faults
+      {
+        static const char *name();
+        static unsigned long now();
+      };
+      struct voluntary_switches
+      {
+        static const char *name();
+        static unsigned long now();
+      };
+      struct involuntary_switches
+      {
+        static const char *name();
+        static unsigned long now();
+      };
+      ~usage_base() {}
+      operator bool() const { return false; }
+      void silence_warning() const {}
+    protected:
+      usage_base(unsigned long start, datatypes::fixed_string location);
+      unsigned long const           start_;
+      const datatypes::fixed_string location_;
+    };
+    template <comm::type action, typename cond, typename measure>
+    class usage : public usage_base
+    {
+    public:
+      template <size_t N>
+      usage(unsigned long limit, const char (&location)[N],
+            comm::reporter &reporter = comm::report,
+            const crpcut_test_monitor *mon = crpcut_test_monitor::current_test())
+        : usage_base(measure::now(), datatypes::fixed_string::make(location)),
+          limit_(limit),
+          active_(true),
+          reporter_(reporter),
+          mon_(mon)
+      {
+      }
+      ~usage()
+      {
+        if (!active_) return;
+        unsigned long count = measure::now() - start_;
+        if (cond::busted(count, limit_))
+          {
+            comm::direct_reporter<action>(location_, reporter_, mon_)
+              << crpcut_check_name<action>::string()
+              << "_SCOPE_" << cond::name()
+              << "_" << measure::name() << "(" << limit_ << ")"
+              "\nActual count was " << count;
+          }
+      }
+      usage(const usage& r)
+        : usage_base(r),
+          limit_(r.limit_),
+          active_(r.active_),
+          reporter_(r.reporter_),
+          mon_(r.mon_)
+      {
+        r.active_ = false;
+      }
+    private:
+      usage& operator=(const usage&);
+
+      unsigned long const        limit_;
+      bool mutable               active_;
+      comm::reporter            &reporter_;
+      const crpcut_test_monitor *mon_;
+    };
   }
 
 } // namespace crpcut
@@ -4460,9 +4786,16 @@ extern crpcut::namespace_info crpcut_current_namespace;
         public virtual crpcut_testsuite_dep,                            \
         public test_case_name::crpcut_constructor_timeout_enforcer,     \
         public test_case_name::crpcut_destructor_timeout_enforcer,      \
-        public virtual test_case_name::crpcut_core_dump_handler         \
+        public virtual test_case_name::crpcut_core_dump_handler,        \
+        public virtual test_case_name::crpcut_isolation_handler,        \
+        public virtual test_case_name::crpcut_memory_limit,             \
+        public virtual test_case_name::crpcut_cpu_limit                 \
     {                                                                   \
       using crpcut_core_dump_handler::crpcut_core_dumps_allowed;        \
+      using crpcut_isolation_handler::crpcut_isolated_namespaces;       \
+      using crpcut_memory_limit::crpcut_memory_max;                     \
+      using crpcut_cpu_limit::crpcut_cpu_quota_us;                      \
+      using crpcut_cpu_limit::crpcut_cpu_period_us;                     \
       crpcut::report_reader                report_reader_;              \
       crpcut::reader<crpcut::comm::stdout> stdout_reader_;              \
       crpcut::reader<crpcut::comm::stderr> stderr_reader_;              \
@@ -4474,11 +4807,14 @@ extern crpcut::namespace_info crpcut_current_namespace;
       void setup(crpcut::poll<crpcut::fdreader> &poller,                \
                  int                             in_fd,                 \
                  int                             stdout_fd,             \
-                 int                             stderr_fd)             \
+                 int                             stderr_fd,             \
+                 crpcut::report_ring            *ring,                  \
+                 bool                            packets)               \
       {                                                                 \
-        stdout_reader_.set_fd(stdout_fd, &poller);                      \
-        stderr_reader_.set_fd(stderr_fd, &poller);                      \
+        if (stdout_fd >= 0) stdout_reader_.set_fd(stdout_fd, &poller);  \
+        if (stderr_fd >= 0) stderr_reader_.set_fd(stderr_fd, &poller);  \
         report_reader_.set_fd(in_fd, &poller);                          \
+        report_reader_.set_channel(ring, packets);                      \
       }                                                                 \
     public:                                                             \
        crpcut_registrator()                                             \
@@ -4622,6 +4958,15 @@ namespace crpcut {
 #define NO_CORE_FILE \
   protected virtual crpcut::policies::no_core_file
 
+#define ISOLATED_NAMESPACES(flags) \
+  protected virtual crpcut::policies::isolated_namespaces<(flags)>
+
+#define CGROUP_MEMORY_MAX(bytes) \
+  protected virtual crpcut::policies::cgroup_memory_max<(bytes)>
+
+#define CGROUP_CPU_MAX(quota_us, period_us) \
+  protected virtual crpcut::policies::cgroup_cpu_max<(quota_us), (period_us)>
+
 #define WIPE_WORKING_DIR \
   crpcut::policies::deaths::wipe_working_dir
 
@@ -4902,18 +5247,11 @@ namespace crpcut
                               pred,                                     \
                               crpcut::params(__VA_ARGS__)))             \
         {                                                               \
-          size_t CRPCUT_LOCAL_NAME(len) = CRPCUT_LOCAL_NAME(m).length(); \
-          char *CRPCUT_LOCAL_NAME(p)                                    \
-            = static_cast<char*>(alloca(CRPCUT_LOCAL_NAME(len)+1));     \
-          CRPCUT_LOCAL_NAME(m).copy(CRPCUT_LOCAL_NAME(p),               \
-                                    CRPCUT_LOCAL_NAME(len));            \
-          CRPCUT_LOCAL_NAME(p)[CRPCUT_LOCAL_NAME(len)]=0;               \
-          std::string().swap(CRPCUT_LOCAL_NAME(m));                     \
           CRPCUT_CHECK_REPORT_HEAD(action)                              \
             << "_PRED(" #pred                                           \
             << CRPCUT_LOCAL_NAME(sep)[!*#__VA_ARGS__]                   \
             << #__VA_ARGS__ ")\n"                                       \
-            << CRPCUT_LOCAL_NAME(p);                                    \
+            << CRPCUT_LOCAL_NAME(m);                                    \
         }                                                               \
     }                                                                   \
     CATCH_BLOCK(..., {                                                  \
@@ -4958,6 +5296,70 @@ namespace crpcut
 #define VERIFY_SCOPE_MAX_CPUTIME_MS(ms)         \
   CRPCUT_CHECK_SCOPE_TYPE_TIME_MS(fail, max, cputime, ms)
 
+#define CRPCUT_CHECK_SCOPE_TYPE_COUNT(action, type, event, n)           \
+  if (const crpcut::scope::counter_base& CRPCUT_LOCAL_NAME(count_scope) \
+      = crpcut::scope::counter<crpcut::comm::action,                    \
+                               crpcut::scope::counter_base::type,       \
+                               crpcut::scope::counter_base::event>((n), \
+                                                                   CRPCUT_HERE)) \
+    { CRPCUT_LOCAL_NAME(count_scope).silence_warning(); } else          \
+
+#define ASSERT_SCOPE_MAX_INSTRUCTIONS(n)        \
+  CRPCUT_CHECK_SCOPE_TYPE_COUNT(exit_fail, max, instructions, n)
+
+#define ASSERT_SCOPE_MAX_CYCLES(n)              \
+  CRPCUT_CHECK_SCOPE_TYPE_COUNT(exit_fail, max, cycles, n)
+
+#define ASSERT_SCOPE_MAX_BRANCH_MISSES(n)       \
+  CRPCUT_CHECK_SCOPE_TYPE_COUNT(exit_fail, max, branch_misses, n)
+
+#define ASSERT_SCOPE_MAX_CACHE_MISSES(n)        \
+  CRPCUT_CHECK_SCOPE_TYPE_COUNT(exit_fail, max, cache_misses, n)
+
+#define VERIFY_SCOPE_MAX_INSTRUCTIONS(n)        \
+  CRPCUT_CHECK_SCOPE_TYPE_COUNT(fail, max, instructions, n)
+
+#define VERIFY_SCOPE_MAX_CYCLES(n)              \
+  CRPCUT_CHECK_SCOPE_TYPE_COUNT(fail, max, cycles, n)
+
+#define VERIFY_SCOPE_MAX_BRANCH_MISSES(n)       \
+  CRPCUT_CHECK_SCOPE_TYPE_COUNT(fail, max, branch_misses, n)
+
+#define VERIFY_SCOPE_MAX_CACHE_MISSES(n)        \
+  CRPCUT_CHECK_SCOPE_TYPE_COUNT(fail, max, cache_misses, n)
+
+#define CRPCUT_CHECK_SCOPE_TYPE_USAGE(action, type, measure, n)         \
+  if (const crpcut::scope::usage_base& CRPCUT_LOCAL_NAME(usage_scope)   \
+      = crpcut::scope::usage<crpcut::comm::action,                      \
+                             crpcut::scope::usage_base::type,           \
+                             crpcut::scope::usage_base::measure>((n),   \
+                                                                 CRPCUT_HERE)) \
+    { CRPCUT_LOCAL_NAME(usage_scope).silence_warning(); } else          \
+
+#define ASSERT_SCOPE_MAX_MAJOR_FAULTS(n)        \
+  CRPCUT_CHECK_SCOPE_TYPE_USAGE(exit_fail, max, major_faults, n)
+
+#define ASSERT_SCOPE_MAX_MINOR_FAULTS(n)        \
+  CRPCUT_CHECK_SCOPE_TYPE_USAGE(exit_fail, max, minor_faults, n)
+
+#define ASSERT_SCOPE_MAX_VOLUNTARY_SWITCHES(n)  \
+  CRPCUT_CHECK_SCOPE_TYPE_USAGE(exit_fail, max, voluntary_switches, n)
+
+#define ASSERT_SCOPE_MAX_INVOLUNTARY_SWITCHES(n) \
+  CRPCUT_CHECK_SCOPE_TYPE_USAGE(exit_fail, max, involuntary_switches, n)
+
+#define VERIFY_SCOPE_MAX_MAJOR_FAULTS(n)        \
+  CRPCUT_CHECK_SCOPE_TYPE_USAGE(fail, max, major_faults, n)
+
+#define VERIFY_SCOPE_MAX_MINOR_FAULTS(n)        \
+  CRPCUT_CHECK_SCOPE_TYPE_USAGE(fail, max, minor_faults, n)
+
+#define VERIFY_SCOPE_MAX_VOLUNTARY_SWITCHES(n)  \
+  CRPCUT_CHECK_SCOPE_TYPE_USAGE(fail, max, voluntary_switches, n)
+
+#define VERIFY_SCOPE_MAX_INVOLUNTARY_SWITCHES(n) \
+  CRPCUT_CHECK_SCOPE_TYPE_USAGE(fail, max, involuntary_switches, n)
+
 #define CRPCUT_CHECK_SCOPE_HEAP_LEAK_FREE(type)                         \
   if (const crpcut::heap::local_root & CRPCUT_LOCAL_NAME(leak_free_scope) \
       = crpcut::heap::local_root(crpcut::comm::type, CRPCUT_HERE))      \
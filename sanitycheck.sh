@@ -28,9 +28,19 @@ DIR="$2"
 
 DISABLED=1
 BLOCKED=7
-R=296
+R=299
 RN=$(($R+$BLOCKED))
 F=163
+# Hosts that cannot create namespaces run the isolated tests without
+# isolation, and tell so. The tests then fail, so leave them out there.
+ISOLATION=3
+TAGS=""
+./test/testprog -v namespaces::should_succeed_as_second_process_in_pid_namespace |
+    grep -q "Running without isolation" && {
+  TAGS="--tags=-isolation"
+  R=$(($R-$ISOLATION))
+  RN=$(($RN-$ISOLATION))
+}
 [ "$3" == "gmock" -o "$4" == "gmock" ] && {
   GR=11
   GF=7
@@ -90,7 +100,7 @@ do
     printf "./test/testprog -x -p apa=katt -p numeric=010 %-27s: " "$param"
     filename=/tmp/crpcut_sanity$$_$(($n/2+1)).xml
     reportfile=/tmp/crpcut_sanity_report$$_$(($n/2+1))
-    ./test/testprog -x -p apa=katt -p numeric=010 $param > $filename
+    ./test/testprog -x -p apa=katt -p numeric=010 $TAGS $param > $filename
     rv=$?
     xmllint --noout --schema "$DIR/crpcut.xsd" $filename 2> /dev/null || {
         echo "$filename violates crpcut.xsd XML Schema"
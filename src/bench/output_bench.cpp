@@ -0,0 +1,179 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+// Measures how fast formatted XML results reach a file descriptor, through
+// presentation_output as the presenter writes them, with the small blocks
+// of heap_buffer written one per wakeup, and with the large segments of
+// pooled_buffer written together.
+//
+// The formatters need the environment of a running test, so each
+// measurement is a test, and its result is shown with -v.
+//
+// usage: output_bench -v [-p tests=num] [-p size=bytes] [-p path=file]
+
+#include "../output/heap_buffer.hpp"
+#include "../output/pooled_buffer.hpp"
+#include "../output/xml_formatter.hpp"
+#include "../presentation_output.hpp"
+#include "../posix_error.hpp"
+#include "../poll_buffer_vector.hpp"
+#include "../printer.hpp"
+#include "../clocks/clocks.hpp"
+#include "../wrapped/posix_encapsulation.hpp"
+#include <crpcut.hpp>
+#include <sstream>
+#include <string>
+
+extern "C" {
+#  include <fcntl.h>
+}
+
+namespace {
+  using crpcut::datatypes::fixed_string;
+
+  class counting_write : public crpcut::posix_write
+  {
+  public:
+    counting_write() : calls(0), bytes(0) {}
+    unsigned long calls;
+    unsigned long bytes;
+  private:
+    virtual ssize_t do_write(int fd, const void *p, std::size_t n)
+    {
+      return count(crpcut::wrapped::write(fd, p, n));
+    }
+    virtual ssize_t do_writev(int fd, const struct iovec *v, int n)
+    {
+      return count(crpcut::wrapped::writev(fd, v, n));
+    }
+    ssize_t count(ssize_t n)
+    {
+      ++calls;
+      if (n > 0) bytes += std::size_t(n);
+      return n;
+    }
+  };
+
+  unsigned long drain(crpcut::output::buffer             &buffer,
+                      crpcut::poll<crpcut::io>           &poller,
+                      crpcut::presentation_output        &out)
+  {
+    unsigned long wakeups = 0;
+    while (!buffer.is_empty())
+      {
+        if (!out.enabled()) out.enable(true);
+        crpcut::poll<crpcut::io>::descriptor desc = poller.wait();
+        desc->write();
+        ++wakeups;
+      }
+    out.enable(false);
+    return wakeups;
+  }
+
+  template <typename T>
+  T parameter(const char *name, T default_value)
+  {
+    return crpcut::get_parameter(name)
+      ? crpcut::get_parameter<T>(name)
+      : default_value;
+  }
+
+  template <typename B>
+  void measure(const char *name)
+  {
+    const unsigned long num_tests = parameter("tests", 100000UL);
+    const std::size_t message_size = parameter("size", std::size_t(200));
+    const char *path = crpcut::get_parameter("path");
+    if (!path) path = "/dev/null";
+    int fd = crpcut::wrapped::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+      {
+        throw crpcut::posix_error(errno, "opening benchmark output");
+      }
+    const std::string message(message_size, 'x');
+    const fixed_string label = fixed_string::make("info");
+    const fixed_string msg = fixed_string::make(message.c_str(),
+                                                message.length());
+    const fixed_string location = fixed_string::make("output_bench.cpp:1");
+    const char *const argv[] = { "output_bench", 0 };
+    unsigned long wakeups = 0;
+    counting_write w;
+
+    crpcut::clocks::monotonic::timestamp before
+      = crpcut::clocks::monotonic::timestamp_absolute();
+    {
+      B buffer;
+      crpcut::output::xml_formatter fmt(buffer, "output_bench", argv,
+                                        crpcut::tag_list::obj(),
+                                        num_tests, num_tests);
+      void *poll_memory
+        = alloca(crpcut::poll_buffer_vector<crpcut::io>::space_for(1));
+      crpcut::poll_buffer_vector<crpcut::io> poller(poll_memory, 1);
+      crpcut::presentation_output out(buffer, poller, fd, w);
+      for (unsigned long n = 0; n < num_tests; ++n)
+        {
+          std::ostringstream os;
+          os << "bench::test_" << n;
+          {
+            crpcut::printer p(fmt, os.str(), true, true, 1000);
+            fmt.print(label, msg, location);
+          }
+          // the presenter writes whenever the fd is writable, which is
+          // in between the results arriving
+          if (n % 64 == 63) wakeups += drain(buffer, poller, out);
+        }
+      fmt.statistics(unsigned(num_tests), 0);
+      wakeups += drain(buffer, poller, out);
+    }
+    crpcut::clocks::monotonic::timestamp after
+      = crpcut::clocks::monotonic::timestamp_absolute();
+    crpcut::wrapped::close(fd);
+
+    unsigned long us = after - before;
+    if (us == 0) us = 1;
+    INFO << name << ": " << w.bytes << " bytes in " << us << "us, "
+              << (double(w.bytes) / double(us)) << " MB/s, "
+              << w.calls << " writes, " << wakeups << " wakeups";
+  }
+}
+
+TESTSUITE(output_bench)
+{
+  TEST(heap_buffer, DEADLINE_REALTIME_MS(600000))
+  {
+    measure<crpcut::output::heap_buffer>("heap_buffer");
+  }
+
+  TEST(pooled_buffer, DEPENDS_ON(heap_buffer), DEADLINE_REALTIME_MS(600000))
+  {
+    measure<crpcut::output::pooled_buffer>("pooled_buffer");
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  return crpcut::run(argc, argv);
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+// Measures how many messages per second the runner can pass to the
+// presentation process, with one write per field as the protocol was
+// originally written, and with the framed protocol of presentation_pipe.
+//
+// usage: presentation_pipe_bench [num_messages [payload_size]]
+
+#include "../presentation_pipe.hpp"
+#include "../pipe_pair.hpp"
+#include "../posix_error.hpp"
+#include "../clocks/clocks.hpp"
+#include "../wrapped/posix_encapsulation.hpp"
+#include <crpcut.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+#  include <sys/wait.h>
+}
+
+namespace {
+  using crpcut::comm::type;
+  using crpcut::test_phase;
+
+  void write_per_field(int fd, unsigned long num, const std::vector<char> &p)
+  {
+    crpcut::comm::wfile_descriptor out(fd);
+    const pid_t      pid   = 1;
+    const type       t     = crpcut::comm::info;
+    const test_phase phase = crpcut::running;
+    const size_t     len   = p.size();
+    for (unsigned long n = 0; n < num; ++n)
+      {
+        out
+          .write_loop(&pid)
+          .write_loop(&t)
+          .write_loop(&phase)
+          .write_loop(&len)
+          .write_loop(&p[0], len);
+      }
+  }
+
+  void write_framed(int fd, unsigned long num, const std::vector<char> &p)
+  {
+    crpcut::presentation_pipe out(fd);
+    for (unsigned long n = 0; n < num; ++n)
+      {
+        out.write_frame(1, crpcut::comm::info, crpcut::running,
+                        p.size(), &p[0]);
+      }
+    out.flush();
+  }
+
+  unsigned long read_per_field(int fd, std::vector<char> &p)
+  {
+    crpcut::comm::rfile_descriptor in(fd);
+    unsigned long num = 0;
+    try {
+      for (;;)
+        {
+          pid_t      pid;
+          type       t;
+          test_phase phase;
+          size_t     len;
+          in.read_loop(&pid, sizeof(pid));
+          in.read_loop(&t, sizeof(t));
+          in.read_loop(&phase, sizeof(phase));
+          in.read_loop(&len, sizeof(len));
+          in.read_loop(&p[0], len);
+          ++num;
+        }
+    }
+    catch (crpcut::posix_error &)
+    {
+    }
+    return num;
+  }
+
+  unsigned long read_framed(int fd, std::vector<char> &)
+  {
+    crpcut::comm::rfile_descriptor in(fd);
+    const size_t header_size = crpcut::presentation_pipe::header_size;
+    std::vector<char> buffer(65536);
+    size_t begin = 0;
+    size_t end = 0;
+    unsigned long num = 0;
+    for (;;)
+      {
+        ssize_t rv = in.read(&buffer[end], buffer.size() - end);
+        if (rv <= 0) return num;
+        end += size_t(rv);
+        if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+        for (;;)
+          {
+            if (end - begin < header_size) break;
+            pid_t      pid;
+            type       t;
+            test_phase phase;
+            size_t len = crpcut::presentation_pipe::decode_header(&buffer[begin],
+                                                                  pid,
+                                                                  t,
+                                                                  phase);
+            if (end - begin - header_size < len) break;
+            begin += header_size + len;
+            ++num;
+          }
+        if (begin)
+          {
+            std::copy(buffer.begin() + long(begin),
+                      buffer.begin() + long(end),
+                      buffer.begin());
+            end -= begin;
+            begin = 0;
+          }
+      }
+  }
+
+  void measure(const char    *name,
+               void         (*writer)(int, unsigned long,
+                                      const std::vector<char>&),
+               unsigned long (*reader)(int, std::vector<char>&),
+               unsigned long  num,
+               size_t         payload_size)
+  {
+    std::vector<char> payload(std::max(payload_size, size_t(1)), 'x');
+    crpcut::pipe_pair p("benchmark pipe");
+    crpcut::clocks::monotonic::timestamp before
+      = crpcut::clocks::monotonic::timestamp_absolute();
+    pid_t pid = crpcut::wrapped::fork();
+    if (pid < 0)
+      {
+        throw crpcut::posix_error(errno, "forking benchmark writer");
+      }
+    if (pid == 0)
+      {
+        writer(p.for_writing(crpcut::pipe_pair::release_ownership),
+               num,
+               payload);
+        crpcut::wrapped::_Exit(0);
+      }
+    unsigned long received
+      = reader(p.for_reading(crpcut::pipe_pair::release_ownership), payload);
+    crpcut::clocks::monotonic::timestamp after
+      = crpcut::clocks::monotonic::timestamp_absolute();
+    siginfo_t info;
+    crpcut::wrapped::waitid(P_PID, id_t(pid), &info, WEXITED);
+    unsigned long us = after - before;
+    if (us == 0) us = 1;
+    std::cout << name << ": " << received << " messages in "
+              << us << "us, "
+              << (double(received) * 1000000.0 / double(us)) << " msgs/s\n";
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned long num = argc > 1 ? std::strtoul(argv[1], 0, 10) : 1000000UL;
+  size_t payload_size = argc > 2 ? std::strtoul(argv[2], 0, 10) : 40UL;
+  measure("per field", write_per_field, read_per_field, num, payload_size);
+  measure("framed   ", write_framed, read_framed, num, payload_size);
+}
@@ -0,0 +1,428 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include "cgroup.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+extern "C" {
+#  include <dirent.h>
+#  include <fcntl.h>
+#  include <sys/select.h>
+}
+#include <sstream>
+
+namespace {
+  bool read_file(const std::string &name, std::string &contents)
+  {
+    int fd = crpcut::wrapped::open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    contents.clear();
+    char buff[4096];
+    ssize_t rv;
+    for (;;)
+      {
+        rv = crpcut::wrapped::read(fd, buff, sizeof(buff));
+        if (rv == -1 && errno == EINTR) continue;
+        if (rv <= 0) break;
+        contents.append(buff, std::size_t(rv));
+      }
+    crpcut::wrapped::close(fd);
+    return rv == 0;
+  }
+
+  bool write_file(const char *name, const char *data, std::size_t len)
+  {
+    int fd = crpcut::wrapped::open(name, O_WRONLY, 0);
+    if (fd < 0) return false;
+    ssize_t rv = crpcut::wrapped::write(fd, data, len);
+    crpcut::wrapped::close(fd);
+    return rv == ssize_t(len);
+  }
+
+  bool write_file(const std::string &name, const std::string &data)
+  {
+    return write_file(name.c_str(), data.data(), data.length());
+  }
+
+  // cgroup.kill makes the processes die, but the cgroup stays populated
+  // for a brief moment until they are all gone.
+  void remove_dir(const std::string &name, unsigned attempts)
+  {
+    while (crpcut::wrapped::rmdir(name.c_str()) != 0
+           && errno == EBUSY
+           && --attempts)
+      {
+        struct timeval tv = { 0, 1000 };
+        crpcut::wrapped::select(0, 0, 0, 0, &tv);
+      }
+  }
+
+  // The mount point of the cgroup v2 hierarchy, which is /sys/fs/cgroup
+  // on a pure v2 system, and often /sys/fs/cgroup/unified on a hybrid.
+  bool find_mount_point(std::string &mount_point)
+  {
+    std::string mountinfo;
+    if (!read_file("/proc/self/mountinfo", mountinfo)) return false;
+    std::istringstream is(mountinfo);
+    std::string line;
+    while (std::getline(is, line))
+      {
+        if (line.find(" - cgroup2 ") == std::string::npos) continue;
+        std::istringstream fields(line);
+        std::string field;
+        for (int i = 0; i < 5 && fields >> field; ++i)
+          ;
+        mount_point = field;
+        return !fields.fail();
+      }
+    return false;
+  }
+
+  bool find_own_cgroup(std::string &path)
+  {
+    std::string cgroups;
+    if (!read_file("/proc/self/cgroup", cgroups)) return false;
+    std::istringstream is(cgroups);
+    std::string line;
+    while (std::getline(is, line))
+      {
+        if (line.compare(0, 3, "0::") != 0) continue;
+        path = line.substr(3);
+        if (path == "/") path.clear();
+        return true;
+      }
+    return false;
+  }
+
+  // Sums the numbers that follow key on the lines starting with prefix.
+  // key must start a line or follow a space.
+  unsigned long long sum_values(const std::string &contents,
+                                const char        *prefix,
+                                const char        *key)
+  {
+    const std::size_t prefix_len = crpcut::wrapped::strlen(prefix);
+    const std::size_t key_len = crpcut::wrapped::strlen(key);
+    unsigned long long sum = 0;
+    std::istringstream is(contents);
+    std::string line;
+    while (std::getline(is, line))
+      {
+        if (line.compare(0, prefix_len, prefix) != 0) continue;
+        std::size_t pos = line.find(key);
+        while (pos != std::string::npos && pos != 0 && line[pos - 1] != ' ')
+          {
+            pos = line.find(key, pos + 1);
+          }
+        if (pos == std::string::npos) continue;
+        std::istringstream value(line.substr(pos + key_len));
+        unsigned long long n;
+        if (value >> n) sum += n;
+      }
+    return sum;
+  }
+
+  bool has_word(const std::string &words, const std::string &word)
+  {
+    std::istringstream is(words);
+    std::string w;
+    while (is >> w)
+      {
+        if (w == word) return true;
+      }
+    return false;
+  }
+
+  // The processes in cgroup path, if they are all of the process group
+  // of this program, i.e. the runner, the presenter and the process that
+  // started them.
+  bool own_processes(const std::string &path, std::vector<std::string> &pids)
+  {
+    std::string procs;
+    if (!read_file(path + "/cgroup.procs", procs)) return false;
+    const pid_t pgrp = crpcut::wrapped::getpgid(0);
+    std::istringstream is(procs);
+    pid_t pid;
+    while (is >> pid)
+      {
+        if (crpcut::wrapped::getpgid(pid) != pgrp) return false;
+        std::ostringstream os;
+        os << pid;
+        pids.push_back(os.str());
+      }
+    return !pids.empty();
+  }
+
+  struct statistic
+  {
+    const char *file;
+    const char *prefix;
+    const char *key;
+    const char *name;
+  };
+
+  // Entries reading the same file must be adjacent. Files of controllers
+  // that are not enabled do not exist, and their measurements are left
+  // out of the report.
+  const statistic statistics[] =
+    {
+      { "cpu.stat",        "",      "usage_usec ",  "cgroup.cpu_us"           },
+      { "cpu.stat",        "",      "user_usec ",   "cgroup.user_us"          },
+      { "cpu.stat",        "",      "system_usec ", "cgroup.system_us"        },
+      { "memory.peak",     "",      "",             "cgroup.memory_peak_bytes"},
+      { "io.stat",         "",      "rbytes=",      "cgroup.io_read_bytes"    },
+      { "io.stat",         "",      "wbytes=",      "cgroup.io_write_bytes"   },
+      { "cpu.pressure",    "some ", "total=",       "cgroup.cpu_stall_us"     },
+      { "memory.pressure", "some ", "total=",       "cgroup.memory_stall_us"  },
+      { "io.pressure",     "some ", "total=",       "cgroup.io_stall_us"      }
+    };
+}
+
+namespace crpcut {
+
+  cgroup
+  ::cgroup(const std::string &path)
+    : path_(path),
+      procs_(path + "/cgroup.procs")
+  {
+  }
+
+  cgroup
+  ::~cgroup()
+  {
+    kill();
+    remove_dir(path_, 100);
+  }
+
+  bool
+  cgroup
+  ::limit_memory(unsigned long bytes) const
+  {
+    if (!bytes) return true;
+    std::ostringstream os;
+    os << bytes;
+    return write_file(path_ + "/memory.max", os.str());
+  }
+
+  bool
+  cgroup
+  ::limit_cpu(unsigned long quota_us, unsigned long period_us) const
+  {
+    if (!quota_us) return true;
+    std::ostringstream os;
+    os << quota_us << ' ' << period_us;
+    return write_file(path_ + "/cpu.max", os.str());
+  }
+
+  void
+  cgroup
+  ::enter() const
+  {
+    write_file(procs_.c_str(), "0", 1);
+  }
+
+  bool
+  cgroup
+  ::kill() const
+  {
+    return write_file(path_ + "/cgroup.kill", "1");
+  }
+
+  void
+  cgroup
+  ::read_usage(usage &u) const
+  {
+    const char *current = 0;
+    bool available = false;
+    std::string contents;
+    for (std::size_t i = 0; i < sizeof(statistics)/sizeof(statistics[0]); ++i)
+      {
+        const statistic &s = statistics[i];
+        if (!current || wrapped::strcmp(current, s.file) != 0)
+          {
+            current = s.file;
+            available = read_file(path_ + "/" + s.file, contents);
+          }
+        if (!available) continue;
+        u.push_back(measurement(s.name, sum_values(contents, s.prefix, s.key)));
+      }
+  }
+
+  cgroup_tree
+  ::cgroup_tree()
+    : path_(),
+      own_(),
+      runner_(),
+      enabled_(),
+      num_leaves_(0)
+  {
+    std::string mount_point;
+    std::string own;
+    if (!find_mount_point(mount_point) || !find_own_cgroup(own)) return;
+
+    // Moving the test processes requires write access to cgroup.procs
+    // of the cgroup the runner is in. Moving the runner to where it
+    // already is tells if that is so, without side effects.
+    std::ostringstream pid;
+    pid << wrapped::getpid();
+    if (!write_file(mount_point + own + "/cgroup.procs", pid.str())) return;
+
+    std::string path = mount_point + own + "/crpcut." + pid.str();
+    if (wrapped::mkdir(path.c_str(), 0755) != 0) return;
+    path_ = path;
+    make_room_for_controllers(mount_point + own);
+
+    std::string controllers;
+    if (!read_file(path_ + "/cgroup.controllers", controllers)) return;
+    std::istringstream is(controllers);
+    std::string controller;
+    while (is >> controller)
+      {
+        if (controller == "cpu" || controller == "memory" || controller == "io")
+          {
+            write_file(path_ + "/cgroup.subtree_control", "+" + controller);
+          }
+      }
+  }
+
+  void
+  cgroup_tree
+  ::make_room_for_controllers(const std::string &own)
+  {
+    std::string available;
+    std::string enabled;
+    if (!read_file(own + "/cgroup.controllers", available)
+        || !read_file(own + "/cgroup.subtree_control", enabled))
+      {
+        return;
+      }
+    std::vector<std::string> wanted;
+    std::istringstream is(available);
+    std::string controller;
+    while (is >> controller)
+      {
+        if (controller != "cpu" && controller != "memory" && controller != "io")
+          {
+            continue;
+          }
+        if (!has_word(enabled, controller)) wanted.push_back(controller);
+      }
+    if (wanted.empty()) return;
+    std::vector<std::string> procs;
+    if (!own_processes(own, procs)) return;
+    const std::string runner = path_ + ".runner";
+    if (wrapped::mkdir(runner.c_str(), 0755) != 0) return;
+    own_ = own;
+    runner_ = runner;
+    for (std::size_t i = 0; i < procs.size(); ++i)
+      {
+        write_file(runner_ + "/cgroup.procs", procs[i]);
+      }
+    for (std::size_t i = 0; i < wanted.size(); ++i)
+      {
+        if (write_file(own_ + "/cgroup.subtree_control", "+" + wanted[i]))
+          {
+            enabled_.push_back(wanted[i]);
+          }
+      }
+  }
+
+  cgroup_tree
+  ::~cgroup_tree()
+  {
+    if (path_.empty()) return;
+    // leaves are normally removed when their test is done, but one that
+    // was still busy then remains
+    std::vector<std::string> leaves;
+    if (DIR *d = wrapped::opendir(path_.c_str()))
+      {
+        char buff[sizeof(dirent) + PATH_MAX];
+        dirent *ent = reinterpret_cast<dirent*>(buff),*result = ent;
+        while (result && (wrapped::readdir_r(d, ent, &result) == 0) && result)
+          {
+            if (ent->d_type != DT_DIR) continue;
+            if (wrapped::strcmp(ent->d_name, ".") == 0 ||
+                wrapped::strcmp(ent->d_name, "..") == 0)
+              continue;
+            leaves.push_back(path_ + "/" + ent->d_name);
+          }
+        wrapped::closedir(d);
+      }
+    for (std::vector<std::string>::iterator i = leaves.begin();
+         i != leaves.end();
+         ++i)
+      {
+        cgroup leaf(*i);
+      }
+    remove_dir(path_, 100);
+    if (runner_.empty()) return;
+    // the processes can only go back once the controllers are disabled
+    for (std::size_t i = 0; i < enabled_.size(); ++i)
+      {
+        write_file(own_ + "/cgroup.subtree_control", "-" + enabled_[i]);
+      }
+    std::string procs;
+    if (read_file(runner_ + "/cgroup.procs", procs))
+      {
+        std::istringstream is(procs);
+        std::string pid;
+        while (is >> pid)
+          {
+            write_file(own_ + "/cgroup.procs", pid);
+          }
+      }
+    remove_dir(runner_, 100);
+  }
+
+  cgroup *
+  cgroup_tree
+  ::create_leaf()
+  {
+    if (path_.empty()) return 0;
+    std::ostringstream os;
+    os << path_ << '/' << num_leaves_++;
+    if (wrapped::mkdir(os.str().c_str(), 0755) != 0) return 0;
+    return new cgroup(os.str());
+  }
+
+  void report_unapplied_limits(bool memory, bool cpu,
+                               datatypes::fixed_string location)
+  {
+    if (memory)
+      {
+        comm::report(comm::info,
+                     "CGROUP_MEMORY_MAX is not applied, the cgroup v2 memory "
+                     "controller is not available to the test runner",
+                     location);
+      }
+    if (cpu)
+      {
+        comm::report(comm::info,
+                     "CGROUP_CPU_MAX is not applied, the cgroup v2 cpu "
+                     "controller is not available to the test runner",
+                     location);
+      }
+  }
+}
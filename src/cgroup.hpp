@@ -0,0 +1,101 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef CGROUP_HPP
+#define CGROUP_HPP
+
+#include <crpcut.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace crpcut {
+  // The cgroup v2 leaf that one test process, and everything it spawns,
+  // runs in. It gives exact resource accounting for the whole process
+  // tree, and a way to kill all of it, whatever process group or session
+  // the processes have put themselves in.
+  class cgroup
+  {
+  public:
+    typedef std::pair<const char*, unsigned long long> measurement;
+    typedef std::vector<measurement> usage;
+
+    explicit cgroup(const std::string &path);
+    ~cgroup(); // kills whatever remains and removes the leaf
+
+    // Limits need the controller enabled. Returns false if a limit is
+    // asked for, but could not be applied. A zero value means no limit.
+    bool limit_memory(unsigned long bytes) const;
+    bool limit_cpu(unsigned long quota_us, unsigned long period_us) const;
+
+    // Called by the test process itself directly after fork, before
+    // it can spawn anything. Does not allocate.
+    void enter() const;
+
+    // Returns false if the kernel does not support cgroup.kill.
+    bool kill() const;
+
+    // Appends the measurements available for the cgroup to u.
+    void read_usage(usage &u) const;
+  private:
+    const std::string path_;
+    const std::string procs_;
+    cgroup(const cgroup&);
+    cgroup& operator=(const cgroup&);
+  };
+
+  // A cgroup created by the test runner, below the one it runs in, to
+  // hold the leaves of the tests. A cgroup can only give controllers to
+  // its children if it has no processes of its own, so if the cgroup the
+  // runner is in holds only processes of this program, e.g. in a scope
+  // started for it with Delegate=yes, they are moved to a leaf of their
+  // own while the tests run.
+  class cgroup_tree
+  {
+  public:
+    cgroup_tree();
+    ~cgroup_tree();
+    // Returns 0 if cgroup v2 is unavailable or not writable.
+    cgroup *create_leaf();
+  private:
+    void make_room_for_controllers(const std::string &own);
+
+    std::string              path_;
+    std::string              own_;     // where the runner was started
+    std::string              runner_;  // leaf it was moved to, if any
+    std::vector<std::string> enabled_; // controllers enabled in own_
+    unsigned long            num_leaves_;
+    cgroup_tree(const cgroup_tree&);
+    cgroup_tree& operator=(const cgroup_tree&);
+  };
+
+  // Tells, with an INFO for each, which limits a test asks for could not
+  // be applied. Called by the test process, which then runs without them.
+  void report_unapplied_limits(bool memory, bool cpu,
+                               datatypes::fixed_string location);
+}
+
+#endif // CGROUP_HPP
@@ -52,10 +52,18 @@ namespace crpcut {
                    "better error pinpointing of heap violations (slow)",
                    list_),
 #endif
+        capture_(0, "capture-output",
+                 "Collect stdout and stderr from each test in a file, and\n"
+                 "present it when the test finishes, instead of live",
+                 list_),
         num_children_('c', "children", "number",
                       "Control number of concurrently running test processes\n"
                       "number must be at least 1",
                       list_),
+        checkpoint_(0, "checkpoint", "interval",
+                    "Keep a journal of completed tests next to the -o report,\n"
+                    "synced to disk every interval completed tests",
+                    list_),
         charset_('C', "output-charset", "charset",
                  "Specify the output character set to convert text output\n"
                  "to. Does not apply for XML output",
@@ -63,6 +71,24 @@ namespace crpcut {
         working_dir_('d', "working-dir", "dirname",
                      "Specify working directory (must exist)",
                      list_),
+        events_(0, "events", "fd|path",
+                "Write an event per line, in JSON, as each test is\n"
+                "scheduled, started, changes phase, produces output and\n"
+                "finishes, to an open file descriptor or to a file",
+                list_),
+        failure_limit_(0, "failure-limit", "number",
+                       "Report at most number distinct failures from each\n"
+                       "test, and summarise the rest",
+                       list_),
+        hang_kill_(0, "hang-kill",
+                   "Kill a test that --hang-watch suspects is deadlocked,\n"
+                   "and fail it, instead of only reporting it",
+                   list_),
+        hang_watch_(0, "hang-watch", "milliseconds",
+                    "Report a test as a suspected deadlock when it has used\n"
+                    "no CPU time for milliseconds, with all its threads\n"
+                    "blocked, and show what each thread waits for",
+                    list_),
         id_string_('i', "identity", "\"id string\"",
                    "Specify an identity string for the XML-header",
                    list_),
@@ -70,6 +96,10 @@ namespace crpcut {
                      "Specify how characters that are illegal for the chosen\n"
                      "output character set are to be represented",
                      list_),
+        inline_(0, "inline-presenter",
+                "Present results from the process that runs the tests,\n"
+                "instead of from a process of its own",
+                list_),
         list_tests_('l', "list", "List test cases",
                     list_),
         list_tags_('L', "list-tags",
@@ -81,11 +111,44 @@ namespace crpcut {
                 "Direct XML output to a named file. A brief summary will be\n"
                 "displayed on stdout",
                 list_),
+        output_limit_(0, "output-limit", "bytes",
+                      "Present at most bytes each of stdout, stderr and INFO\n"
+                      "output from a test, keeping the beginning and the end.\n"
+                      "All of it is written to a file in the working directory",
+                      list_),
         param_('p', "param",
                "Defined a named variable for access from the test cases",
                list_),
+        perf_counters_(0, "perf-counters",
+                       "Count instructions, cycles, branch misses and cache\n"
+                       "misses of each test, and include them in the report",
+                       list_),
+#ifdef USE_BACKTRACE
+        profile_(0, "profile", "dirname",
+                 "Sample the stack of each test on CPU time, and write the\n"
+                 "samples as folded stacks, for flame graphs, to a file\n"
+                 "per test in dirname",
+                 list_),
+        profile_failed_(0, "profile-failed",
+                        "Only keep the --profile samples of failed tests",
+                        list_),
+#endif
         quiet_('q', "quiet", "Don't display the -o brief summary",
                list_),
+        resume_(0, "resume", "journal",
+                "Skip the tests already completed according to a journal\n"
+                "from an interrupted run, and include their results in\n"
+                "the report",
+                list_),
+        runner_stats_(0, "runner-stats",
+                      "Measure the cost of running each test, in start\n"
+                      "latency, messages and post mortem time, and the lag of\n"
+                      "the presentation, and include them in the report",
+                      list_),
+        serve_(0, "serve", "socket",
+               "Stay resident, and serve run requests on a Unix domain\n"
+               "socket. A request is a line with command line arguments",
+               list_),
         single_shot_('s', "single-shot",
                      "Run only one test case, and run it in the main process\n"
                      "for ease of debugging",
@@ -93,6 +156,12 @@ namespace crpcut {
         timeout_multiplier_(0, "timeout-multiplier", "factor",
                   "Multiply all timeout times with a factor",
                   list_),
+#ifdef USE_BACKTRACE
+        timeout_stacks_(0, "timeout-stacks",
+                        "Write the stack of each thread of a test to the\n"
+                        "report before killing it for timing out",
+                        list_),
+#endif
         disable_timeouts_('t', "disable-timeouts",
                           "Never fail a test due to time consumption",
                           list_),
@@ -104,12 +173,23 @@ namespace crpcut {
               "the list is subtractive from the full set.\n"
               "Untagged tests cannot be made non-critical",
               list_),
+        trace_(0, "trace", "filename",
+               "Write a timeline of the run, with the phases of each test,\n"
+               "to a file in trace event format, for chrome://tracing and\n"
+               "Perfetto",
+               list_),
         verbose_('v', "verbose",
                  "Verbose mode - include results from passed tests",
                  list_),
         version_('V', "version",
                  "Print version string and exit",
                  list_),
+#ifdef HAVE_INOTIFY
+        watch_(0, "watch",
+               "Stay resident, and run the tests again whenever the\n"
+               "test program is rebuilt",
+               list_),
+#endif
         xml_('x', "xml",
              "XML output on stdout or non-XML output on file",
              list_),
@@ -162,6 +242,22 @@ namespace crpcut {
       throw_if_illegal_combination(single_shot_, quiet_);
       throw_if_illegal_combination(single_shot_, verbose_);
       throw_if_illegal_combination(single_shot_, xml_);
+      throw_if_illegal_combination(single_shot_, serve_);
+      throw_if_illegal_combination(single_shot_, checkpoint_);
+      throw_if_illegal_combination(single_shot_, resume_);
+      throw_if_illegal_combination(single_shot_, capture_);
+      throw_if_illegal_combination(single_shot_, inline_);
+      throw_if_illegal_combination(single_shot_, output_limit_);
+      throw_if_illegal_combination(single_shot_, failure_limit_);
+      throw_if_illegal_combination(single_shot_, perf_counters_);
+      throw_if_illegal_combination(single_shot_, trace_);
+      throw_if_illegal_combination(single_shot_, runner_stats_);
+      throw_if_illegal_combination(single_shot_, hang_watch_);
+      throw_if_illegal_combination(single_shot_, events_);
+#ifdef USE_BACKTRACE
+      throw_if_illegal_combination(single_shot_, profile_);
+      throw_if_illegal_combination(single_shot_, timeout_stacks_);
+#endif
 
       throw_if_illegal_combination(id_string_, list_tests_);
       throw_if_illegal_combination(id_string_, list_tags_);
@@ -197,6 +293,42 @@ namespace crpcut {
       throw_if_illegal_combination(list_tags_, tags_);
       throw_if_illegal_combination(list_tags_, verbose_);
       throw_if_illegal_combination(list_tags_, xml_);
+      throw_if_illegal_combination(list_tests_, checkpoint_);
+      throw_if_illegal_combination(list_tests_, resume_);
+      throw_if_illegal_combination(list_tags_, checkpoint_);
+      throw_if_illegal_combination(list_tags_, resume_);
+      throw_if_illegal_combination(list_tests_, capture_);
+      throw_if_illegal_combination(list_tags_, capture_);
+      throw_if_illegal_combination(list_tests_, inline_);
+      throw_if_illegal_combination(list_tags_, inline_);
+      throw_if_illegal_combination(list_tests_, output_limit_);
+      throw_if_illegal_combination(list_tags_, output_limit_);
+      throw_if_illegal_combination(list_tests_, failure_limit_);
+      throw_if_illegal_combination(list_tags_, failure_limit_);
+      throw_if_illegal_combination(list_tests_, perf_counters_);
+      throw_if_illegal_combination(list_tags_, perf_counters_);
+      throw_if_illegal_combination(list_tests_, trace_);
+      throw_if_illegal_combination(list_tags_, trace_);
+      throw_if_illegal_combination(list_tests_, runner_stats_);
+      throw_if_illegal_combination(list_tags_, runner_stats_);
+      throw_if_illegal_combination(list_tests_, hang_watch_);
+      throw_if_illegal_combination(list_tags_, hang_watch_);
+      throw_if_illegal_combination(list_tests_, events_);
+      throw_if_illegal_combination(list_tags_, events_);
+#ifdef USE_BACKTRACE
+      throw_if_illegal_combination(list_tests_, profile_);
+      throw_if_illegal_combination(list_tags_, profile_);
+      throw_if_illegal_combination(list_tests_, timeout_stacks_);
+      throw_if_illegal_combination(list_tags_, timeout_stacks_);
+#endif
+      throw_if_illegal_combination(serve_, list_tests_);
+      throw_if_illegal_combination(serve_, list_tags_);
+#ifdef HAVE_INOTIFY
+      throw_if_illegal_combination(watch_, single_shot_);
+      throw_if_illegal_combination(watch_, list_tests_);
+      throw_if_illegal_combination(watch_, list_tags_);
+      throw_if_illegal_combination(watch_, serve_);
+#endif
       throw_if_illegal_combination(timeout_multiplier_ ,disable_timeouts_);
       throw_if_illegal_combination(timeout_multiplier_, single_shot_);
 
@@ -214,6 +346,60 @@ namespace crpcut {
           throw param::exception(os.str());
         }
 
+      if (checkpoint_ && checkpoint_.get_value() == 0)
+        {
+          std::ostringstream os;
+          checkpoint_.syntax(os) << " - interval must be at least 1";
+          throw param::exception(os.str());
+        }
+
+      if (output_limit_ && output_limit_.get_value() == 0)
+        {
+          std::ostringstream os;
+          output_limit_.syntax(os) << " - bytes must be at least 1";
+          throw param::exception(os.str());
+        }
+
+      if (failure_limit_ && failure_limit_.get_value() == 0)
+        {
+          std::ostringstream os;
+          failure_limit_.syntax(os) << " - number must be at least 1";
+          throw param::exception(os.str());
+        }
+
+      if (hang_watch_ && hang_watch_.get_value() == 0)
+        {
+          std::ostringstream os;
+          hang_watch_.syntax(os) << " - milliseconds must be at least 1";
+          throw param::exception(os.str());
+        }
+
+      if (hang_kill_ && !hang_watch_)
+        {
+          std::ostringstream os;
+          hang_kill_.syntax(os) << " requires ";
+          hang_watch_.syntax(os);
+          throw param::exception(os.str());
+        }
+
+      if (checkpoint_ && !output_)
+        {
+          std::ostringstream os;
+          checkpoint_.syntax(os) << " requires ";
+          output_.syntax(os);
+          throw param::exception(os.str());
+        }
+
+#ifdef USE_BACKTRACE
+      if (profile_failed_ && !profile_)
+        {
+          std::ostringstream os;
+          profile_failed_.syntax(os) << " requires ";
+          profile_.syntax(os);
+          throw param::exception(os.str());
+        }
+#endif
+
       if (timeout_multiplier_ && timeout_multiplier_.get_value() == 0)
         {
           std::ostringstream os;
@@ -239,6 +425,20 @@ namespace crpcut {
     }
 #endif
 
+    bool
+    interpreter
+    ::capture_output() const
+    {
+      return capture_;
+    }
+
+    unsigned
+    interpreter
+    ::checkpoint_interval() const
+    {
+      return checkpoint_ ? checkpoint_.get_value() : 0U;
+    }
+
     unsigned
     interpreter::num_parallel_tests() const
     {
@@ -259,6 +459,13 @@ namespace crpcut {
       return working_dir_ ? working_dir_.get_value() : 0;
     }
 
+    const char *
+    interpreter
+    ::events_target() const
+    {
+      return events_ ? events_.get_value() : 0;
+    }
+
     const char *
     interpreter
     ::identity_string() const
@@ -273,6 +480,13 @@ namespace crpcut {
       return illegal_rep_ ? illegal_rep_.get_value() : 0;
     }
 
+    bool
+    interpreter
+    ::inline_presenter() const
+    {
+      return inline_;
+    }
+
     bool
     interpreter
     ::list_tests() const
@@ -294,6 +508,27 @@ namespace crpcut {
       return !nodeps_;
     }
 
+    unsigned
+    interpreter
+    ::failure_limit() const
+    {
+      return failure_limit_ ? failure_limit_.get_value() : 0U;
+    }
+
+    bool
+    interpreter
+    ::hang_kill() const
+    {
+      return hang_kill_;
+    }
+
+    unsigned
+    interpreter
+    ::hang_watch_ms() const
+    {
+      return hang_watch_ ? hang_watch_.get_value() : 0U;
+    }
+
     const char *
     interpreter
     ::report_file() const
@@ -301,6 +536,13 @@ namespace crpcut {
       return output_ ? output_.get_value() : 0;
     }
 
+    unsigned
+    interpreter
+    ::output_limit() const
+    {
+      return output_limit_ ? output_limit_.get_value() : 0U;
+    }
+
     const char *
     interpreter
     ::named_parameter(const char *name)
@@ -308,6 +550,29 @@ namespace crpcut {
       return param_.value_for(argv_, name);
     }
 
+    bool
+    interpreter
+    ::perf_counters() const
+    {
+      return perf_counters_;
+    }
+
+#ifdef USE_BACKTRACE
+    const char *
+    interpreter
+    ::profile_dir() const
+    {
+      return profile_ ? profile_.get_value() : 0;
+    }
+
+    bool
+    interpreter
+    ::profile_failed_only() const
+    {
+      return profile_failed_;
+    }
+#endif
+
     bool
     interpreter
     ::quiet() const
@@ -315,6 +580,27 @@ namespace crpcut {
       return quiet_;
     }
 
+    const char *
+    interpreter
+    ::resume_journal() const
+    {
+      return resume_ ? resume_.get_value() : 0;
+    }
+
+    bool
+    interpreter
+    ::runner_stats() const
+    {
+      return runner_stats_;
+    }
+
+    const char *
+    interpreter
+    ::serve_path() const
+    {
+      return serve_ ? serve_.get_value() : 0;
+    }
+
     bool
     interpreter
     ::single_shot_mode() const
@@ -329,6 +615,15 @@ namespace crpcut {
       return timeout_multiplier_ ? timeout_multiplier_.get_value() : 1U;
     }
 
+#ifdef USE_BACKTRACE
+    bool
+    interpreter
+    ::timeout_stacks() const
+    {
+      return timeout_stacks_;
+    }
+#endif
+
     bool
     interpreter
     ::honour_timeouts() const
@@ -343,6 +638,13 @@ namespace crpcut {
       return tags_ ? tags_.get_value() : 0;
     }
 
+    const char *
+    interpreter
+    ::trace_file() const
+    {
+      return trace_ ? trace_.get_value() : 0;
+    }
+
     bool
     interpreter
     ::verbose_mode() const
@@ -350,6 +652,15 @@ namespace crpcut {
       return verbose_;
     }
 
+#ifdef HAVE_INOTIFY
+    bool
+    interpreter
+    ::watch_mode() const
+    {
+      return watch_;
+    }
+
+#endif
     bool
     interpreter
     ::xml_output() const
@@ -44,22 +44,45 @@ namespace crpcut {
 #ifdef USE_BACKTRACE
       bool               backtrace_enabled() const;
 #endif
+      bool               capture_output() const;
+      unsigned           checkpoint_interval() const;
       unsigned           num_parallel_tests() const;
       const char *       output_charset() const;
       const char *       working_dir() const;
+      const char *       events_target() const;
+      unsigned           failure_limit() const;
+      bool               hang_kill() const;
+      unsigned           hang_watch_ms() const;
       const char *       identity_string() const;
       const char *       illegal_representation() const;
+      bool               inline_presenter() const;
       bool               list_tests() const;
       bool               list_tags() const;
       bool               honour_dependencies() const;
       const char *       report_file() const;
+      unsigned           output_limit() const;
       const char *       named_parameter(const char *name);
+      bool               perf_counters() const;
+#ifdef USE_BACKTRACE
+      const char *       profile_dir() const;
+      bool               profile_failed_only() const;
+#endif
       bool               quiet() const;
+      const char *       resume_journal() const;
+      bool               runner_stats() const;
+      const char *       serve_path() const;
       bool               single_shot_mode() const;
       unsigned           timeout_multiplier() const;
+#ifdef USE_BACKTRACE
+      bool               timeout_stacks() const;
+#endif
       bool               honour_timeouts() const;
       const char *       tag_specification() const;
+      const char *       trace_file() const;
       bool               verbose_mode() const;
+#ifdef HAVE_INOTIFY
+      bool               watch_mode() const;
+#endif
       bool               xml_output() const;
       const char *const *argv() const;
       const char *       program_name() const;
@@ -71,23 +94,46 @@ namespace crpcut {
 # ifdef USE_BACKTRACE
       activation_param         backtrace_;
 # endif
+      activation_param         capture_;
       value_param<unsigned>    num_children_;
+      value_param<unsigned>    checkpoint_;
       value_param<const char*> charset_;
       value_param<const char*> working_dir_;
+      value_param<const char*> events_;
+      value_param<unsigned>    failure_limit_;
+      activation_param         hang_kill_;
+      value_param<unsigned>    hang_watch_;
       value_param<const char*> id_string_;
       value_param<const char*> illegal_rep_;
+      activation_param         inline_;
       activation_param         list_tests_;
       activation_param         list_tags_;
       activation_param         nodeps_;
       value_param<const char*> output_;
+      value_param<unsigned>    output_limit_;
       named_param              param_;
+      activation_param         perf_counters_;
+#ifdef USE_BACKTRACE
+      value_param<const char*> profile_;
+      activation_param         profile_failed_;
+#endif
       activation_param         quiet_;
+      value_param<const char*> resume_;
+      activation_param         runner_stats_;
+      value_param<const char*> serve_;
       activation_param         single_shot_;
       value_param<unsigned>    timeout_multiplier_;
+#ifdef USE_BACKTRACE
+      activation_param         timeout_stacks_;
+#endif
       activation_param         disable_timeouts_;
       value_param<const char*> tags_;
+      value_param<const char*> trace_;
       activation_param         verbose_;
       activation_param         version_;
+#ifdef HAVE_INOTIFY
+      activation_param         watch_;
+#endif
       boolean_flip             xml_;
       const char *const       *argv_;
       const char *const       *end_;
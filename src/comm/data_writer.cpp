@@ -55,12 +55,24 @@ namespace crpcut {
         }
       return *this;
     }
-  }
-}
-
-
-
-
 
+    void
+    data_writer
+    ::begin_message() const
+    {
+    }
 
+    void
+    data_writer
+    ::end_message() const
+    {
+    }
 
+    size_t
+    data_writer
+    ::max_frame() const
+    {
+      return reporter::frame_size;
+    }
+  }
+}
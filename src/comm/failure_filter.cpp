@@ -0,0 +1,248 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "failure_filter.hpp"
+#include "../wrapped/posix_encapsulation.hpp"
+#include <new>
+
+namespace {
+  const unsigned long long fnv_offset = 14695981039346656037ULL;
+  const unsigned long long fnv_prime  = 1099511628211ULL;
+
+  unsigned long long hash(unsigned long long h, const char *p, std::size_t len)
+  {
+    for (std::size_t i = 0; i < len; ++i)
+      {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= fnv_prime;
+      }
+    return h;
+  }
+
+  bool same(crpcut::datatypes::fixed_string l, crpcut::datatypes::fixed_string r)
+  {
+    if (l.len != r.len) return false;
+    if (l.str == r.str) return true;
+    for (std::size_t i = 0; i < l.len; ++i)
+      {
+        if (l.str[i] != r.str[i]) return false;
+      }
+    return true;
+  }
+
+  class guard
+  {
+  public:
+    explicit guard(pthread_mutex_t &m) : m_(m) { pthread_mutex_lock(&m_); }
+    ~guard() { pthread_mutex_unlock(&m_); }
+  private:
+    guard(const guard&);
+    guard& operator=(const guard&);
+    pthread_mutex_t &m_;
+  };
+
+  template <typename T>
+  T *allocate(std::size_t n)
+  {
+    void *p = crpcut::wrapped::malloc(n * sizeof(T));
+    if (!p) throw std::bad_alloc();
+    return static_cast<T*>(p);
+  }
+}
+
+namespace crpcut {
+  namespace comm {
+
+    const std::size_t failure_filter::per_location;
+
+    failure_filter
+    ::failure_filter(std::size_t limit)
+      : limit_(limit),
+        num_reported_(0),
+        num_held_back_(0),
+        sites_(0),
+        num_sites_(0),
+        sites_capacity_(0),
+        reported_(0),
+        reported_capacity_(0),
+        next_summary_(0)
+    {
+      pthread_mutex_init(&lock_, 0);
+    }
+
+    failure_filter
+    ::~failure_filter()
+    {
+      pthread_mutex_destroy(&lock_);
+      wrapped::free(sites_);
+      wrapped::free(reported_);
+    }
+
+    bool
+    failure_filter
+    ::admit(datatypes::fixed_string location,
+            const char             *msg,
+            std::size_t             len)
+    {
+      const unsigned long long site_hash = hash(fnv_offset,
+                                                location.str,
+                                                location.len);
+      unsigned long long h = hash(hash(site_hash, "", 1), msg, len);
+      if (h == 0) h = 1; // 0 marks a free slot
+      guard g(lock_);
+      site *s = find_site(location, site_hash);
+      if (is_repeat(h))
+        {
+          ++s->repeats;
+          return false;
+        }
+      if (s->reported == per_location)
+        {
+          ++s->held_back;
+          return false;
+        }
+      if (limit_ && num_reported_ == limit_)
+        {
+          ++num_held_back_;
+          return false;
+        }
+      remember(h);
+      ++s->reported;
+      ++num_reported_;
+      return true;
+    }
+
+    failure_filter::site *
+    failure_filter
+    ::find_site(datatypes::fixed_string location, unsigned long long h)
+    {
+      // the failing locations of a test are few
+      for (std::size_t i = 0; i < num_sites_; ++i)
+        {
+          if (sites_[i].hash == h && same(sites_[i].location, location))
+            {
+              return &sites_[i];
+            }
+        }
+      if (num_sites_ == sites_capacity_)
+        {
+          std::size_t capacity = sites_capacity_ ? sites_capacity_ * 2 : 8;
+          site *p = allocate<site>(capacity);
+          if (num_sites_)
+            {
+              wrapped::memcpy(p, sites_, num_sites_ * sizeof(site));
+            }
+          wrapped::free(sites_);
+          sites_ = p;
+          sites_capacity_ = capacity;
+        }
+      site &s = sites_[num_sites_++];
+      s.location  = location;
+      s.hash      = h;
+      s.reported  = 0;
+      s.repeats   = 0;
+      s.held_back = 0;
+      return &s;
+    }
+
+    bool
+    failure_filter
+    ::is_repeat(unsigned long long h)
+    {
+      if (!reported_) return false;
+      const std::size_t mask = reported_capacity_ - 1;
+      for (std::size_t i = std::size_t(h) & mask; reported_[i]; i = (i + 1) & mask)
+        {
+          if (reported_[i] == h) return true;
+        }
+      return false;
+    }
+
+    void
+    failure_filter
+    ::remember(unsigned long long h)
+    {
+      if ((num_reported_ + 1) * 2 > reported_capacity_)
+        {
+          const std::size_t old_capacity = reported_capacity_;
+          unsigned long long *old = reported_;
+          reported_capacity_ = old_capacity ? old_capacity * 2 : 64;
+          reported_ = allocate<unsigned long long>(reported_capacity_);
+          for (std::size_t i = 0; i < reported_capacity_; ++i)
+            {
+              reported_[i] = 0;
+            }
+          for (std::size_t i = 0; i < old_capacity; ++i)
+            {
+              if (old[i]) remember(old[i]);
+            }
+          wrapped::free(old);
+        }
+      const std::size_t mask = reported_capacity_ - 1;
+      std::size_t i = std::size_t(h) & mask;
+      while (reported_[i]) i = (i + 1) & mask;
+      reported_[i] = h;
+    }
+
+    bool
+    failure_filter
+    ::next_summary(datatypes::fixed_string &location,
+                   std::ostream            &os)
+    {
+      guard g(lock_);
+      while (next_summary_ < num_sites_)
+        {
+          site &s = sites_[next_summary_++];
+          const unsigned long n = s.repeats + s.held_back;
+          if (!n) continue;
+          location = s.location;
+          os << "and " << n << " more";
+          if (!s.held_back)
+            {
+              os << ", all repeats of failures above";
+            }
+          else if (s.repeats)
+            {
+              os << ", " << s.repeats << " of them repeats of failures above";
+            }
+          os << ", not reported";
+          s.repeats = 0;
+          s.held_back = 0;
+          return true;
+        }
+      next_summary_ = 0;
+      if (num_held_back_)
+        {
+          location = datatypes::fixed_string::make(0, 0);
+          os << "and " << num_held_back_
+             << " more failures, not reported after the limit of " << limit_;
+          num_held_back_ = 0;
+          return true;
+        }
+      return false;
+    }
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef COMM_FAILURE_FILTER_HPP
+#define COMM_FAILURE_FILTER_HPP
+
+#include <crpcut.hpp>
+extern "C" {
+#  include <pthread.h>
+}
+
+namespace crpcut {
+  namespace comm {
+
+    // Coalesces the failures reported by a test, in the test process.
+    // A failure with the same location and message as one already
+    // reported is only counted. Of the distinct failures, only the first
+    // per_location from each location are reported, and at most limit
+    // from the whole test, if there is a limit. What was held back is
+    // summarised before the test ends.
+    //
+    // Memory is taken directly from the system, so that failures inside
+    // heap checking scopes are not seen as leaks. The threads of a test
+    // may fail at the same time, so the tables are guarded by a mutex.
+    class failure_filter
+    {
+    public:
+      static const std::size_t per_location = 10;
+      explicit failure_filter(std::size_t limit = 0);
+      ~failure_filter();
+      // true if the failure is to be reported
+      bool admit(datatypes::fixed_string location,
+                 const char             *msg,
+                 std::size_t             len);
+      // Writes a summary of what was held back at one location to os, and
+      // forgets it. A summary of what was held back by the limit has no
+      // location. Returns false when there is nothing left to summarise.
+      bool next_summary(datatypes::fixed_string &location,
+                        std::ostream            &os);
+    private:
+      struct site
+      {
+        datatypes::fixed_string location;
+        unsigned long long      hash;
+        std::size_t             reported;
+        unsigned long           repeats;
+        unsigned long           held_back;
+      };
+      failure_filter(const failure_filter&);
+      failure_filter& operator=(const failure_filter&);
+      site *find_site(datatypes::fixed_string location,
+                      unsigned long long      hash);
+      bool is_repeat(unsigned long long hash);
+      void remember(unsigned long long hash);
+
+      pthread_mutex_t     lock_;
+      const std::size_t   limit_;
+      std::size_t         num_reported_;
+      unsigned long       num_held_back_;
+      site               *sites_;
+      std::size_t         num_sites_;
+      std::size_t         sites_capacity_;
+      unsigned long long *reported_;      // open addressing set of hashes
+      std::size_t         reported_capacity_;
+      std::size_t         next_summary_;
+    };
+  }
+}
+
+#endif // COMM_FAILURE_FILTER_HPP
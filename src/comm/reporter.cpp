@@ -28,6 +28,57 @@
 #include <crpcut.hpp>
 #include "../wrapped/posix_encapsulation.hpp"
 #include "../sigignore.hpp"
+#include "failure_filter.hpp"
+#include <algorithm>
+
+namespace {
+  // Most messages fit in a frame this short, which is kept on the stack.
+  const size_t stack_frame_size = 1024;
+
+  // Keeps the frames of a message together, and holds the buffer they
+  // are built in. A message longer than stack_frame_size gets a frame on
+  // the heap, as long as the writer takes, or the stack frame if the
+  // heap has nothing to give.
+  class message_frames
+  {
+  public:
+    message_frames(const crpcut::comm::data_writer &writer,
+                   size_t                          message_len,
+                   char                           *stack_buff)
+      : writer_(writer),
+        buff_(stack_buff),
+        heap_(0),
+        size_(stack_frame_size)
+    {
+      if (message_len > size_)
+        {
+          const size_t len = std::min(message_len, writer_.max_frame());
+          heap_ = crpcut::wrapped::malloc(len);
+          if (heap_)
+            {
+              buff_ = static_cast<char*>(heap_);
+              size_ = len;
+            }
+        }
+      writer_.begin_message();
+    }
+    ~message_frames()
+    {
+      writer_.end_message();
+      crpcut::wrapped::free(heap_);
+    }
+    char *buff() const { return buff_; }
+    size_t size() const { return size_; }
+  private:
+    message_frames(const message_frames&);
+    message_frames& operator=(const message_frames&);
+
+    const crpcut::comm::data_writer &writer_;
+    char                            *buff_;
+    void                            *heap_;
+    size_t                           size_;
+  };
+}
 
 namespace crpcut {
 
@@ -38,34 +89,59 @@ namespace crpcut {
     {
     }
 
+    const size_t reporter::frame_size;
+
     void reporter::send_message(type t, const char *msg, size_t len, datatypes::fixed_string location) const
     {
       const size_t header_size = sizeof(t) + sizeof(len);
-      size_t buff_size = header_size + len;
-      if (location)
-        {
-          buff_size += location.len + sizeof(location.len);
-        }
-      void *report_addr = alloca(buff_size);
+      const void *location_len_addr = &location.len;
+      struct { const char *p; size_t len; } const parts[] = {
+        { static_cast<const char*>(location_len_addr),
+          location ? sizeof(location.len) : 0 },
+        { location.str, location ? location.len : 0 },
+        { msg, len }
+      };
+      const size_t num_parts = sizeof(parts)/sizeof(parts[0]);
+      size_t remaining = parts[0].len + parts[1].len + parts[2].len;
 
-      *static_cast<type*>(report_addr) = t;
-      char *p = static_cast<char *>(report_addr);
-      p+= sizeof(type);
-
-      size_t msg_size(buff_size - header_size);
-      memcpy(p, &msg_size, sizeof(msg_size));
-      //      *static_cast<size_t*>(static_cast<void*>(p)) = buff_size - header_size;
-      p+= sizeof(len);
-      if (location)
+      char stack_frame[stack_frame_size];
+      sigignore ignore(SIGPIPE);
+      message_frames frames(*writer_, header_size + remaining, stack_frame);
+      char *frame = frames.buff();
+      const size_t frame_max = frames.size();
+      size_t part = 0;
+      size_t part_pos = 0;
+      do
         {
-          wrapped::memcpy(p, &location.len, sizeof(location.len));
-          p+= sizeof(location.len);
-          wrapped::memcpy(p, location.str, location.len);
-          p+= location.len;
+          size_t frame_len = 0;
+          while (frame_len < frame_max - header_size && part < num_parts)
+            {
+              size_t n = parts[part].len - part_pos;
+              if (n > frame_max - header_size - frame_len)
+                {
+                  n = frame_max - header_size - frame_len;
+                }
+              if (n)
+                {
+                  wrapped::memcpy(frame + header_size + frame_len,
+                                  parts[part].p + part_pos,
+                                  n);
+                }
+              frame_len += n;
+              part_pos += n;
+              if (part_pos == parts[part].len)
+                {
+                  ++part;
+                  part_pos = 0;
+                }
+            }
+          remaining -= frame_len;
+          const type ft = remaining ? type(t | continued) : t;
+          wrapped::memcpy(frame, &ft, sizeof(ft));
+          wrapped::memcpy(frame + sizeof(ft), &frame_len, sizeof(frame_len));
+          writer_->write_loop(frame, header_size + frame_len);
         }
-      wrapped::memcpy(p, msg, len);
-      sigignore ignore(SIGPIPE);
-      writer_->write_loop(report_addr, buff_size);
+      while (remaining);
     }
 
     void reporter
@@ -102,6 +178,16 @@ namespace crpcut {
           {
             t = static_cast<type>(t | kill_me);
           }
+        if (filter_ && t == comm::fail && !filter_->admit(location, msg, len))
+          {
+            return;
+          }
+        if (filter_ && (t == comm::end_test
+                        || t == comm::exit_ok
+                        || t == comm::exit_fail))
+          {
+            send_failure_summary(current_test);
+          }
         send_message(t, msg, len, location);
 
         if (t == comm::exit_fail || testicide)
@@ -115,10 +201,25 @@ namespace crpcut {
         }
     }
 
+    void reporter
+    ::send_failure_summary(const crpcut_test_monitor *current_test) const
+    {
+      for (;;)
+        {
+          std::ostringstream os;
+          datatypes::fixed_string location;
+          if (!filter_->next_summary(location, os)) break;
+          if (!location) location = current_test->get_location();
+          const std::string &s = os.str();
+          send_message(comm::info, s.c_str(), s.length(), location);
+        }
+    }
+
     reporter::reporter(std::ostream &default_out)
       : writer_(0),
         reader_(0),
-        default_out_(default_out)
+        default_out_(default_out),
+        filter_(0)
     {
     }
 
@@ -129,6 +230,12 @@ namespace crpcut {
       writer_ = w;
     }
 
+    void
+    reporter::set_failure_filter(failure_filter *f)
+    {
+      filter_ = f;
+    }
+
     void
     reporter::operator()(type                       t,
                          const stream::oastream    &os,
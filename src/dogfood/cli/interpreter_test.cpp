@@ -38,10 +38,18 @@ namespace {
 "        better error pinpointing of heap violations (slow)\n"
 "\n"
 #endif
+"   --capture-output\n"
+"        Collect stdout and stderr from each test in a file, and\n"
+"        present it when the test finishes, instead of live\n"
+"\n"
 "   -c number / --children=number\n"
 "        Control number of concurrently running test processes\n"
 "        number must be at least 1\n"
 "\n"
+"   --checkpoint=interval\n"
+"        Keep a journal of completed tests next to the -o report,\n"
+"        synced to disk every interval completed tests\n"
+"\n"
 "   -C charset / --output-charset=charset\n"
 "        Specify the output character set to convert text output\n"
 "        to. Does not apply for XML output\n"
@@ -49,6 +57,24 @@ namespace {
 "   -d dirname / --working-dir=dirname\n"
 "        Specify working directory (must exist)\n"
 "\n"
+"   --events=fd|path\n"
+"        Write an event per line, in JSON, as each test is\n"
+"        scheduled, started, changes phase, produces output and\n"
+"        finishes, to an open file descriptor or to a file\n"
+"\n"
+"   --failure-limit=number\n"
+"        Report at most number distinct failures from each\n"
+"        test, and summarise the rest\n"
+"\n"
+"   --hang-kill\n"
+"        Kill a test that --hang-watch suspects is deadlocked,\n"
+"        and fail it, instead of only reporting it\n"
+"\n"
+"   --hang-watch=milliseconds\n"
+"        Report a test as a suspected deadlock when it has used\n"
+"        no CPU time for milliseconds, with all its threads\n"
+"        blocked, and show what each thread waits for\n"
+"\n"
 "   -i \"id string\" / --identity=\"id string\"\n"
 "        Specify an identity string for the XML-header\n"
 "\n"
@@ -56,6 +82,10 @@ namespace {
 "        Specify how characters that are illegal for the chosen\n"
 "        output character set are to be represented\n"
 "\n"
+"   --inline-presenter\n"
+"        Present results from the process that runs the tests,\n"
+"        instead of from a process of its own\n"
+"\n"
 "   -l / --list\n"
 "        List test cases\n"
 "\n"
@@ -69,12 +99,45 @@ namespace {
 "        Direct XML output to a named file. A brief summary will be\n"
 "        displayed on stdout\n"
 "\n"
+"   --output-limit=bytes\n"
+"        Present at most bytes each of stdout, stderr and INFO\n"
+"        output from a test, keeping the beginning and the end.\n"
+"        All of it is written to a file in the working directory\n"
+"\n"
 "   -p name=value / --param=name=value\n"
 "        Defined a named variable for access from the test cases\n"
 "\n"
+"   --perf-counters\n"
+"        Count instructions, cycles, branch misses and cache\n"
+"        misses of each test, and include them in the report\n"
+"\n"
+#ifdef USE_BACKTRACE
+"   --profile=dirname\n"
+"        Sample the stack of each test on CPU time, and write the\n"
+"        samples as folded stacks, for flame graphs, to a file\n"
+"        per test in dirname\n"
+"\n"
+"   --profile-failed\n"
+"        Only keep the --profile samples of failed tests\n"
+"\n"
+#endif
 "   -q / --quiet\n"
 "        Don't display the -o brief summary\n"
 "\n"
+"   --resume=journal\n"
+"        Skip the tests already completed according to a journal\n"
+"        from an interrupted run, and include their results in\n"
+"        the report\n"
+"\n"
+"   --runner-stats\n"
+"        Measure the cost of running each test, in start\n"
+"        latency, messages and post mortem time, and the lag of\n"
+"        the presentation, and include them in the report\n"
+"\n"
+"   --serve=socket\n"
+"        Stay resident, and serve run requests on a Unix domain\n"
+"        socket. A request is a line with command line arguments\n"
+"\n"
 "   -s / --single-shot\n"
 "        Run only one test case, and run it in the main process\n"
 "        for ease of debugging\n"
@@ -82,6 +145,12 @@ namespace {
 "   --timeout-multiplier=factor\n"
 "        Multiply all timeout times with a factor\n"
 "\n"
+#ifdef USE_BACKTRACE
+"   --timeout-stacks\n"
+"        Write the stack of each thread of a test to the\n"
+"        report before killing it for timing out\n"
+"\n"
+#endif
 "   -t / --disable-timeouts\n"
 "        Never fail a test due to time consumption\n"
 "\n"
@@ -93,12 +162,23 @@ namespace {
 "        the list is subtractive from the full set.\n"
 "        Untagged tests cannot be made non-critical\n"
 "\n"
+"   --trace=filename\n"
+"        Write a timeline of the run, with the phases of each test,\n"
+"        to a file in trace event format, for chrome://tracing and\n"
+"        Perfetto\n"
+"\n"
 "   -v / --verbose\n"
 "        Verbose mode - include results from passed tests\n"
 "\n"
 "   -V / --version\n"
 "        Print version string and exit\n"
 "\n"
+#ifdef HAVE_INOTIFY
+"   --watch\n"
+"        Stay resident, and run the tests again whenever the\n"
+"        test program is rebuilt\n"
+"\n"
+#endif
 "   -x {boolean value} / --xml{=boolean value}\n"
 "        XML output on stdout or non-XML output on file\n"
 "\n";
@@ -518,5 +598,381 @@ TESTSUITE(cli)
       ASSERT_FALSE(cli.honour_timeouts());
     }
 
+    TEST(checkpoint_interval_is_zero_if_not_included_in_argv)
+    {
+      ARGV("-o", "apa", "katt");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.checkpoint_interval() == 0U);
+    }
+
+    TEST(checkpoint_interval_is_returned_as_in_argv)
+    {
+      ARGV("-o", "apa", "--checkpoint=20", "katt");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.checkpoint_interval() == 20U);
+      ASSERT_TRUE(cli.get_test_list() == argv + 4);
+    }
+
+    TEST(zero_checkpoint_interval_throws)
+    {
+      ARGV("-o", "apa", "--checkpoint=0");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "--checkpoint=interval - interval must be at least 1");
+    }
+
+    TEST(checkpoint_without_output_file_throws)
+    {
+      ARGV("--checkpoint=10", "apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "--checkpoint=interval requires -o filename / --output=filename");
+    }
+
+    TEST(resume_journal_is_null_if_not_included_in_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.resume_journal());
+    }
+
+    TEST(resume_journal_is_returned_as_in_argv)
+    {
+      ARGV("--resume=apa.journal", "katt");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.resume_journal() == argv[1] + 9);
+      ASSERT_TRUE(cli.get_test_list() == argv + 2);
+    }
+
+    TEST(resume_cannot_be_combined_with_single_shot)
+    {
+      ARGV("-s", "--resume=apa.journal", "katt");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-s / --single-shot cannot be combined with --resume=journal");
+    }
+
+    TEST(runner_stats_are_disabled_if_not_activated_by_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.runner_stats());
+    }
+
+    TEST(runner_stats_are_enabled_if_activated_in_argv)
+    {
+      ARGV("--runner-stats", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.runner_stats());
+      ASSERT_TRUE(cli.get_test_list() == argv + 2);
+    }
+
+    TEST(runner_stats_cannot_be_combined_with_single_shot)
+    {
+      ARGV("-s", "--runner-stats", "apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-s / --single-shot cannot be combined with --runner-stats");
+    }
+
+    TEST(serve_path_is_null_if_not_included_in_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.serve_path());
+    }
+
+    TEST(serve_path_is_returned_as_in_argv)
+    {
+      ARGV("--serve=/tmp/apa", "-v", "katt");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.serve_path() == argv[1] + 8);
+      ASSERT_TRUE(cli.get_test_list() == argv + 3);
+    }
+
+    TEST(serve_mode_cannot_be_combined_with_single_shot)
+    {
+      ARGV("-s", "--serve=/tmp/apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-s / --single-shot cannot be combined with --serve=socket");
+    }
+
+    TEST(capture_output_is_disabled_if_not_activated_by_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.capture_output());
+    }
+
+    TEST(capture_output_is_enabled_if_activated_in_argv)
+    {
+      ARGV("--capture-output", "-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.capture_output());
+      ASSERT_TRUE(cli.get_test_list() == argv + 3);
+    }
+
+    TEST(capture_output_cannot_be_combined_with_single_shot)
+    {
+      ARGV("-s", "--capture-output", "apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-s / --single-shot cannot be combined with --capture-output");
+    }
+
+    TEST(output_limit_is_zero_if_not_included_in_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.output_limit() == 0U);
+    }
+
+    TEST(output_limit_is_returned_as_in_argv)
+    {
+      ARGV("--output-limit=4096", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.output_limit() == 4096U);
+      ASSERT_TRUE(cli.get_test_list() == argv + 2);
+    }
+
+    TEST(zero_output_limit_throws)
+    {
+      ARGV("--output-limit=0");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "--output-limit=bytes - bytes must be at least 1");
+    }
+
+    TEST(failure_limit_is_zero_if_not_included_in_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.failure_limit() == 0U);
+    }
+
+    TEST(failure_limit_is_returned_as_in_argv)
+    {
+      ARGV("--failure-limit=100", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.failure_limit() == 100U);
+      ASSERT_TRUE(cli.get_test_list() == argv + 2);
+    }
+
+    TEST(zero_failure_limit_throws)
+    {
+      ARGV("--failure-limit=0");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "--failure-limit=number - number must be at least 1");
+    }
+
+    TEST(events_target_is_null_if_not_included_in_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.events_target());
+    }
+
+    TEST(events_target_is_returned_as_in_argv)
+    {
+      ARGV("--events=3", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.events_target() == argv[1] + 9);
+      ASSERT_TRUE(cli.get_test_list() == argv + 2);
+    }
+
+    TEST(events_cannot_be_combined_with_single_shot)
+    {
+      ARGV("-s", "--events=events.json", "apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-s / --single-shot cannot be combined with --events=fd|path");
+    }
+
+    TEST(hang_watch_is_zero_if_not_included_in_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.hang_watch_ms() == 0U);
+      ASSERT_FALSE(cli.hang_kill());
+    }
+
+    TEST(hang_watch_and_kill_are_returned_as_in_argv)
+    {
+      ARGV("--hang-watch=2000", "--hang-kill", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.hang_watch_ms() == 2000U);
+      ASSERT_TRUE(cli.hang_kill());
+      ASSERT_TRUE(cli.get_test_list() == argv + 3);
+    }
+
+    TEST(hang_kill_without_hang_watch_throws)
+    {
+      ARGV("--hang-kill", "apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "--hang-kill requires --hang-watch=milliseconds");
+    }
+
+    TEST(perf_counters_are_disabled_if_not_activated_by_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.perf_counters());
+    }
+
+    TEST(perf_counters_are_enabled_if_activated_in_argv)
+    {
+      ARGV("--perf-counters", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.perf_counters());
+      ASSERT_TRUE(cli.get_test_list() == argv + 2);
+    }
+
+    TEST(perf_counters_cannot_be_combined_with_single_shot)
+    {
+      ARGV("-s", "--perf-counters", "apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-s / --single-shot cannot be combined with --perf-counters");
+    }
+
+    TEST(trace_file_is_null_if_not_included_in_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.trace_file());
+    }
+
+    TEST(trace_file_is_returned_as_in_argv)
+    {
+      ARGV("--trace=run.json", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.trace_file() == argv[1] + 8);
+      ASSERT_TRUE(cli.get_test_list() == argv + 2);
+    }
+
+    TEST(trace_cannot_be_combined_with_list)
+    {
+      ARGV("-l", "--trace=run.json");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-l / --list cannot be combined with --trace=filename");
+    }
+
+#ifdef USE_BACKTRACE
+    TEST(profile_dir_is_null_if_not_included_in_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.profile_dir());
+      ASSERT_FALSE(cli.profile_failed_only());
+    }
+
+    TEST(profile_dir_is_returned_as_in_argv)
+    {
+      ARGV("--profile=flames", "--profile-failed", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.profile_dir() == argv[1] + 10);
+      ASSERT_TRUE(cli.profile_failed_only());
+      ASSERT_TRUE(cli.get_test_list() == argv + 3);
+    }
+
+    TEST(profile_cannot_be_combined_with_single_shot)
+    {
+      ARGV("-s", "--profile=flames", "apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-s / --single-shot cannot be combined with --profile=dirname");
+    }
+
+    TEST(profile_failed_requires_profile)
+    {
+      ARGV("--profile-failed", "apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "--profile-failed requires --profile=dirname");
+    }
+
+    TEST(timeout_stacks_are_disabled_if_not_activated_by_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.timeout_stacks());
+    }
+
+    TEST(timeout_stacks_are_enabled_if_activated_in_argv)
+    {
+      ARGV("--timeout-stacks", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.timeout_stacks());
+      ASSERT_TRUE(cli.get_test_list() == argv + 2);
+    }
+
+    TEST(timeout_stacks_cannot_be_combined_with_list)
+    {
+      ARGV("-l", "--timeout-stacks");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-l / --list cannot be combined with --timeout-stacks");
+    }
+#endif
+
+    TEST(inline_presenter_is_disabled_if_not_activated_by_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.inline_presenter());
+    }
+
+    TEST(inline_presenter_is_enabled_if_activated_in_argv)
+    {
+      ARGV("--inline-presenter", "-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.inline_presenter());
+      ASSERT_TRUE(cli.get_test_list() == argv + 3);
+    }
+
+    TEST(inline_presenter_cannot_be_combined_with_list)
+    {
+      ARGV("-l", "--inline-presenter");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "-l / --list cannot be combined with --inline-presenter");
+    }
+
+#ifdef HAVE_INOTIFY
+    TEST(watch_mode_is_disabled_if_not_activated_by_argv)
+    {
+      ARGV("-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_FALSE(cli.watch_mode());
+    }
+
+    TEST(watch_mode_is_enabled_if_activated_in_argv)
+    {
+      ARGV("--watch", "-v", "apa");
+      crpcut::cli::interpreter cli(argv);
+      ASSERT_TRUE(cli.watch_mode());
+      ASSERT_TRUE(cli.get_test_list() == argv + 3);
+    }
+
+    TEST(watch_mode_cannot_be_combined_with_single_shot)
+    {
+      ARGV("--watch", "-s", "apa");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "--watch cannot be combined with -s / --single-shot");
+    }
+
+    TEST(watch_mode_cannot_be_combined_with_list)
+    {
+      ARGV("-l", "--watch");
+      ASSERT_THROW(crpcut::cli::interpreter cli(argv),
+                   crpcut::cli::param::exception,
+                   "--watch cannot be combined with -l / --list");
+    }
+#endif
   }
 }
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include "../../comm/failure_filter.hpp"
+#include <sstream>
+#include <vector>
+#include <cstring>
+extern "C" {
+#  include <pthread.h>
+}
+
+namespace {
+  crpcut::datatypes::fixed_string here = { "here.cpp:10", 11 };
+  crpcut::datatypes::fixed_string there = { "there.cpp:20", 12 };
+
+  bool admit(crpcut::comm::failure_filter &filter,
+             crpcut::datatypes::fixed_string location,
+             const char *msg)
+  {
+    return filter.admit(location, msg, std::strlen(msg));
+  }
+
+  // One thread failing twice at each of its own sites, so the tables of
+  // the filter grow while the other threads use them.
+  struct failing_thread
+  {
+    crpcut::comm::failure_filter *filter;
+    std::vector<std::string>      sites;
+    std::size_t                   admitted;
+    pthread_t                     id;
+  };
+
+  extern "C" void *fail_at_all_sites(void *p)
+  {
+    failing_thread *t = static_cast<failing_thread*>(p);
+    for (std::size_t i = 0; i < t->sites.size(); ++i)
+      {
+        const std::string &s = t->sites[i];
+        crpcut::datatypes::fixed_string loc = { s.c_str(), s.length() };
+        t->admitted += t->filter->admit(loc, "x", 1);
+        t->admitted += t->filter->admit(loc, "x", 1);
+      }
+    return 0;
+  }
+
+  std::string summary(crpcut::comm::failure_filter &filter,
+                      crpcut::datatypes::fixed_string &location)
+  {
+    std::ostringstream os;
+    if (!filter.next_summary(location, os)) return "<none>";
+    return os.str();
+  }
+}
+
+TESTSUITE(comm)
+{
+  TESTSUITE(failure_filter)
+  {
+    TEST(distinct_failures_are_admitted)
+    {
+      crpcut::comm::failure_filter filter;
+      ASSERT_TRUE(admit(filter, here, "a"));
+      ASSERT_TRUE(admit(filter, here, "b"));
+      ASSERT_TRUE(admit(filter, there, "a"));
+      crpcut::datatypes::fixed_string location = there;
+      ASSERT_TRUE(summary(filter, location) == "<none>");
+    }
+
+    TEST(repeated_failures_are_counted_and_summarised)
+    {
+      crpcut::comm::failure_filter filter;
+      ASSERT_TRUE(admit(filter, here, "a"));
+      ASSERT_TRUE(admit(filter, there, "a"));
+      for (int i = 0; i < 1000; ++i)
+        {
+          ASSERT_FALSE(admit(filter, here, "a"));
+        }
+      crpcut::datatypes::fixed_string location = there;
+      ASSERT_TRUE(summary(filter, location)
+                  == "and 1000 more, all repeats of failures above,"
+                     " not reported");
+      ASSERT_TRUE(location == here);
+      ASSERT_TRUE(summary(filter, location) == "<none>");
+    }
+
+    TEST(failures_beyond_per_location_are_held_back)
+    {
+      crpcut::comm::failure_filter filter;
+      const std::size_t n = crpcut::comm::failure_filter::per_location;
+      for (std::size_t i = 0; i < n + 5; ++i)
+        {
+          std::ostringstream os;
+          os << "failure " << i;
+          const std::string &s = os.str();
+          ASSERT_TRUE(filter.admit(here, s.c_str(), s.length()) == (i < n));
+        }
+      ASSERT_FALSE(admit(filter, here, "failure 0"));
+      ASSERT_TRUE(admit(filter, there, "failure 0"));
+      crpcut::datatypes::fixed_string location = there;
+      ASSERT_TRUE(summary(filter, location)
+                  == "and 6 more, 1 of them repeats of failures above,"
+                     " not reported");
+      ASSERT_TRUE(location == here);
+    }
+
+    TEST(failures_beyond_limit_are_held_back_and_summarised_without_location)
+    {
+      crpcut::comm::failure_filter filter(2);
+      ASSERT_TRUE(admit(filter, here, "a"));
+      ASSERT_TRUE(admit(filter, there, "a"));
+      ASSERT_FALSE(admit(filter, here, "b"));
+      ASSERT_FALSE(admit(filter, there, "b"));
+      ASSERT_FALSE(admit(filter, there, "c"));
+      crpcut::datatypes::fixed_string location = here;
+      ASSERT_TRUE(summary(filter, location)
+                  == "and 3 more failures, not reported after the limit of 2");
+      ASSERT_FALSE(location);
+      ASSERT_TRUE(summary(filter, location) == "<none>");
+    }
+
+    TEST(failures_from_several_threads_at_once_are_all_counted)
+    {
+      const std::size_t num_threads = 8;
+      const std::size_t num_sites = 300;
+      crpcut::comm::failure_filter filter;
+      failing_thread threads[num_threads];
+      for (std::size_t n = 0; n < num_threads; ++n)
+        {
+          threads[n].filter = &filter;
+          threads[n].admitted = 0;
+          for (std::size_t i = 0; i < num_sites; ++i)
+            {
+              std::ostringstream os;
+              os << "thread" << n << ".cpp:" << i;
+              threads[n].sites.push_back(os.str());
+            }
+        }
+      for (std::size_t n = 0; n < num_threads; ++n)
+        {
+          ASSERT_TRUE(pthread_create(&threads[n].id, 0,
+                                     fail_at_all_sites, &threads[n]) == 0);
+        }
+      for (std::size_t n = 0; n < num_threads; ++n)
+        {
+          pthread_join(threads[n].id, 0);
+          ASSERT_TRUE(threads[n].admitted == num_sites);
+        }
+      std::size_t num_summaries = 0;
+      crpcut::datatypes::fixed_string location;
+      while (summary(filter, location) != "<none>") ++num_summaries;
+      ASSERT_TRUE(num_summaries == num_threads * num_sites);
+    }
+
+    TEST(many_distinct_failures_are_remembered)
+    {
+      std::vector<std::string> sites;
+      for (std::size_t i = 0; i < 500; ++i)
+        {
+          std::ostringstream os;
+          os << "site" << i;
+          sites.push_back(os.str());
+        }
+      crpcut::comm::failure_filter filter;
+      for (std::size_t i = 0; i < sites.size(); ++i)
+        {
+          const std::string &s = sites[i];
+          crpcut::datatypes::fixed_string loc = { s.c_str(), s.length() };
+          ASSERT_TRUE(filter.admit(loc, "x", 1));
+          ASSERT_FALSE(filter.admit(loc, "x", 1));
+        }
+    }
+  }
+}
@@ -26,6 +26,8 @@
 
 #include <trompeloeil.hpp>
 #include <crpcut.hpp>
+#include <string>
+#include <vector>
 
 namespace {
   typedef crpcut::datatypes::fixed_string fs;
@@ -213,5 +215,41 @@ TESTSUITE(comm)
       static const char apa[] = "apa";
       r(crpcut::comm::info, apa, location, &mon);
     }
+
+    TEST(reporter_splits_long_message_into_continued_frames, fix)
+    {
+      using crpcut::comm::reporter;
+      const std::size_t header_size = sizeof(crpcut::comm::type)
+                                      + sizeof(std::size_t);
+      const std::size_t payload_size = reporter::frame_size - header_size;
+      const std::string msg(payload_size, 'x');
+      const std::size_t total = sizeof(std::size_t) + 10 + msg.length();
+
+      std::vector<char> first(reporter::frame_size);
+      void *addr = set_to(&first[0], crpcut::comm::type(crpcut::comm::info
+                                                        | crpcut::comm::continued));
+      char *p = static_cast<char*>(set_to(addr, payload_size));
+      p = static_cast<char*>(set_to(p, std::size_t(10)));
+      memcpy(p, "apa.cpp:32", 10);
+      memcpy(p + 10, msg.c_str(), payload_size - sizeof(std::size_t) - 10);
+
+      const std::size_t rest = total - payload_size;
+      std::vector<char> second(header_size + rest);
+      addr = set_to(&second[0], crpcut::comm::info);
+      p = static_cast<char*>(set_to(addr, rest));
+      memset(p, 'x', rest);
+
+      trompeloeil::sequence seq;
+      REQUIRE_CALL(wfd, write_loop(ne<const char*>(nullptr), first.size(), _))
+        .WITH(memcmp(_1, &first[0], _2) == 0)
+        .IN_SEQUENCE(seq)
+        .RETURN(std::ref(wfd));
+      REQUIRE_CALL(wfd, write_loop(ne<const char*>(nullptr), second.size(), _))
+        .WITH(memcmp(_1, &second[0], _2) == 0)
+        .IN_SEQUENCE(seq)
+        .RETURN(std::ref(wfd));
+
+      r(crpcut::comm::info, msg.c_str(), msg.length(), location, &mon);
+    }
   }
 }
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../event_stream.hpp"
+#include <crpcut.hpp>
+#include <string>
+extern "C" {
+#  include <unistd.h>
+}
+
+TESTSUITE(event_stream)
+{
+  class fix
+  {
+  protected:
+    fix()
+    {
+      int rv = ::pipe(fds);
+      assert(rv == 0);
+    }
+    ~fix()
+    {
+      ::close(fds[0]);
+      ::close(fds[1]);
+    }
+    std::string lines()
+    {
+      ::close(fds[1]);
+      fds[1] = -1;
+      std::string s;
+      char buff[1024];
+      ssize_t rv;
+      while ((rv = ::read(fds[0], buff, sizeof(buff))) > 0)
+        {
+          s.append(buff, std::size_t(rv));
+        }
+      return s;
+    }
+    int fds[2];
+  };
+
+  TEST(events_of_a_test_are_written_one_per_line, fix)
+  {
+    crpcut::event_stream events(fds[1]);
+    events.scheduled("s::a");
+    events.started("s::a");
+    events.phase("s::a", crpcut::destroying);
+    events.done(1, 0);
+    ASSERT_PRED(crpcut::match<crpcut::regex>(
+                  "^"
+                  "[{]\"event\":\"scheduled\",\"time_us\":[0-9]*,\"test\":\"s::a\"}\n"
+                  "[{]\"event\":\"started\",\"time_us\":[0-9]*,\"test\":\"s::a\"}\n"
+                  "[{]\"event\":\"phase\",\"time_us\":[0-9]*,\"test\":\"s::a\","
+                  "\"phase\":\"destroying\"}\n"
+                  "[{]\"event\":\"done\",\"time_us\":[0-9]*,\"run\":1,\"failed\":0}\n"
+                  "$"),
+                lines());
+  }
+
+  TEST(output_is_escaped_for_json, fix)
+  {
+    crpcut::event_stream events(fds[1]);
+    events.output("s::a",
+                  crpcut::comm::stderr,
+                  crpcut::datatypes::fixed_string::make(""),
+                  crpcut::datatypes::fixed_string::make("\"a\\b\"\n\t\x01"));
+    ASSERT_PRED(crpcut::match<crpcut::regex>(
+                  "^[{]\"event\":\"output\",\"time_us\":[0-9]*,\"test\":\"s::a\","
+                  "\"kind\":\"stderr\","
+                  "\"text\":\"\\\\\"a\\\\\\\\b\\\\\"\\\\n\\\\t\\\\u0001\"}\n$"),
+                lines());
+  }
+
+  TEST(output_that_is_not_utf8_is_replaced, fix)
+  {
+    crpcut::event_stream events(fds[1]);
+    events.output("s::a",
+                  crpcut::comm::stdout,
+                  crpcut::datatypes::fixed_string::make(""),
+                  crpcut::datatypes::fixed_string::make(
+                    "\xc3\xa5\x80\xc0\xaf\xed\xa0\x80\xf0\x9f\x98\x80\xe2\x82"));
+    ASSERT_TRUE(lines().find("\"text\":\"\xc3\xa5\\ufffd\\ufffd\\ufffd"
+                             "\\ufffd\\ufffd\\ufffd"
+                             "\xf0\x9f\x98\x80\\ufffd\\ufffd\"}\n")
+                != std::string::npos);
+  }
+
+  TEST(a_failed_test_is_finished_with_timings_and_reason, fix)
+  {
+    crpcut::event_stream events(fds[1]);
+    events.finished("s::a", false, true, crpcut::running, 1200, 800,
+                    crpcut::datatypes::fixed_string::make("Timed out - killed"));
+    ASSERT_PRED(crpcut::match<crpcut::regex>(
+                  "^[{]\"event\":\"finished\",\"time_us\":[0-9]*,\"test\":\"s::a\","
+                  "\"result\":\"failed\",\"critical\":true,\"phase\":\"running\","
+                  "\"duration_us\":1200,\"cputime_us\":800,"
+                  "\"reason\":\"Timed out - killed\"}\n$"),
+                lines());
+  }
+}
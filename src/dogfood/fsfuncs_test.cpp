@@ -26,7 +26,11 @@
 
 #include <crpcut.hpp>
 #include "../fsfuncs.hpp"
+#include <algorithm>
 #include <fstream>
+extern "C" {
+#  include <unistd.h>
+}
 
 TESTSUITE(fsfuncs)
 {
@@ -49,6 +53,15 @@ TESTSUITE(fsfuncs)
     }
     ::remove(".apa");
   }
+
+  TEST(process_groups_hold_the_process_under_its_group)
+  {
+    crpcut::process_groups groups;
+    crpcut::read_process_groups(groups);
+    const std::vector<pid_t> &group = groups[::getpgrp()];
+    ASSERT_TRUE(std::find(group.begin(), group.end(), ::getpid())
+                != group.end());
+  }
 }
 
 
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../hang_watch.hpp"
+#include <crpcut.hpp>
+extern "C" {
+#  include <unistd.h>
+#  include <sys/wait.h>
+}
+
+TESTSUITE(hang_watch)
+{
+  TEST(a_running_process_is_not_blocked)
+  {
+    unsigned long ticks;
+    bool blocked = true;
+    ASSERT_TRUE(crpcut::hang_watch::sample(::getpid(), ticks, blocked));
+    ASSERT_FALSE(blocked);
+  }
+
+  TEST(a_reaped_process_cannot_be_sampled)
+  {
+    pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) ::_exit(0);
+    int status;
+    ASSERT_TRUE(::waitpid(pid, &status, 0) == pid);
+    unsigned long ticks;
+    bool blocked;
+    ASSERT_FALSE(crpcut::hang_watch::sample(pid, ticks, blocked));
+  }
+
+  TEST(a_process_reading_an_empty_pipe_is_blocked_with_wait_channel,
+       DEADLINE_REALTIME_MS(2000))
+  {
+    int fds[2];
+    ASSERT_TRUE(::pipe(fds) == 0);
+    pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+      {
+        char c;
+        ::close(fds[1]);
+        ::_exit(int(::read(fds[0], &c, 1)));
+      }
+    ::close(fds[0]);
+    unsigned long ticks;
+    bool blocked = false;
+    while (crpcut::hang_watch::sample(pid, ticks, blocked) && !blocked)
+      {
+        ::usleep(1000);
+      }
+    ASSERT_TRUE(blocked);
+    ::usleep(10000); // no wait channel until it has left the CPU
+    const std::string threads = crpcut::hang_watch::describe_threads(pid);
+    ::close(fds[1]);
+    int status;
+    ASSERT_TRUE(::waitpid(pid, &status, 0) == pid);
+    ASSERT_PRED(crpcut::match<crpcut::regex>("^thread [0-9][0-9]* S waiting in [a-z_]"),
+                threads);
+  }
+
+  TEST(a_process_waiting_for_a_running_child_is_not_blocked,
+       DEADLINE_REALTIME_MS(2000))
+  {
+    pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+      {
+        ::setpgid(0, 0);
+        pid_t child = ::fork();
+        if (child == 0) for (;;) {}
+        int status;
+        ::_exit(::waitpid(child, &status, 0) == child);
+      }
+    ::setpgid(pid, pid);
+    unsigned long ticks = 0;
+    bool blocked = true;
+    bool sampled = false;
+    // wait for the child to use CPU time, while pid waits for it
+    for (int i = 0; i < 150; ++i)
+      {
+        sampled = crpcut::hang_watch::sample(pid, ticks, blocked);
+        if (!sampled || ticks > 0) break;
+        ::usleep(10000);
+      }
+    ::kill(-pid, SIGKILL);
+    int status;
+    ASSERT_TRUE(::waitpid(pid, &status, 0) == pid);
+    ASSERT_TRUE(sampled);
+    ASSERT_GT(ticks, 0UL);
+    ASSERT_FALSE(blocked);
+  }
+}
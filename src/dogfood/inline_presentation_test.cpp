@@ -0,0 +1,152 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../inline_presentation.hpp"
+#include "../output/heap_buffer.hpp"
+#include "../output/nil_formatter.hpp"
+#include "../registrator_list.hpp"
+#include <crpcut.hpp>
+#include <string>
+extern "C" {
+#  include <fcntl.h>
+#  include <unistd.h>
+}
+
+TESTSUITE(inline_presentation)
+{
+  class pipe_fds
+  {
+  protected:
+    pipe_fds()
+    {
+      int rv = pipe(fds);
+      assert(rv == 0);
+    }
+    ~pipe_fds()
+    {
+      close(fds[0]);
+      close(fds[1]);
+    }
+    int fds[2];
+  };
+
+  class fix : protected pipe_fds
+  {
+  protected:
+    fix()
+      : pipe_fds(),
+        fmt(buffer, "", 0, crpcut::tag_list::obj(), 0, 0),
+        presentation(buffer, fmt, fds[1],
+                     summary_buffer, fmt, -1,
+                     false, "", reg, 0, completed)
+    {
+    }
+    static void fill(crpcut::output::buffer &b, const std::string &s)
+    {
+      size_t pos = 0;
+      while (pos < s.length())
+        {
+          pos += size_t(b.write(s.c_str() + pos, s.length() - pos));
+        }
+    }
+    std::string read_available()
+    {
+      std::string rv;
+      int flags = fcntl(fds[0], F_GETFL);
+      fcntl(fds[0], F_SETFL, flags | O_NONBLOCK);
+      char buff[4096];
+      ssize_t n;
+      while ((n = read(fds[0], buff, sizeof(buff))) > 0)
+        {
+          rv.append(buff, size_t(n));
+        }
+      fcntl(fds[0], F_SETFL, flags);
+      return rv;
+    }
+    crpcut::output::heap_buffer   buffer;
+    crpcut::output::heap_buffer   summary_buffer;
+    crpcut::output::nil_formatter fmt;
+    crpcut::registrator_list      reg;
+    crpcut::journal::entry_list   completed;
+    crpcut::inline_presentation   presentation;
+  };
+
+  TEST(output_fd_is_non_blocking_while_presenting, fix)
+  {
+    ASSERT_TRUE((fcntl(fds[1], F_GETFL) & O_NONBLOCK) != 0);
+  }
+
+  TEST(output_fd_is_restored_when_presentation_ends)
+  {
+    int fds[2];
+    ASSERT_TRUE(pipe(fds) == 0);
+    {
+      crpcut::output::heap_buffer   buffer;
+      crpcut::output::nil_formatter fmt(buffer, "", 0,
+                                        crpcut::tag_list::obj(), 0, 0);
+      crpcut::registrator_list      reg;
+      crpcut::journal::entry_list   completed;
+      crpcut::inline_presentation   p(buffer, fmt, fds[1],
+                                      buffer, fmt, -1,
+                                      false, "", reg, 0, completed);
+    }
+    ASSERT_TRUE((fcntl(fds[1], F_GETFL) & O_NONBLOCK) == 0);
+    close(fds[0]);
+    close(fds[1]);
+  }
+
+  TEST(all_output_is_written_when_there_is_room, fix)
+  {
+    fill(buffer, "apa katt");
+    ASSERT_TRUE(presentation.write_output());
+    ASSERT_TRUE(buffer.is_empty());
+    ASSERT_TRUE(read_available() == "apa katt");
+  }
+
+  TEST(output_is_kept_when_the_pipe_is_full, fix)
+  {
+    const std::string data(1024*1024, 'x');
+    fill(buffer, data);
+    ASSERT_FALSE(presentation.write_output());
+    ASSERT_FALSE(buffer.is_empty());
+    std::string written;
+    do
+      {
+        written += read_available();
+      }
+    while (!presentation.write_output());
+    written += read_available();
+    ASSERT_TRUE(written == data);
+  }
+
+  TEST(summary_without_fd_is_discarded, fix)
+  {
+    fill(summary_buffer, "apa");
+    ASSERT_TRUE(presentation.write_output());
+    ASSERT_TRUE(summary_buffer.is_empty());
+    ASSERT_TRUE(read_available().empty());
+  }
+}
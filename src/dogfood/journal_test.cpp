@@ -0,0 +1,263 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include "../journal.hpp"
+#include "../output/formatter.hpp"
+#include <sstream>
+extern "C" {
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/stat.h>
+}
+
+namespace {
+  class recording_formatter : public crpcut::output::formatter
+  {
+  public:
+    virtual void begin_case(std::string   name,
+                            bool          result,
+                            bool          critical,
+                            unsigned long duration_us)
+    {
+      os << "begin " << name << ' ' << result << ' ' << critical
+         << ' ' << duration_us << '\n';
+    }
+    virtual void end_case()
+    {
+      os << "end\n";
+    }
+    virtual void terminate(crpcut::test_phase              phase,
+                           crpcut::datatypes::fixed_string msg,
+                           crpcut::datatypes::fixed_string location,
+                           std::string                     dirname)
+    {
+      os << "terminate " << phase << ' ' << msg << ' ' << location
+         << ' ' << dirname << '\n';
+    }
+    virtual void print(crpcut::datatypes::fixed_string label,
+                       crpcut::datatypes::fixed_string data,
+                       crpcut::datatypes::fixed_string location)
+    {
+      os << "print " << label << ' ' << data << ' ' << location << '\n';
+    }
+    virtual void metric(crpcut::datatypes::fixed_string name,
+                        crpcut::datatypes::fixed_string value)
+    {
+      os << "metric " << name << ' ' << value << '\n';
+    }
+    virtual void statistics(unsigned, unsigned) {}
+    virtual void nonempty_dir(const char*) {}
+    virtual void blocked_test(crpcut::tag::importance, std::string) {}
+    std::ostringstream os;
+  };
+
+  using crpcut::datatypes::fixed_string;
+
+  int create(const char *name)
+  {
+    int fd = ::open(name, O_CREAT | O_WRONLY | O_TRUNC, 0666);
+    ASSERT_TRUE(fd >= 0);
+    return fd;
+  }
+
+  void write_two_cases(crpcut::journal &j)
+  {
+    j.begin_case("suite::passed", true, true, 100UL);
+    j.end_case();
+    j.begin_case("suite::failed", false, false, 2000UL);
+    j.print(fixed_string::make("info"),
+            fixed_string::make("some info"),
+            fixed_string::make("apa.cpp:3"));
+    j.terminate(crpcut::running,
+                fixed_string::make("failed"),
+                fixed_string::make("apa.cpp:4"),
+                "/tmp/dir/suite::failed");
+    j.metric(fixed_string::make("cgroup.cpu_us"), fixed_string::make("1234"));
+    j.end_case();
+  }
+
+  struct journal_files
+  {
+    ~journal_files()
+    {
+      ::unlink("log");
+      ::unlink("log2");
+    }
+  };
+
+  void delete_all(crpcut::journal::entry_list &entries)
+  {
+    while (crpcut::journal::entry *e = entries.first()) delete e;
+  }
+}
+
+TESTSUITE(journal)
+{
+  TEST(recorded_cases_are_replayed_as_recorded, journal_files)
+  {
+    {
+      crpcut::journal j(create("log"), 1U, false);
+      write_two_cases(j);
+    }
+    crpcut::journal::entry_list entries;
+    ASSERT_GT(crpcut::journal::load("log", entries), 0L);
+    crpcut::journal::entry *e = entries.first();
+    ASSERT_TRUE(e);
+    ASSERT_TRUE(e->name() == "suite::passed");
+    ASSERT_TRUE(e->result());
+    recording_formatter fmt;
+    e->replay(fmt);
+    e = entries.next_after(e);
+    ASSERT_TRUE(e);
+    ASSERT_TRUE(e->name() == "suite::failed");
+    ASSERT_FALSE(e->result());
+    e->replay(fmt);
+    ASSERT_FALSE(entries.next_after(e));
+    ASSERT_TRUE(fmt.os.str() ==
+                "begin suite::passed 1 1 100\n"
+                "end\n"
+                "begin suite::failed 0 0 2000\n"
+                "print info some info apa.cpp:3\n"
+                "terminate 1 failed apa.cpp:4 /tmp/dir/suite::failed\n"
+                "metric cgroup.cpu_us 1234\n"
+                "end\n");
+    delete_all(entries);
+  }
+
+  TEST(torn_record_is_ignored, journal_files)
+  {
+    {
+      crpcut::journal j(create("log"), 1U, false);
+      write_two_cases(j);
+    }
+    struct stat st;
+    ASSERT_FALSE(::stat("log", &st));
+    ASSERT_FALSE(::truncate("log", st.st_size - 3));
+    crpcut::journal::entry_list entries;
+    long len = crpcut::journal::load("log", entries);
+    ASSERT_GT(len, 0L);
+    ASSERT_LT(len, long(st.st_size - 3));
+    crpcut::journal::entry *e = entries.first();
+    ASSERT_TRUE(e);
+    ASSERT_TRUE(e->name() == "suite::passed");
+    ASSERT_FALSE(entries.next_after(e));
+    delete_all(entries);
+  }
+
+  TEST(corrupt_record_is_ignored, journal_files)
+  {
+    {
+      crpcut::journal j(create("log"), 1U, false);
+      write_two_cases(j);
+    }
+    struct stat st;
+    ASSERT_FALSE(::stat("log", &st));
+    int fd = ::open("log", O_WRONLY);
+    ASSERT_TRUE(fd >= 0);
+    ASSERT_TRUE(::pwrite(fd, "X", 1, st.st_size - 1) == 1);
+    ::close(fd);
+    crpcut::journal::entry_list entries;
+    ASSERT_GT(crpcut::journal::load("log", entries), 0L);
+    crpcut::journal::entry *e = entries.first();
+    ASSERT_TRUE(e);
+    ASSERT_FALSE(entries.next_after(e));
+    delete_all(entries);
+  }
+
+  TEST(file_that_is_not_a_journal_cannot_be_loaded, journal_files)
+  {
+    int fd = create("log");
+    ASSERT_TRUE(::write(fd, "<?xml version=\"1.0\"?>\n", 22) == 22);
+    ::close(fd);
+    crpcut::journal::entry_list entries;
+    ASSERT_LT(crpcut::journal::load("log", entries), 0L);
+    ASSERT_TRUE(entries.is_empty());
+  }
+
+  TEST(missing_journal_cannot_be_loaded)
+  {
+    crpcut::journal::entry_list entries;
+    ASSERT_LT(crpcut::journal::load("nonexisting", entries), 0L);
+  }
+
+  TEST(replayed_entries_are_appended_to_a_new_journal, journal_files)
+  {
+    {
+      crpcut::journal j(create("log"), 1U, false);
+      write_two_cases(j);
+    }
+    crpcut::journal::entry_list entries;
+    ASSERT_GT(crpcut::journal::load("log", entries), 0L);
+    {
+      crpcut::journal j(create("log2"), 5U, false);
+      for (crpcut::journal::entry *e = entries.first();
+           e;
+           e = entries.next_after(e))
+        {
+          j.append(*e);
+        }
+    }
+    delete_all(entries);
+    ASSERT_GT(crpcut::journal::load("log2", entries), 0L);
+    ASSERT_TRUE(entries.first());
+    ASSERT_TRUE(entries.first()->name() == "suite::passed");
+    ASSERT_TRUE(entries.last()->name() == "suite::failed");
+    delete_all(entries);
+  }
+
+  TEST(replayed_entries_are_not_appended_to_a_continued_journal, journal_files)
+  {
+    {
+      crpcut::journal j(create("log"), 1U, false);
+      write_two_cases(j);
+    }
+    crpcut::journal::entry_list entries;
+    long len = crpcut::journal::load("log", entries);
+    ASSERT_GT(len, 0L);
+    {
+      crpcut::journal j(::open("log", O_WRONLY | O_APPEND), 1U, true);
+      for (crpcut::journal::entry *e = entries.first();
+           e;
+           e = entries.next_after(e))
+        {
+          j.append(*e);
+        }
+      j.begin_case("suite::third", true, true, 1UL);
+      j.end_case();
+    }
+    delete_all(entries);
+    ASSERT_GT(crpcut::journal::load("log", entries), len);
+    crpcut::journal::entry *e = entries.first();
+    ASSERT_TRUE(e->name() == "suite::passed");
+    e = entries.next_after(e);
+    ASSERT_TRUE(e->name() == "suite::failed");
+    e = entries.next_after(e);
+    ASSERT_TRUE(e->name() == "suite::third");
+    ASSERT_FALSE(entries.next_after(e));
+    delete_all(entries);
+  }
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include "../../output/pooled_buffer.hpp"
+#include <string>
+
+namespace {
+  void fill(crpcut::output::buffer &b, const std::string &s)
+  {
+    size_t bytes_written = 0;
+    while (bytes_written < s.length())
+      {
+        ssize_t rv = b.write(s.c_str() + bytes_written,
+                             s.length() - bytes_written);
+        ASSERT_TRUE(rv > 0);
+        bytes_written += size_t(rv);
+      }
+  }
+
+  std::string pattern(std::size_t len)
+  {
+    static const char data[] = "abcdefghijklmnopqrstuvwxyz12345";
+    std::string s;
+    while (s.length() < len)
+      {
+        s.append(data, std::min(len - s.length(), sizeof(data) - 1));
+      }
+    return s;
+  }
+}
+
+TESTSUITE(output)
+{
+  TESTSUITE(pooled_buffer)
+  {
+    using crpcut::output::pooled_buffer;
+    static const std::size_t segment_size = pooled_buffer::segment_size;
+
+    TEST(default_constructed_buffer_is_empty)
+    {
+      pooled_buffer b;
+      ASSERT_TRUE(b.is_empty());
+      std::pair<const char*, std::size_t> r = b.get_buffer();
+      static const char *const zerostr = 0;
+      ASSERT_TRUE(r.first == zerostr);
+      ASSERT_TRUE(r.second == 0U);
+      struct iovec v[4];
+      ASSERT_TRUE(b.get_buffers(v, 4) == 0U);
+      b.advance();
+    }
+
+    TEST(all_segments_are_presented_in_order)
+    {
+      pooled_buffer b;
+      const std::string s = pattern(segment_size * 2 + 100);
+      fill(b, s);
+      struct iovec v[4];
+      ASSERT_TRUE(b.get_buffers(v, 4) == 3U);
+      ASSERT_TRUE(v[0].iov_len == segment_size);
+      ASSERT_TRUE(v[1].iov_len == segment_size);
+      ASSERT_TRUE(v[2].iov_len == 100U);
+      std::string read;
+      for (int i = 0; i < 3; ++i)
+        {
+          read.append(static_cast<const char*>(v[i].iov_base), v[i].iov_len);
+        }
+      ASSERT_TRUE(read == s);
+    }
+
+    TEST(no_more_segments_than_asked_for_are_presented)
+    {
+      pooled_buffer b;
+      fill(b, pattern(segment_size * 2 + 100));
+      struct iovec v[2];
+      ASSERT_TRUE(b.get_buffers(v, 2) == 2U);
+    }
+
+    TEST(first_segment_is_the_buffer)
+    {
+      pooled_buffer b;
+      fill(b, pattern(segment_size + 1));
+      std::pair<const char*, std::size_t> r = b.get_buffer();
+      struct iovec v[1];
+      ASSERT_TRUE(b.get_buffers(v, 1) == 1U);
+      ASSERT_TRUE(v[0].iov_base == r.first);
+      ASSERT_TRUE(v[0].iov_len == r.second);
+    }
+
+    TEST(advancing_past_all_segments_empties_the_buffer)
+    {
+      pooled_buffer b;
+      fill(b, pattern(segment_size + 1));
+      b.advance();
+      ASSERT_FALSE(b.is_empty());
+      ASSERT_TRUE(b.get_buffer().second == 1U);
+      b.advance();
+      ASSERT_TRUE(b.is_empty());
+    }
+
+    TEST(written_segments_are_reused)
+    {
+      pooled_buffer b;
+      fill(b, pattern(10));
+      const char *first = b.get_buffer().first;
+      b.advance();
+      fill(b, "apa");
+      ASSERT_TRUE(b.get_buffer().first == first);
+      ASSERT_TRUE(std::string(b.get_buffer().first, 3) == "apa");
+    }
+
+    TEST(data_written_after_the_tail_was_advanced_past_is_kept)
+    {
+      pooled_buffer b;
+      fill(b, "apa");
+      b.advance();
+      ASSERT_TRUE(b.is_empty());
+      fill(b, "katt");
+      std::pair<const char*, std::size_t> r = b.get_buffer();
+      ASSERT_TRUE(std::string(r.first, r.second) == "katt");
+    }
+
+    TEST(destructor_cleans_memory)
+    {
+      ASSERT_SCOPE_HEAP_LEAK_FREE
+        {
+          pooled_buffer b;
+          fill(b, pattern(segment_size * 3));
+          b.advance();
+        }
+    }
+  }
+}
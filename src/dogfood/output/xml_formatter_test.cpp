@@ -291,6 +291,54 @@ TESTSUITE(output)
                   test_buffer.os.str());
     }
 
+    TEST(run_summary_follows_blocked_tests_list, fix)
+    {
+      mock::stream_buffer test_buffer;
+      {
+        crpcut::output::xml_formatter obj(test_buffer,
+                                          "one",
+                                          vec,
+                                          tags,
+                                          3,3);
+        crpcut::run_statistics stats(2, 2U);
+        stats.begin_test(100);
+        stats.begin_test(100);
+        stats.end_test(300, "apa::katt", "", 150, 120);
+        stats.end_test(400, "apa::ko", "slow", 250, 200);
+        obj.blocked_test(crpcut::tag::critical, "orm");
+        obj.summary(stats);
+        obj.statistics(2,0);
+      }
+      static const char re[] =
+        XML_HEADER
+        XML_BLOCKED_LIST(orm, critical)
+        _ "<run_summary"
+        S "wall_time_us" _ "=" _ "\"300\""
+        S "cpu_time_us" _ "=" _ "\"320\""
+        S "slots" _ "=" _ "\"2\""
+        S "busy_slot_us" _ "=" _ "\"500\""
+        S "dependency_idle_slot_us" _ "=" _ "\"0\""
+        S "other_idle_slot_us" _ "=" _ "\"100\"" _ ">"
+        XML_FIELD_TAG_PAIR(slowest_test, name, apa::ko, duration_us, 250)
+        XML_FIELD_TAG_PAIR(slowest_test, name, apa::katt, duration_us, 150)
+        _ "<suite" S "name" _ "=" _ "\"apa\"" S "count" _ "=" _ "\"2\""
+        S "p50_us" _ "=" _ "\"150\"" S "p90_us" _ "=" _ "\"250\""
+        S "max_us" _ "=" _ "\"250\"" _ "/>"
+        _ "<tag" S "name" _ "=" _ "\"slow\"" S "count" _ "=" _ "\"1\""
+        S "p50_us" _ "=" _ "\"250\"" S "p90_us" _ "=" _ "\"250\""
+        S "max_us" _ "=" _ "\"250\"" _ "/>"
+        _ "</run_summary>"
+        XML_STATISTICS(3,3,1,2,0,0)
+        XML_TRAILER
+        ;
+
+      INFO << re;
+      ASSERT_PRED(crpcut::match<crpcut::regex>(re,
+                                               crpcut::regex::e,
+                                               crpcut::regex::m),
+                  test_buffer.os.str());
+    }
+
 #define MAKE_TAG(n, obj) mock::test_tag n(#n, &obj)
 #define XML_TAG_ENTRY(name, p, f, c) \
     _ "<tag" S "name" _ "=" _ "\"" #name "\""                           \
@@ -571,5 +619,79 @@ TESTSUITE(output)
                   test_buffer.os.str());
 
     }
+
+    TEST(metrics_follow_log, fix)
+    {
+      mock::stream_buffer test_buffer;
+      {
+        crpcut::output::xml_formatter obj(test_buffer,
+                                          "one",
+                                          vec,
+                                          tags,
+                                          0,0);
+        obj.begin_case("tupp", true, true, 100);
+        obj.print(s(stderr), s(ehepp), s());
+        obj.metric(s(cgroup.cpu_us), s(1234));
+        obj.metric(s(cgroup.memory_peak_bytes), s(4096));
+        obj.end_case();
+        obj.statistics(0,0);
+      }
+      static const char re[] =
+        XML_HEADER
+        XML_OPEN_TEST(tupp, true, 100, PASSED)
+        _ "<log>"
+        _ XML_DATA_FIELD(stderr, ehepp)
+        _ "</log>"
+        _ "<metrics>"
+        _ "<metric" S "name" _ "=" _ "\"cgroup\\.cpu_us\""
+        S "value" _ "=" _ "\"1234\"" _ "/>"
+        _ "<metric" S "name" _ "=" _ "\"cgroup\\.memory_peak_bytes\""
+        S "value" _ "=" _ "\"4096\"" _ "/>"
+        _ "</metrics>"
+        _ "</test>"
+        XML_STATISTICS(0,0,0,0,0,0)
+        XML_TRAILER
+        ;
+      INFO << re;
+      ASSERT_PRED(crpcut::match<crpcut::regex>(re,
+                                               crpcut::regex::e,
+                                               crpcut::regex::m),
+                  test_buffer.os.str());
+    }
+
+    TEST(metrics_without_log_open_the_test, fix)
+    {
+      mock::stream_buffer test_buffer;
+      {
+        crpcut::output::xml_formatter obj(test_buffer,
+                                          "one",
+                                          vec,
+                                          tags,
+                                          0,0);
+        obj.begin_case("tupp", true, true, 100);
+        obj.metric(s(cgroup.cpu_us), s(1234));
+        obj.end_case();
+        obj.begin_case("lemur", true, true, 100);
+        obj.end_case();
+        obj.statistics(0,0);
+      }
+      static const char re[] =
+        XML_HEADER
+        XML_OPEN_TEST(tupp, true, 100, PASSED)
+        _ "<metrics>"
+        _ "<metric" S "name" _ "=" _ "\"cgroup\\.cpu_us\""
+        S "value" _ "=" _ "\"1234\"" _ "/>"
+        _ "</metrics>"
+        _ "</test>"
+        XML_CLOSED_TEST(lemur, true, 100, PASSED)
+        XML_STATISTICS(0,0,0,0,0,0)
+        XML_TRAILER
+        ;
+      INFO << re;
+      ASSERT_PRED(crpcut::match<crpcut::regex>(re,
+                                               crpcut::regex::e,
+                                               crpcut::regex::m),
+                  test_buffer.os.str());
+    }
   }
 }
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../output_cap.hpp"
+#include <crpcut.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+extern "C" {
+#  include <unistd.h>
+}
+
+TESTSUITE(output_cap)
+{
+  class presented_output : public crpcut::crpcut_test_monitor
+  {
+  public:
+    virtual void set_timeout(unsigned long) {}
+    virtual unsigned long duration_us() const { return 0; }
+    virtual bool deadline_is_set() const { return false; }
+    virtual void clear_deadline() {}
+    virtual void crpcut_register_success(bool) {}
+    virtual void set_phase(crpcut::test_phase) {}
+    virtual void kill() {}
+    virtual bool crpcut_failed() const { return false; }
+    virtual void set_cputime_at_start(const struct timeval&) {}
+    virtual void send_to_presentation(crpcut::comm::type t,
+                                      size_t             len,
+                                      const char        *buff) const
+    {
+      types.push_back(t);
+      msgs.push_back(std::string(buff, len));
+    }
+    virtual void set_death_note() {}
+    virtual void activate_reader() {}
+    virtual void deactivate_reader() {}
+    virtual bool has_active_readers() const { return false; }
+    virtual void manage_death() {}
+    virtual bool is_naughty_child() const { return false; }
+    virtual void freeze() const {}
+    virtual crpcut::datatypes::fixed_string get_location() const
+    {
+      return crpcut::datatypes::fixed_string::make("");
+    }
+    mutable std::vector<crpcut::comm::type> types;
+    mutable std::vector<std::string>        msgs;
+  };
+
+  std::string with_location(const std::string &location,
+                            const std::string &msg)
+  {
+    std::size_t len = location.length();
+    return std::string(reinterpret_cast<const char*>(&len), sizeof(len))
+      + location + msg;
+  }
+
+  std::string file_contents(const char *name)
+  {
+    std::ifstream is(name);
+    std::ostringstream os;
+    os << is.rdbuf();
+    return os.str();
+  }
+
+  TEST(output_below_the_limit_is_passed_on_as_is)
+  {
+    crpcut::output_cap cap(10, "apa");
+    std::size_t len = 5;
+    ASSERT_TRUE(cap.admit(crpcut::comm::stdout, len, "katt\n"));
+    ASSERT_TRUE(len == 5U);
+    presented_output mon;
+    cap.present(mon);
+    ASSERT_TRUE(mon.msgs.empty());
+  }
+
+  TEST(other_messages_are_not_limited)
+  {
+    crpcut::output_cap cap(1, "apa");
+    std::size_t len = 0;
+    ASSERT_TRUE(cap.admit(crpcut::comm::exit_ok, len, ""));
+    len = 4;
+    ASSERT_TRUE(cap.admit(crpcut::comm::fail, len, "apa!"));
+    ASSERT_TRUE(len == 4U);
+  }
+
+  TEST(beginning_and_end_of_long_output_is_kept_and_all_is_in_file)
+  {
+    crpcut::output_cap cap(8, "apa");
+    std::size_t len = 3;
+    ASSERT_TRUE(cap.admit(crpcut::comm::stdout, len, "012"));
+    ASSERT_TRUE(len == 3U);
+    len = 4;
+    ASSERT_TRUE(cap.admit(crpcut::comm::stdout, len, "3456"));
+    ASSERT_TRUE(len == 1U);
+    len = 5;
+    ASSERT_FALSE(cap.admit(crpcut::comm::stdout, len, "789ab"));
+    presented_output mon;
+    cap.present(mon);
+    ASSERT_TRUE(mon.msgs.size() == 2U);
+    ASSERT_TRUE(mon.types[0] == crpcut::comm::truncated);
+    ASSERT_TRUE(mon.msgs[0].find("4 bytes left out") != std::string::npos);
+    ASSERT_TRUE(mon.types[1] == crpcut::comm::stdout);
+    ASSERT_TRUE(mon.msgs[1] == "89ab");
+    ASSERT_TRUE(file_contents("apa.stdout") == "0123456789ab");
+    ASSERT_TRUE(unlink("apa.stdout") == 0);
+  }
+
+  TEST(info_messages_are_kept_whole)
+  {
+    crpcut::output_cap cap(40, "apa");
+    const std::string first = with_location("a.cpp:1", "first");
+    const std::string second = with_location("a.cpp:2", "second");
+    const std::string third = with_location("a.cpp:3", "third");
+    std::size_t len = first.length();
+    ASSERT_TRUE(cap.admit(crpcut::comm::info, len, first.c_str()));
+    len = second.length();
+    ASSERT_FALSE(cap.admit(crpcut::comm::info, len, second.c_str()));
+    len = third.length();
+    ASSERT_FALSE(cap.admit(crpcut::comm::info, len, third.c_str()));
+    presented_output mon;
+    cap.present(mon);
+    ASSERT_TRUE(mon.msgs.size() == 2U);
+    ASSERT_TRUE(mon.types[0] == crpcut::comm::truncated);
+    ASSERT_TRUE(mon.types[1] == crpcut::comm::info);
+    ASSERT_TRUE(mon.msgs[1] == third);
+    ASSERT_TRUE(file_contents("apa.info")
+                == "a.cpp:1\nfirst\na.cpp:2\nsecond\na.cpp:3\nthird\n");
+    ASSERT_TRUE(unlink("apa.info") == 0);
+  }
+
+  TEST(streams_are_limited_separately)
+  {
+    crpcut::output_cap cap(4, "apa");
+    std::size_t len = 2;
+    ASSERT_TRUE(cap.admit(crpcut::comm::stdout, len, "ab"));
+    len = 2;
+    ASSERT_TRUE(cap.admit(crpcut::comm::stderr, len, "cd"));
+    presented_output mon;
+    cap.present(mon);
+    ASSERT_TRUE(mon.msgs.empty());
+  }
+}
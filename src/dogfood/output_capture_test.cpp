@@ -0,0 +1,130 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../output_capture.hpp"
+#include <crpcut.hpp>
+#include <string>
+extern "C" {
+#  include <sys/wait.h>
+#  include <unistd.h>
+}
+
+TESTSUITE(output_capture)
+{
+  class presented_output : public crpcut::crpcut_test_monitor
+  {
+  public:
+    virtual void set_timeout(unsigned long) {}
+    virtual unsigned long duration_us() const { return 0; }
+    virtual bool deadline_is_set() const { return false; }
+    virtual void clear_deadline() {}
+    virtual void crpcut_register_success(bool) {}
+    virtual void set_phase(crpcut::test_phase) {}
+    virtual void kill() {}
+    virtual bool crpcut_failed() const { return false; }
+    virtual void set_cputime_at_start(const struct timeval&) {}
+    virtual void send_to_presentation(crpcut::comm::type t,
+                                      size_t             len,
+                                      const char        *buff) const
+    {
+      std::string &s = t == crpcut::comm::stdout ? out : err;
+      s.append(buff, len);
+      ++messages;
+    }
+    virtual void set_death_note() {}
+    virtual void activate_reader() {}
+    virtual void deactivate_reader() {}
+    virtual bool has_active_readers() const { return false; }
+    virtual void manage_death() {}
+    virtual bool is_naughty_child() const { return false; }
+    virtual void freeze() const {}
+    virtual crpcut::datatypes::fixed_string get_location() const
+    {
+      return crpcut::datatypes::fixed_string::make("");
+    }
+    presented_output() : messages(0) {}
+    mutable std::string out;
+    mutable std::string err;
+    mutable unsigned    messages;
+  };
+
+  TEST(nothing_is_presented_if_nothing_is_written)
+  {
+    crpcut::output_capture capture;
+    presented_output mon;
+    capture.present(mon);
+    ASSERT_TRUE(mon.messages == 0U);
+  }
+
+  TEST(stdout_and_stderr_are_presented_separately)
+  {
+    crpcut::output_capture capture;
+    int out = capture.fd(crpcut::comm::stdout);
+    int err = capture.fd(crpcut::comm::stderr);
+    ASSERT_TRUE(out != err);
+    ASSERT_TRUE(write(out, "apa", 3) == 3);
+    ASSERT_TRUE(write(err, "katt", 4) == 4);
+    ASSERT_TRUE(write(out, "lemur", 5) == 5);
+    presented_output mon;
+    capture.present(mon);
+    ASSERT_TRUE(mon.out == "apalemur");
+    ASSERT_TRUE(mon.err == "katt");
+  }
+
+  TEST(output_written_by_a_dup_in_a_child_process_is_presented)
+  {
+    crpcut::output_capture capture;
+    pid_t pid = fork();
+    ASSERT_TRUE(pid >= 0);
+    if (pid == 0)
+      {
+        dup2(capture.fd(crpcut::comm::stdout), 1);
+        static const char msg[] = "written by child\n";
+        ssize_t rv = write(1, msg, sizeof(msg) - 1);
+        _exit(rv == sizeof(msg) - 1 ? 0 : 1);
+      }
+    int status;
+    ASSERT_TRUE(waitpid(pid, &status, 0) == pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_TRUE(WEXITSTATUS(status) == 0);
+    presented_output mon;
+    capture.present(mon);
+    ASSERT_TRUE(mon.out == "written by child\n");
+    ASSERT_TRUE(mon.err.empty());
+  }
+
+  TEST(large_output_is_presented_in_chunks)
+  {
+    crpcut::output_capture capture;
+    const std::string msg(200000, 'x');
+    int out = capture.fd(crpcut::comm::stdout);
+    ASSERT_TRUE(write(out, msg.c_str(), msg.length()) == ssize_t(msg.length()));
+    presented_output mon;
+    capture.present(mon);
+    ASSERT_TRUE(mon.out == msg);
+    ASSERT_TRUE(mon.messages > 1U);
+  }
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../packet_writer.hpp"
+#include "../pipe_pair.hpp"
+#include <crpcut.hpp>
+#include <string>
+extern "C" {
+#  include <sys/socket.h>
+#  include <unistd.h>
+}
+
+TESTSUITE(packet_writer)
+{
+  class socket_fds
+  {
+  protected:
+    socket_fds()
+    {
+      int rv = socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds);
+      assert(rv == 0);
+    }
+    ~socket_fds()
+    {
+      close(fds[0]);
+    }
+    int fds[2];
+  };
+
+  class fix : protected socket_fds
+  {
+  protected:
+    fix() : socket_fds(), reader(fds[0]), writer(fds[1]) {}
+    int                   reader;
+    crpcut::packet_writer writer;
+  };
+
+  TEST(pipe_pair_of_packets_is_a_seqpacket_socket)
+  {
+    crpcut::pipe_pair pipes("packet_writer_test", crpcut::pipe_pair::packets);
+    ASSERT_TRUE(pipes.get_kind() == crpcut::pipe_pair::packets);
+    int fd = pipes.for_reading();
+    int type = 0;
+    socklen_t len = sizeof(type);
+    ASSERT_TRUE(getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) == 0);
+    ASSERT_TRUE(type == SOCK_SEQPACKET);
+  }
+
+  TEST(each_write_is_received_whole_by_one_read, fix)
+  {
+    writer.write_loop("apa", 3);
+    writer.write_loop("katt", 4);
+    char buff[16];
+    ASSERT_TRUE(recv(reader, buff, sizeof(buff), 0) == 3);
+    ASSERT_TRUE(std::string(buff, 3) == "apa");
+    ASSERT_TRUE(recv(reader, buff, sizeof(buff), 0) == 4);
+    ASSERT_TRUE(std::string(buff, 4) == "katt");
+  }
+
+  TEST(large_write_is_split_into_packets_of_max_size, fix)
+  {
+    const size_t max = crpcut::packet_writer::max_packet;
+    const std::string msg(max + 10, 'x');
+    writer.write_loop(msg.c_str(), msg.length());
+    std::string buff(max * 2, '\0');
+    ASSERT_TRUE(recv(reader, &buff[0], buff.length(), 0) == ssize_t(max));
+    ASSERT_TRUE(recv(reader, &buff[0], buff.length(), 0) == 10);
+  }
+
+  TEST(frames_are_as_large_as_a_packet, fix)
+  {
+    ASSERT_TRUE(writer.max_frame() == crpcut::packet_writer::max_packet);
+  }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../presentation_pipe.hpp"
+#include <crpcut.hpp>
+#include <string>
+extern "C" {
+#  include <fcntl.h>
+#  include <unistd.h>
+}
+
+TESTSUITE(presentation_pipe)
+{
+  static const size_t header_size = crpcut::presentation_pipe::header_size;
+
+  class pipe_fds
+  {
+  protected:
+    pipe_fds()
+    {
+      int rv = pipe(fds);
+      assert(rv == 0);
+    }
+    int fds[2];
+  };
+
+  class fix : private pipe_fds
+  {
+  protected:
+    fix()
+      : pipe_fds(),
+        reader(fds[0]),
+        writer(fds[1])
+    {
+      int rv = fcntl(reader.fd(), F_SETFL, O_NONBLOCK);
+      assert(rv == 0);
+    }
+    std::string read_all()
+    {
+      std::string rv;
+      char buff[4096];
+      ssize_t n;
+      while ((n = reader.read(buff, sizeof(buff))) > 0)
+        {
+          rv.append(buff, size_t(n));
+        }
+      return rv;
+    }
+    class nb_reader : public crpcut::comm::rfile_descriptor
+    {
+    public:
+      nb_reader(int n) : crpcut::comm::rfile_descriptor(n) {}
+      int fd() const { return get_fd(); }
+    };
+    nb_reader                 reader;
+    crpcut::presentation_pipe writer;
+  };
+
+  TEST(decoded_header_is_what_was_encoded)
+  {
+    char buff[header_size];
+    crpcut::presentation_pipe::encode_header(buff, 3141,
+                                             crpcut::comm::info,
+                                             crpcut::destroying,
+                                             2718);
+    pid_t pid = 0;
+    crpcut::comm::type t = crpcut::comm::stdout;
+    crpcut::test_phase phase = crpcut::running;
+    size_t len = crpcut::presentation_pipe::decode_header(buff, pid, t, phase);
+    ASSERT_TRUE(pid == 3141);
+    ASSERT_TRUE(t == crpcut::comm::info);
+    ASSERT_TRUE(phase == crpcut::destroying);
+    ASSERT_TRUE(len == 2718U);
+  }
+
+  TEST(small_frames_are_held_until_flushed, fix)
+  {
+    writer.write_frame(1, crpcut::comm::stdout, crpcut::running, 3, "abc");
+    writer.write_frame(2, crpcut::comm::stderr, crpcut::running, 0, 0);
+    ASSERT_TRUE(read_all().empty());
+    writer.flush();
+    std::string data = read_all();
+    ASSERT_TRUE(data.length() == 2 * header_size + 3);
+    pid_t pid;
+    crpcut::comm::type t;
+    crpcut::test_phase phase;
+    size_t len = crpcut::presentation_pipe::decode_header(data.c_str(),
+                                                          pid, t, phase);
+    ASSERT_TRUE(pid == 1);
+    ASSERT_TRUE(t == crpcut::comm::stdout);
+    ASSERT_TRUE(len == 3U);
+    ASSERT_TRUE(data.substr(header_size, len) == "abc");
+    len = crpcut::presentation_pipe::decode_header(data.c_str()
+                                                   + header_size + 3,
+                                                   pid, t, phase);
+    ASSERT_TRUE(pid == 2);
+    ASSERT_TRUE(t == crpcut::comm::stderr);
+    ASSERT_TRUE(len == 0U);
+  }
+
+  TEST(large_frame_is_written_after_pending_frames, fix)
+  {
+    writer.write_frame(1, crpcut::comm::info, crpcut::running, 3, "abc");
+    const std::string large(20000, 'x');
+    writer.write_frame(2, crpcut::comm::stdout, crpcut::running,
+                       large.length(), large.c_str());
+    std::string data = read_all();
+    ASSERT_TRUE(data.length() == 2 * header_size + 3 + large.length());
+    pid_t pid;
+    crpcut::comm::type t;
+    crpcut::test_phase phase;
+    size_t len = crpcut::presentation_pipe::decode_header(data.c_str(),
+                                                          pid, t, phase);
+    ASSERT_TRUE(pid == 1);
+    ASSERT_TRUE(len == 3U);
+    len = crpcut::presentation_pipe::decode_header(data.c_str()
+                                                   + header_size + 3,
+                                                   pid, t, phase);
+    ASSERT_TRUE(pid == 2);
+    ASSERT_TRUE(len == large.length());
+    ASSERT_TRUE(data.substr(2 * header_size + 3) == large);
+    writer.flush();
+    ASSERT_TRUE(read_all().empty());
+  }
+}
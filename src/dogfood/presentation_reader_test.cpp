@@ -179,6 +179,12 @@ TESTSUITE(presentation_reader)
     {
       print(std::string(s1.str, s1.len), std::string(s2.str, s2.len), std::string(s3.str, s3.len));
     }
+    MAKE_MOCK2(metric, void(std::string, std::string));
+    void metric(crpcut::datatypes::fixed_string name,
+                crpcut::datatypes::fixed_string value)
+    {
+      metric(std::string(name.str, name.len), std::string(value.str, value.len));
+    }
     MAKE_MOCK2(statistics, void(unsigned, unsigned));
     MAKE_MOCK1(nonempty_dir, void(const char*));
     MAKE_MOCK2(blocked_test, void(crpcut::tag::importance,
@@ -44,6 +44,8 @@ TESTSUITE(printer)
     MAKE_MOCK3(print, void(crpcut::datatypes::fixed_string,
                            crpcut::datatypes::fixed_string,
                            crpcut::datatypes::fixed_string));
+    MAKE_MOCK2(metric, void(crpcut::datatypes::fixed_string,
+                            crpcut::datatypes::fixed_string));
     MAKE_MOCK2(statistics, void(unsigned, unsigned));
     MAKE_MOCK1(nonempty_dir, void(const char*));
     MAKE_MOCK2(blocked_test,
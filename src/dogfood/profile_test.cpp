@@ -0,0 +1,124 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../profile.hpp"
+#include <crpcut.hpp>
+#include <sstream>
+#include <string>
+extern "C" {
+#  include <sys/resource.h>
+#  include <pthread.h>
+}
+
+namespace {
+  void spin_until_cputime_us(long us)
+  {
+    volatile unsigned long n = 0;
+    for (;;)
+      {
+        for (int i = 0; i < 100000; ++i) n = n + 1;
+        struct rusage usage;
+        ::getrusage(RUSAGE_SELF, &usage);
+        if (usage.ru_utime.tv_sec || usage.ru_utime.tv_usec > us) break;
+      }
+  }
+
+  extern "C" void *spin_thread(void *)
+  {
+    spin_until_cputime_us(200000);
+    return 0;
+  }
+
+  unsigned long total_samples(const std::string &folded)
+  {
+    std::istringstream is(folded);
+    std::string line;
+    unsigned long total = 0;
+    while (std::getline(is, line))
+      {
+        const std::string::size_type pos = line.rfind(' ');
+        if (pos == std::string::npos || pos == 0) return 0;
+        std::istringstream count(line.substr(pos + 1));
+        unsigned long c = 0;
+        count >> c;
+        if (c == 0) return 0;
+        total += c;
+      }
+    return total;
+  }
+}
+
+TESTSUITE(profile)
+{
+  class fix
+  {
+  protected:
+    fix() : prof(crpcut::profile::create(1))
+    {
+      assert(prof);
+      prof->reset();
+    }
+    crpcut::profile *prof;
+  };
+
+  // The profiles are not destroyed, since the timer keeps signalling
+  // the test process until it exits.
+
+  TEST(no_samples_writes_nothing, fix)
+  {
+    std::ostringstream os;
+    prof->write_folded(os);
+    ASSERT_TRUE(os.str().empty());
+    crpcut::profile::destroy(prof, 1);
+  }
+
+  TEST(samples_are_written_as_folded_stacks_with_counts, fix)
+  {
+    prof->start();
+    spin_until_cputime_us(200000);
+    std::ostringstream os;
+    prof->write_folded(os);
+    ASSERT_GT(total_samples(os.str()), 10U);
+  }
+
+  TEST(samples_from_several_threads_at_once_are_kept_apart, fix)
+  {
+    prof->start();
+    const int num_threads = 4;
+    pthread_t threads[num_threads];
+    for (int i = 0; i < num_threads; ++i)
+      {
+        ASSERT_TRUE(pthread_create(&threads[i], 0, spin_thread, 0) == 0);
+      }
+    for (int i = 0; i < num_threads; ++i)
+      {
+        pthread_join(threads[i], 0);
+      }
+    std::ostringstream os;
+    prof->write_folded(os);
+    ASSERT_GT(total_samples(os.str()), 10U);
+  }
+}
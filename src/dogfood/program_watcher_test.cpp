@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_INOTIFY
+#include <crpcut.hpp>
+#include "../program_watcher.hpp"
+#include <sstream>
+#include <string>
+extern "C" {
+#  include <fcntl.h>
+#  include <limits.h>
+#  include <sys/stat.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+}
+
+namespace {
+  const char script[] = "#!/bin/sh\ntouch rerun\n";
+
+  void write_program(const char *name)
+  {
+    int fd = ::open(name, O_WRONLY | O_CREAT | O_TRUNC, 0755);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(::write(fd, script, sizeof(script) - 1)
+                == ssize_t(sizeof(script) - 1));
+    ::close(fd);
+  }
+
+  bool exists(const char *name)
+  {
+    struct stat s;
+    return ::stat(name, &s) == 0;
+  }
+
+  // Starts a watcher of "prog" in the working directory. Returns when the
+  // watch is in place, that is when the first round has been started.
+  pid_t start_watcher()
+  {
+    char path[PATH_MAX];
+    ASSERT_TRUE(::getcwd(path, sizeof(path) - 5));
+    const std::string exe = std::string(path) + "/prog";
+    int fds[2];
+    ASSERT_TRUE(::pipe(fds) == 0);
+    pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+      {
+        ::close(fds[0]);
+        static const char *const argv[] = { "prog", 0 };
+        std::ostringstream os;
+        crpcut::rerun_on_change(exe.c_str(), argv, os);
+        // first round
+        ::_exit(int(::write(fds[1], "", 1)));
+      }
+    ::close(fds[1]);
+    char c;
+    ASSERT_TRUE(::read(fds[0], &c, 1) == 1);
+    ::close(fds[0]);
+    return pid;
+  }
+
+  bool reruns(pid_t pid)
+  {
+    int status;
+    if (::waitpid(pid, &status, 0) != pid) return false;
+    const bool rv = WIFEXITED(status) && WEXITSTATUS(status) == 0
+      && exists("rerun");
+    ::remove("rerun");
+    ::remove("prog");
+    return rv;
+  }
+}
+
+TESTSUITE(program_watcher)
+{
+  TEST(writing_the_program_triggers_a_rerun,
+       DEADLINE_REALTIME_MS(2000))
+  {
+    pid_t pid = start_watcher();
+    write_program("prog");
+    ASSERT_TRUE(reruns(pid));
+  }
+
+  TEST(renaming_a_file_to_the_program_triggers_a_rerun,
+       DEADLINE_REALTIME_MS(2000))
+  {
+    pid_t pid = start_watcher();
+    write_program("prog.tmp");
+    ASSERT_TRUE(::rename("prog.tmp", "prog") == 0);
+    ASSERT_TRUE(reruns(pid));
+  }
+
+  TEST(writing_another_file_does_not_trigger_a_rerun,
+       DEADLINE_REALTIME_MS(2000))
+  {
+    write_program("prog");
+    pid_t pid = start_watcher();
+    write_program("other");
+    ::usleep(300000);
+    int status;
+    const pid_t rv = ::waitpid(pid, &status, WNOHANG);
+    ::kill(pid, SIGKILL);
+    ::waitpid(pid, &status, 0);
+    ::remove("other");
+    ::remove("prog");
+    ASSERT_TRUE(rv == 0);
+    ASSERT_FALSE(exists("rerun"));
+  }
+}
+#endif // HAVE_INOTIFY
@@ -247,6 +247,69 @@ TESTSUITE(report_reader)
     ASSERT_TRUE(reader.buffer.size() == 0U);
   }
 
+  TEST(frames_beyond_max_message_are_left_out_and_presented_as_truncated,
+       fix)
+  {
+    const std::vector<char> frame(65536, 'a');
+    const size_t num_frames = crpcut::report_reader::max_message
+                              / frame.size() + 1;
+    for (size_t i = 0; i < num_frames; ++i)
+      {
+        reader.buffer.push_back(crpcut::comm::type(crpcut::comm::stdout
+                                                   | crpcut::comm::continued));
+        reader.buffer.push_back(frame.size());
+        reader.buffer.push_back(test_reader::data(&frame[0], frame.size()));
+      }
+    const char apa[] = { 'a', 'p', 'a' };
+    reader.buffer.push_back(crpcut::comm::stdout);
+    reader.buffer.push_back(sizeof(apa));
+    reader.buffer.push_back(apa);
+    const std::string left_out("stdout65539 bytes left out");
+    trompeloeil::sequence s;
+    REQUIRE_CALL(monitor,
+                 send_to_presentation(crpcut::comm::stdout,
+                                      crpcut::report_reader::max_message,
+                                      _))
+      .IN_SEQUENCE(s);
+    REQUIRE_CALL(monitor, send_to_presentation(crpcut::comm::truncated,
+                                               sizeof(size_t)
+                                               + left_out.length(),
+                                               _))
+      .WITH(std::string(_3 + sizeof(size_t), _2 - sizeof(size_t))
+            == left_out)
+      .IN_SEQUENCE(s);
+    for (size_t i = 0; i <= num_frames; ++i)
+      {
+        ASSERT_TRUE(reader.read_data());
+      }
+    ASSERT_TRUE(reader.buffer.size() == 0U);
+  }
+
+  TEST(frame_longer_than_max_message_is_cut_and_presented_as_truncated,
+       fix)
+  {
+    const size_t max = crpcut::report_reader::max_message;
+    const std::vector<char> bytes(max + 1500, 'a');
+    reader.buffer.push_back(crpcut::comm::stdout);
+    reader.buffer.push_back(bytes.size());
+    reader.buffer.push_back(test_reader::data(&bytes[0], max));
+    reader.buffer.push_back(test_reader::data(&bytes[0], 1024));
+    reader.buffer.push_back(test_reader::data(&bytes[0], 476));
+    const std::string left_out("stdout1500 bytes left out");
+    trompeloeil::sequence s;
+    REQUIRE_CALL(monitor, send_to_presentation(crpcut::comm::stdout, max, _))
+      .IN_SEQUENCE(s);
+    REQUIRE_CALL(monitor, send_to_presentation(crpcut::comm::truncated,
+                                               sizeof(size_t)
+                                               + left_out.length(),
+                                               _))
+      .WITH(std::string(_3 + sizeof(size_t), _2 - sizeof(size_t))
+            == left_out)
+      .IN_SEQUENCE(s);
+    ASSERT_TRUE(reader.read_data());
+    ASSERT_TRUE(reader.buffer.size() == 0U);
+  }
+
   TESTSUITE(kill_mask)
   {
     TEST(info_marks_test_as_failed_sets_phase_child_kills_and_presents_exit_fail,
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../report_ring.hpp"
+#include "../pipe_pair.hpp"
+#include <crpcut.hpp>
+#include <cstring>
+#include <string>
+#include <vector>
+extern "C" {
+#  include <sys/wait.h>
+#  include <unistd.h>
+}
+
+TESTSUITE(report_ring)
+{
+  class fix
+  {
+  protected:
+    fix() : ring(crpcut::report_ring::create())
+    {
+      assert(ring);
+    }
+    ~fix()
+    {
+      crpcut::report_ring::destroy(ring);
+    }
+    static std::vector<char> message(crpcut::comm::type t,
+                                     const std::string &s)
+    {
+      std::vector<char> rv(crpcut::report_ring::header_size + s.length());
+      const size_t len = s.length();
+      std::memcpy(&rv[0], &t, sizeof(t));
+      std::memcpy(&rv[sizeof(t)], &len, sizeof(len));
+      std::memcpy(&rv[crpcut::report_ring::header_size], s.c_str(), len);
+      return rv;
+    }
+    crpcut::report_ring::result append(crpcut::comm::type t,
+                                       const std::string &s)
+    {
+      std::vector<char> m(message(t, s));
+      return ring->append(&m[0], m.size());
+    }
+    static int type_of(const std::vector<char> &m)
+    {
+      int t;
+      std::memcpy(&t, &m[0], sizeof(t));
+      return t;
+    }
+    crpcut::report_ring *ring;
+  };
+
+  TEST(empty_ring_pops_nothing, fix)
+  {
+    std::vector<char> m;
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::empty);
+  }
+
+  TEST(only_append_to_empty_ring_asks_for_wakeup, fix)
+  {
+    ASSERT_TRUE(append(crpcut::comm::info, "apa")
+                == crpcut::report_ring::appended_to_empty);
+    ASSERT_TRUE(append(crpcut::comm::info, "katt")
+                == crpcut::report_ring::appended);
+    std::vector<char> m;
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::popped);
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::popped);
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::empty);
+    ASSERT_TRUE(append(crpcut::comm::info, "lemur")
+                == crpcut::report_ring::appended_to_empty);
+  }
+
+  TEST(messages_are_popped_whole_in_order, fix)
+  {
+    append(crpcut::comm::info, "apa");
+    append(crpcut::comm::fail, "katt");
+    std::vector<char> m;
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::popped);
+    ASSERT_TRUE(m == message(crpcut::comm::info, "apa"));
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::popped);
+    ASSERT_TRUE(m == message(crpcut::comm::fail, "katt"));
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::empty);
+  }
+
+  TEST(messages_wrapping_around_the_end_are_popped_whole, fix)
+  {
+    const std::string s(10000, 'a');
+    std::vector<char> m;
+    for (int i = 0; i < 20; ++i)
+      {
+        std::string str(s);
+        str[0] = char('a' + i);
+        ASSERT_TRUE(append(crpcut::comm::info, str)
+                    == crpcut::report_ring::appended_to_empty);
+        ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::popped);
+        ASSERT_TRUE(m == message(crpcut::comm::info, str));
+      }
+  }
+
+  TEST(message_that_does_not_fit_is_marked_as_in_pipe, fix)
+  {
+    const std::string s(70000, 'a');
+    ASSERT_TRUE(append(crpcut::comm::info, "apa")
+                == crpcut::report_ring::appended_to_empty);
+    ASSERT_TRUE(append(crpcut::comm::info, s)
+                == crpcut::report_ring::overflow);
+    std::vector<char> m;
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::popped);
+    ASSERT_TRUE(m == message(crpcut::comm::info, "apa"));
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::popped);
+    ASSERT_TRUE(m.size() == crpcut::report_ring::header_size);
+    ASSERT_TRUE(type_of(m) == crpcut::report_ring::in_pipe);
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::empty);
+  }
+
+  TEST(header_with_length_beyond_what_is_appended_is_corrupt, fix)
+  {
+    std::vector<char> m(message(crpcut::comm::info, "apa"));
+    const size_t len = 1000;
+    std::memcpy(&m[sizeof(crpcut::comm::type)], &len, sizeof(len));
+    ASSERT_TRUE(ring->append(&m[0], m.size())
+                == crpcut::report_ring::appended_to_empty);
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::corrupt);
+  }
+
+  TEST(header_with_length_beyond_the_ring_is_corrupt, fix)
+  {
+    std::vector<char> m(message(crpcut::comm::info, "apa"));
+    const size_t len = ~size_t();
+    std::memcpy(&m[sizeof(crpcut::comm::type)], &len, sizeof(len));
+    ASSERT_TRUE(ring->append(&m[0], m.size())
+                == crpcut::report_ring::appended_to_empty);
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::corrupt);
+  }
+
+#ifdef HAVE_ROBUST_MUTEX
+  TEST(lock_held_by_a_dead_producer_is_taken_over, fix,
+       DEADLINE_REALTIME_MS(2000))
+  {
+    pid_t pid = ::fork();
+    ASSERT_TRUE(pid >= 0);
+    if (pid == 0)
+      {
+        ring->lock();
+        ::_exit(0);
+      }
+    int status;
+    ASSERT_TRUE(::waitpid(pid, &status, 0) == pid);
+    ASSERT_TRUE(ring->lock());
+    ring->unlock();
+    ASSERT_FALSE(ring->lock());
+    ring->unlock();
+  }
+
+  TEST(message_cut_short_by_a_dead_producer_is_followed_by_abandoned, fix,
+       DEADLINE_REALTIME_MS(2000))
+  {
+    crpcut::pipe_pair pipes("report_ring_test");
+    crpcut::comm::wfile_descriptor
+      pipe(pipes.for_writing(crpcut::pipe_pair::release_ownership));
+    crpcut::report_ring_writer writer(pipe, ring);
+    const std::vector<char> frame(message(crpcut::comm::type(crpcut::comm::info
+                                                             | crpcut::comm::continued),
+                                          "apa"));
+    pid_t pid = ::fork();
+    ASSERT_TRUE(pid >= 0);
+    if (pid == 0)
+      {
+        writer.begin_message();
+        writer.write_loop(&frame[0], frame.size());
+        ::_exit(0);
+      }
+    int status;
+    ASSERT_TRUE(::waitpid(pid, &status, 0) == pid);
+    writer.begin_message();
+    writer.end_message();
+    std::vector<char> m;
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::popped);
+    ASSERT_TRUE(m == frame);
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::popped);
+    ASSERT_TRUE(m.size() == crpcut::report_ring::header_size);
+    ASSERT_TRUE(type_of(m) == crpcut::report_ring::abandoned);
+    ASSERT_TRUE(ring->pop(m) == crpcut::report_ring::empty);
+  }
+#endif
+}
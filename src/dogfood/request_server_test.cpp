@@ -0,0 +1,202 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+#include <crpcut.hpp>
+#include "../request_server.hpp"
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+extern "C" {
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+}
+
+namespace {
+  class request_pipe
+  {
+  public:
+    request_pipe(const std::string &s)
+    {
+      ASSERT_TRUE(::pipe(fd_) == 0);
+      ASSERT_TRUE(::write(fd_[1], s.data(), s.size()) == ssize_t(s.size()));
+      ::close(fd_[1]);
+    }
+    ~request_pipe() { ::close(fd_[0]); }
+    int fd() const { return fd_[0]; }
+  private:
+    int fd_[2];
+  };
+
+  int bound_socket(const char *path)
+  {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_TRUE(fd >= 0);
+    struct sockaddr_un addr = sockaddr_un();
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path);
+    ASSERT_TRUE(::bind(fd,
+                       reinterpret_cast<const struct sockaddr*>(&addr),
+                       sizeof(addr)) == 0);
+    return fd;
+  }
+
+  bool exists(const char *path)
+  {
+    struct stat s;
+    return ::lstat(path, &s) == 0;
+  }
+}
+
+TESTSUITE(request_server)
+{
+  TESTSUITE(split)
+  {
+    TEST(words_are_separated_by_any_white_space)
+    {
+      char buff[] = " -v\tapa  katt\r\n";
+      const char *args[crpcut::max_request_args + 1];
+      ASSERT_TRUE(crpcut::split_request("prog", buff, args));
+      ASSERT_TRUE(std::string(args[0]) == "prog");
+      ASSERT_TRUE(std::string(args[1]) == "-v");
+      ASSERT_TRUE(std::string(args[2]) == "apa");
+      ASSERT_TRUE(std::string(args[3]) == "katt");
+      ASSERT_FALSE(args[4]);
+    }
+
+    TEST(empty_request_gives_only_program_name)
+    {
+      char buff[] = " \n";
+      const char *args[crpcut::max_request_args + 1];
+      ASSERT_TRUE(crpcut::split_request("prog", buff, args));
+      ASSERT_TRUE(std::string(args[0]) == "prog");
+      ASSERT_FALSE(args[1]);
+    }
+
+    TEST(max_args_including_program_name_are_accepted)
+    {
+      std::string s;
+      for (std::size_t i = 1; i < crpcut::max_request_args; ++i) s += "a ";
+      std::vector<char> buff(s.begin(), s.end());
+      buff.push_back(0);
+      const char *args[crpcut::max_request_args + 1];
+      ASSERT_TRUE(crpcut::split_request("prog", &buff[0], args));
+      ASSERT_TRUE(std::string(args[crpcut::max_request_args - 1]) == "a");
+      ASSERT_FALSE(args[crpcut::max_request_args]);
+    }
+
+    TEST(one_arg_too_many_is_rejected)
+    {
+      std::string s;
+      for (std::size_t i = 0; i < crpcut::max_request_args; ++i) s += "a ";
+      std::vector<char> buff(s.begin(), s.end());
+      buff.push_back(0);
+      const char *args[crpcut::max_request_args + 1];
+      ASSERT_FALSE(crpcut::split_request("prog", &buff[0], args));
+    }
+  }
+
+  TESTSUITE(read)
+  {
+    TEST(line_is_read_up_to_and_including_newline)
+    {
+      request_pipe p("-v apa\nkatt");
+      char buff[crpcut::max_request_len + 1];
+      ASSERT_TRUE(crpcut::read_request(p.fd(), buff));
+      ASSERT_TRUE(std::string(buff) == "-v apa\n");
+    }
+
+    TEST(input_without_newline_is_read_until_eof)
+    {
+      request_pipe p("-v apa");
+      char buff[crpcut::max_request_len + 1];
+      ASSERT_TRUE(crpcut::read_request(p.fd(), buff));
+      ASSERT_TRUE(std::string(buff) == "-v apa");
+    }
+
+    TEST(longest_line_is_accepted)
+    {
+      request_pipe p(std::string(crpcut::max_request_len - 1, 'a') + '\n');
+      char buff[crpcut::max_request_len + 1];
+      ASSERT_TRUE(crpcut::read_request(p.fd(), buff));
+      ASSERT_TRUE(std::strlen(buff) == crpcut::max_request_len);
+    }
+
+    TEST(too_long_line_is_rejected)
+    {
+      request_pipe p(std::string(crpcut::max_request_len, 'a') + '\n');
+      char buff[crpcut::max_request_len + 1];
+      ASSERT_FALSE(crpcut::read_request(p.fd(), buff));
+    }
+
+    TEST(too_long_input_without_newline_is_rejected)
+    {
+      request_pipe p(std::string(crpcut::max_request_len, 'a'));
+      char buff[crpcut::max_request_len + 1];
+      ASSERT_FALSE(crpcut::read_request(p.fd(), buff));
+    }
+  }
+
+  TESTSUITE(stale_socket)
+  {
+    TEST(socket_nobody_listens_on_is_removed)
+    {
+      ::close(bound_socket("sock"));
+      ASSERT_TRUE(exists("sock"));
+      crpcut::remove_stale_socket("sock");
+      ASSERT_FALSE(exists("sock"));
+    }
+
+    TEST(socket_with_listener_is_kept)
+    {
+      int fd = bound_socket("sock");
+      ASSERT_TRUE(::listen(fd, 1) == 0);
+      crpcut::remove_stale_socket("sock");
+      ASSERT_TRUE(exists("sock"));
+      ::close(fd);
+      ::remove("sock");
+    }
+
+    TEST(regular_file_is_kept)
+    {
+      {
+        std::ofstream f("sock");
+      }
+      crpcut::remove_stale_socket("sock");
+      ASSERT_TRUE(exists("sock"));
+      ::remove("sock");
+    }
+
+    TEST(missing_file_is_ignored)
+    {
+      crpcut::remove_stale_socket("sock");
+      ASSERT_FALSE(exists("sock"));
+    }
+  }
+}
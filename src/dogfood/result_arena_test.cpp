@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../result_arena.hpp"
+#include <crpcut.hpp>
+#include <string>
+
+TESTSUITE(result_arena)
+{
+  TEST(copied_string_has_the_same_contents)
+  {
+    crpcut::result_arena a;
+    const char str[] = "apa katt";
+    crpcut::datatypes::fixed_string s = a.copy(str, sizeof(str) - 1);
+    ASSERT_TRUE(s.str != str);
+    ASSERT_TRUE(std::string(s.str, s.len) == "apa katt");
+  }
+
+  TEST(allocations_are_aligned_for_pointers)
+  {
+    crpcut::result_arena a;
+    a.allocate(1);
+    void *p = a.allocate(sizeof(void*));
+    ASSERT_TRUE(reinterpret_cast<size_t>(p) % sizeof(void*) == 0U);
+  }
+
+  TEST(small_allocations_are_packed_together)
+  {
+    crpcut::result_arena a;
+    char *p1 = static_cast<char*>(a.allocate(16));
+    char *p2 = static_cast<char*>(a.allocate(16));
+    ASSERT_TRUE(p2 == p1 + 16);
+  }
+
+  TEST(large_allocation_leaves_the_current_chunk_in_use)
+  {
+    crpcut::result_arena a;
+    char *p1 = static_cast<char*>(a.allocate(16));
+    const std::string large(crpcut::result_arena::chunk_size * 2, 'x');
+    crpcut::datatypes::fixed_string s = a.copy(large.c_str(), large.length());
+    char *p2 = static_cast<char*>(a.allocate(16));
+    ASSERT_TRUE(p2 == p1 + 16);
+    ASSERT_TRUE(std::string(s.str, s.len) == large);
+  }
+}
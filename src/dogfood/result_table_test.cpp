@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../result_table.hpp"
+#include "../test_case_result.hpp"
+#include <crpcut.hpp>
+#include <vector>
+
+TESTSUITE(result_table)
+{
+  TEST(empty_table_finds_nothing)
+  {
+    crpcut::result_table t;
+    ASSERT_FALSE(t.find(1));
+    ASSERT_FALSE(t.any());
+    ASSERT_TRUE(t.size() == 0U);
+  }
+
+  TEST(inserted_result_is_found_by_id)
+  {
+    crpcut::result_table t;
+    crpcut::test_case_result r(3141);
+    t.insert(&r);
+    ASSERT_TRUE(t.find(3141) == &r);
+    ASSERT_FALSE(t.find(2718));
+    ASSERT_TRUE(t.any() == &r);
+    ASSERT_TRUE(t.size() == 1U);
+  }
+
+  TEST(erased_result_is_not_found)
+  {
+    crpcut::result_table t;
+    crpcut::test_case_result r(3141);
+    t.insert(&r);
+    t.erase(3141);
+    ASSERT_FALSE(t.find(3141));
+    ASSERT_TRUE(t.size() == 0U);
+  }
+
+  TEST(all_results_are_found_after_growing_and_erasing_every_other)
+  {
+    std::vector<crpcut::test_case_result*> v;
+    crpcut::result_table t;
+    for (pid_t id = 1000; id < 1300; ++id)
+      {
+        v.push_back(new crpcut::test_case_result(id));
+        t.insert(v.back());
+      }
+    ASSERT_TRUE(t.size() == 300U);
+    for (size_t i = 0; i < v.size(); i += 2)
+      {
+        t.erase(v[i]->id);
+      }
+    ASSERT_TRUE(t.size() == 150U);
+    for (size_t i = 0; i < v.size(); ++i)
+      {
+        INFO << v[i]->id;
+        crpcut::test_case_result *expected = i & 1 ? v[i] : 0;
+        ASSERT_TRUE(t.find(v[i]->id) == expected);
+        delete v[i];
+      }
+  }
+}
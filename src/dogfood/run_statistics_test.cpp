@@ -0,0 +1,180 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../run_statistics.hpp"
+#include <crpcut.hpp>
+#include <sstream>
+
+TESTSUITE(run_statistics)
+{
+  TEST(nothing_run_is_empty)
+  {
+    crpcut::run_statistics s(4);
+    ASSERT_TRUE(s.empty());
+    ASSERT_TRUE(s.slowest().empty());
+    ASSERT_TRUE(s.per_suite().empty());
+    ASSERT_TRUE(s.walltime_us() == 0U);
+  }
+
+  TEST(slowest_tests_are_sorted_and_limited)
+  {
+    crpcut::run_statistics s(1);
+    for (unsigned long n = 0; n < 20; ++n)
+      {
+        std::ostringstream name;
+        name << "s::t" << n;
+        s.begin_test(n*100, 0);
+        s.end_test(n*100 + 10, name.str(), "", (n*7) % 20, 0);
+      }
+    crpcut::run_statistics::test_times t = s.slowest();
+    ASSERT_TRUE(t.size() == crpcut::run_statistics::num_slowest);
+    ASSERT_TRUE(t[0].duration_us == 19U);
+    ASSERT_TRUE(t[0].name == "s::t17");
+    for (std::size_t i = 1; i < t.size(); ++i)
+      {
+        ASSERT_TRUE(t[i-1].duration_us > t[i].duration_us);
+      }
+  }
+
+  TEST(durations_are_grouped_per_suite_and_tag)
+  {
+    crpcut::run_statistics s(2);
+    for (unsigned long n = 1; n <= 10; ++n)
+      {
+        s.begin_test(0, 0);
+        s.end_test(n, "a::b::t", "slow", n*1000, 0);
+      }
+    s.begin_test(0, 0);
+    s.end_test(1, "a::t", "", 5, 0);
+    s.begin_test(0, 0);
+    s.end_test(1, "a::t", "slow", 7, 0);
+    s.begin_test(0, 0);
+    s.end_test(1, "top_level", "", 3, 0);
+
+    crpcut::run_statistics::distributions d = s.per_suite();
+    ASSERT_TRUE(d.size() == 2U);
+    ASSERT_TRUE(d[0].name == "a");
+    ASSERT_TRUE(d[0].count == 2U);
+    ASSERT_TRUE(d[0].p50_us == 5U);
+    ASSERT_TRUE(d[0].max_us == 7U);
+    ASSERT_TRUE(d[1].name == "a::b");
+    ASSERT_TRUE(d[1].count == 10U);
+    ASSERT_TRUE(d[1].p50_us == 5000U);
+    ASSERT_TRUE(d[1].p90_us == 9000U);
+    ASSERT_TRUE(d[1].max_us == 10000U);
+
+    d = s.per_tag();
+    ASSERT_TRUE(d.size() == 1U);
+    ASSERT_TRUE(d[0].name == "slow");
+    ASSERT_TRUE(d[0].count == 11U);
+    ASSERT_TRUE(d[0].p50_us == 5000U);
+  }
+
+  TEST(cputime_is_summed_and_walltime_spans_the_tests)
+  {
+    crpcut::run_statistics s(2);
+    s.begin_test(1000, 0);
+    s.begin_test(1500, 0);
+    s.end_test(3000, "s::a", "", 2000, 1800);
+    s.end_test(4000, "s::b", "", 2500, 2400);
+    ASSERT_TRUE(s.cputime_us() == 4200U);
+    ASSERT_TRUE(s.walltime_us() == 3000U);
+  }
+
+  TEST(idle_slots_are_blocked_while_tests_wait)
+  {
+    crpcut::run_statistics s(2);
+    s.begin_test(0, 0);
+    // one slot idle, while two tests wait for the first to finish
+    s.end_test(100, "s::a", "", 100, 0);
+    s.begin_test(100, 100);
+    s.begin_test(100, 0);
+    s.end_test(300, "s::b", "", 200, 0);
+    // one slot idle, with nothing left to start
+    s.end_test(400, "s::c", "", 300, 0);
+    ASSERT_TRUE(s.busy_slot_us() == 100U + 400U + 100U);
+    ASSERT_TRUE(s.blocked_slot_us() == 100U);
+    ASSERT_TRUE(s.idle_slot_us() == 100U);
+    ASSERT_TRUE(s.num_slots() == 2U);
+  }
+
+  TEST(idle_slots_are_not_blocked_when_no_test_starts_after)
+  {
+    crpcut::run_statistics s(2);
+    s.begin_test(0, 0);
+    s.begin_test(0, 0);
+    // tests depending on s::a are never started, since it failed
+    s.end_test(100, "s::a", "", 100, 0);
+    s.end_test(300, "s::b", "", 300, 0);
+    ASSERT_TRUE(s.busy_slot_us() == 400U);
+    ASSERT_TRUE(s.blocked_slot_us() == 0U);
+    ASSERT_TRUE(s.idle_slot_us() == 200U);
+  }
+
+  TEST(idle_slots_are_not_blocked_unless_the_runner_stalled)
+  {
+    crpcut::run_statistics s(2);
+    s.begin_test(0, 0);
+    s.end_test(100, "s::a", "", 100, 0);
+    // both slots idle for 100us, the runner was held up for 50us of it
+    s.begin_test(150, 50);
+    s.end_test(250, "s::b", "", 100, 0);
+    ASSERT_TRUE(s.busy_slot_us() == 200U);
+    ASSERT_TRUE(s.blocked_slot_us() == 50U);
+    ASSERT_TRUE(s.idle_slot_us() == 100U + 50U + 100U);
+  }
+
+  TEST(blocked_slot_time_is_at_most_the_idle_slot_time)
+  {
+    crpcut::run_statistics s(1);
+    s.begin_test(0, 0);
+    s.end_test(100, "s::a", "", 100, 0);
+    s.begin_test(120, 1000);
+    s.end_test(200, "s::b", "", 80, 0);
+    ASSERT_TRUE(s.blocked_slot_us() == 20U);
+    ASSERT_TRUE(s.idle_slot_us() == 0U);
+  }
+
+  TEST(overhead_is_summarised_by_mean_and_max)
+  {
+    crpcut::run_statistics s(1, true);
+    ASSERT_TRUE(s.with_overhead());
+    ASSERT_TRUE(s.overhead().empty());
+    s.add_overhead("runner.messages", 4);
+    s.add_overhead("presenter.lag_us", 100);
+    s.add_overhead("runner.messages", 10);
+    s.add_overhead("runner.messages", 7);
+    crpcut::run_statistics::figures f = s.overhead();
+    ASSERT_TRUE(f.size() == 2U);
+    ASSERT_TRUE(f[0].name == "presenter.lag_us");
+    ASSERT_TRUE(f[0].count == 1U);
+    ASSERT_TRUE(f[0].mean == 100U);
+    ASSERT_TRUE(f[1].name == "runner.messages");
+    ASSERT_TRUE(f[1].count == 3U);
+    ASSERT_TRUE(f[1].mean == 7U);
+    ASSERT_TRUE(f[1].max == 10U);
+  }
+}
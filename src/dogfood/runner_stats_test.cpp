@@ -0,0 +1,77 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../runner_stats.hpp"
+#include <crpcut.hpp>
+extern "C" {
+#  include <unistd.h>
+}
+
+TESTSUITE(runner_stats)
+{
+  TEST(messages_are_counted_per_slot)
+  {
+    void *space = alloca(crpcut::runner_stats::space_for(2));
+    crpcut::runner_stats s(space, 2);
+    s.begin_test(0);
+    s.begin_test(1);
+    s.message(0, 10);
+    s.message(1, 3);
+    s.message(0, 22);
+    ASSERT_TRUE(s.messages(0) == 2U);
+    ASSERT_TRUE(s.message_bytes(0) == 32U);
+    ASSERT_TRUE(s.messages(1) == 1U);
+    ASSERT_TRUE(s.message_bytes(1) == 3U);
+  }
+
+  TEST(a_new_test_in_a_slot_starts_from_zero)
+  {
+    void *space = alloca(crpcut::runner_stats::space_for(1));
+    crpcut::runner_stats s(space, 1);
+    s.begin_test(0);
+    s.message(0, 10);
+    s.enter_body(0);
+    s.end_test(0);
+    s.begin_test(0);
+    ASSERT_TRUE(s.messages(0) == 0U);
+    ASSERT_TRUE(s.message_bytes(0) == 0U);
+    ASSERT_TRUE(s.start_latency_us(0) == 0U);
+  }
+
+  TEST(start_latency_is_counted_from_when_the_slot_was_freed)
+  {
+    void *space = alloca(crpcut::runner_stats::space_for(1));
+    crpcut::runner_stats s(space, 1);
+    s.begin_test(0);
+    s.enter_body(0);
+    s.end_test(0);
+    s.begin_test(0);
+    ::usleep(20000);
+    s.enter_body(0);
+    ASSERT_GE(s.start_latency_us(0), 20000U);
+    ASSERT_LT(s.start_latency_us(0), 2000000U);
+  }
+}
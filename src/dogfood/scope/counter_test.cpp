@@ -0,0 +1,181 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include "../../perf_counters.hpp"
+#include "../../wrapped/posix_encapsulation.hpp"
+
+namespace {
+  bool counters_available(bool &fallback)
+  {
+    int fd = crpcut::perf::open(crpcut::scope::counter_base::instructions,
+                                0, false, fallback);
+    if (fd < 0) return false;
+    crpcut::wrapped::close(fd);
+    return true;
+  }
+
+  void burn()
+  {
+    volatile unsigned long n = 0;
+    for (unsigned i = 0; i < 100000; ++i) n = n + i;
+  }
+}
+
+TESTSUITE(scope)
+{
+  TESTSUITE(counter)
+  {
+    struct fix
+    {
+      fix() : r(os) {}
+      std::ostringstream os;
+      crpcut::comm::reporter r;
+    };
+
+    using crpcut::comm::fail;
+    using crpcut::scope::counter;
+    typedef crpcut::scope::counter_base base;
+
+    TEST(a_generous_limit_gives_no_report, fix)
+    {
+      bool fallback;
+      if (!counters_available(fallback) || fallback)
+        {
+          INFO << "no hardware counters, nothing to check";
+          return;
+        }
+      {
+        counter<fail, base::max, base::instructions> c(~0ULL, "apa:3", r, 0);
+        burn();
+      }
+      ASSERT_TRUE(os.str() == "");
+    }
+
+    TEST(a_zero_limit_gives_a_report_with_the_actual_count, fix)
+    {
+      bool fallback;
+      if (!counters_available(fallback) || fallback)
+        {
+          INFO << "no hardware counters, nothing to check";
+          return;
+        }
+      {
+        counter<fail, base::max, base::instructions> c(0, "apa:3", r, 0);
+        burn();
+      }
+      const std::string head =
+        "\napa:3\n"
+        "VERIFY_SCOPE_MAX_INSTRUCTIONS(0)\n"
+        "Actual count was ";
+      ASSERT_TRUE(os.str().substr(0, head.length()) == head);
+      ASSERT_GT(os.str().length(), head.length() + 1);
+    }
+
+    TEST(a_software_counter_is_not_checked_but_its_count_is_told, fix)
+    {
+      bool fallback;
+      if (!counters_available(fallback) || !fallback)
+        {
+          INFO << "no software counter in place of a hardware one";
+          return;
+        }
+      {
+        counter<fail, base::max, base::instructions> c(~0ULL, "apa:3", r, 0);
+        burn();
+      }
+      const std::string head =
+        "\napa:3\n"
+        "VERIFY_SCOPE_MAX_INSTRUCTIONS(18446744073709551615)\n"
+        "Not checked, no hardware counter. Counted task_clock_ns: ";
+      ASSERT_TRUE(os.str().substr(0, head.length()) == head);
+      ASSERT_GT(os.str().length(), head.length() + 1);
+    }
+
+    TEST(a_scope_without_a_counter_is_told_as_not_checked, fix)
+    {
+      bool fallback;
+      if (counters_available(fallback))
+        {
+          INFO << "performance counters are available";
+          return;
+        }
+      {
+        counter<fail, base::max, base::instructions> c(0, "apa:3", r, 0);
+        burn();
+      }
+      ASSERT_TRUE(os.str() ==
+                  "\napa:3\n"
+                  "VERIFY_SCOPE_MAX_INSTRUCTIONS(0)\n"
+                  "Not checked, no performance counter could be opened\n");
+    }
+
+    TEST(copying_of_a_busted_limit_gives_only_one_report, fix)
+    {
+      bool fallback;
+      if (!counters_available(fallback))
+        {
+          INFO << "no performance counters, nothing to check";
+          return;
+        }
+      {
+        typedef counter<fail, base::max, base::cycles> cycles;
+        cycles c(0, "apa:3", r, 0);
+        burn();
+        cycles c2(c);
+        cycles c3(c2);
+      }
+      const std::string s = os.str();
+      ASSERT_TRUE(s.find("VERIFY_SCOPE_MAX_CYCLES(0)\n") != std::string::npos);
+      ASSERT_TRUE(s.find("apa:3", s.find("apa:3") + 1) == std::string::npos);
+    }
+
+    TEST(name_of_max_is_MAX)
+    {
+      ASSERT_TRUE(std::string(base::max::name()) == "MAX");
+    }
+  }
+
+  TESTSUITE(perf_counters)
+  {
+    TEST(counts_of_a_process_are_named_after_what_was_counted)
+    {
+      crpcut::perf_counters counters(crpcut::wrapped::getpid());
+      burn();
+      crpcut::perf_counters::usage usage;
+      counters.read_usage(usage);
+      for (std::size_t i = 0; i < usage.size(); ++i)
+        {
+          const std::string name = usage[i].first;
+          ASSERT_TRUE(name.substr(0, 5) == "perf.");
+          for (std::size_t j = 0; j < i; ++j)
+            {
+              ASSERT_TRUE(name != usage[j].first);
+            }
+        }
+    }
+  }
+}
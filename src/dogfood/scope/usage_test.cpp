@@ -0,0 +1,123 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include <sys/mman.h>
+
+TESTSUITE(scope)
+{
+  TESTSUITE(usage)
+  {
+    class test_measure {
+    public:
+      static const char *name() { return "TEST_COUNT"; }
+      static unsigned long now() { return count; }
+      static void set(unsigned long n) { count = n; }
+    private:
+      static unsigned long count;
+    };
+
+    unsigned long test_measure::count = 0;
+
+    struct fix
+    {
+      fix() : r(os) { test_measure::set(10); }
+      std::ostringstream os;
+      crpcut::comm::reporter r;
+    };
+
+    using crpcut::comm::fail;
+    using crpcut::scope::usage;
+    typedef crpcut::scope::usage_base::max max;
+
+    TEST(a_count_within_the_limit_gives_no_report, fix)
+    {
+      {
+        usage<fail, max, test_measure> u(2, "apa:3", r, 0);
+        test_measure::set(12);
+      }
+      ASSERT_TRUE(os.str() == "");
+    }
+
+    TEST(a_count_beyond_the_limit_gives_a_report, fix)
+    {
+      {
+        usage<fail, max, test_measure> u(2, "apa:3", r, 0);
+        test_measure::set(13);
+      }
+      static const char report[] =
+          "\napa:3\n"
+          "VERIFY_SCOPE_MAX_TEST_COUNT(2)\n"
+          "Actual count was 3\n";
+      ASSERT_TRUE(os.str() == report);
+    }
+
+    TEST(copying_of_a_busted_limit_gives_only_one_report, fix)
+    {
+      {
+        usage<fail, max, test_measure> u(0, "apa:3", r, 0);
+        test_measure::set(11);
+        usage<fail, max, test_measure> u2(u);
+        usage<fail, max, test_measure> u3(u2);
+      }
+      static const char report[] =
+          "\napa:3\n"
+          "VERIFY_SCOPE_MAX_TEST_COUNT(0)\n"
+          "Actual count was 1\n";
+      ASSERT_TRUE(os.str() == report);
+    }
+
+    TEST(touching_fresh_memory_counts_minor_faults, fix)
+    {
+      typedef crpcut::scope::usage_base::minor_faults minor_faults;
+      static const std::size_t size = 64 * 4096;
+      void *p = mmap(0, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      ASSERT_TRUE(p != MAP_FAILED);
+      {
+        usage<fail, max, minor_faults> u(0, "apa:3", r, 0);
+        char *c = static_cast<char*>(p);
+        for (std::size_t i = 0; i < size; i += 4096) c[i] = 1;
+      }
+      munmap(p, size);
+      ASSERT_TRUE(os.str().find("VERIFY_SCOPE_MAX_MINOR_FAULTS(0)\n")
+                  != std::string::npos);
+    }
+
+    TEST(names_of_measures)
+    {
+      using crpcut::scope::usage_base;
+      ASSERT_TRUE(std::string(usage_base::major_faults::name())
+                  == "MAJOR_FAULTS");
+      ASSERT_TRUE(std::string(usage_base::minor_faults::name())
+                  == "MINOR_FAULTS");
+      ASSERT_TRUE(std::string(usage_base::voluntary_switches::name())
+                  == "VOLUNTARY_SWITCHES");
+      ASSERT_TRUE(std::string(usage_base::involuntary_switches::name())
+                  == "INVOLUNTARY_SWITCHES");
+    }
+  }
+}
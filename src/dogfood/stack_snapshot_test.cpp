@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../stack_snapshot.hpp"
+#include <crpcut.hpp>
+#include <sstream>
+#include <string>
+extern "C" {
+#  include <unistd.h>
+#  include <sys/wait.h>
+}
+
+TESTSUITE(stack_snapshot)
+{
+  class fix
+  {
+  protected:
+    fix() : snapshot(crpcut::stack_snapshot::create(1)), pid(-1)
+    {
+      assert(snapshot);
+      snapshot->reset();
+      int rv = ::pipe(ready);
+      assert(rv == 0);
+      rv = ::pipe(go);
+      assert(rv == 0);
+    }
+    ~fix()
+    {
+      ::close(go[1]);
+      if (pid > 0) ::waitpid(pid, 0, 0);
+      ::close(ready[0]);
+      ::close(go[0]);
+      crpcut::stack_snapshot::destroy(snapshot, 1);
+    }
+    // A process that is blocked reading a pipe until the test ends.
+    void spawn(bool armed)
+    {
+      pid = ::fork();
+      assert(pid >= 0);
+      if (pid == 0)
+        {
+          if (armed) snapshot->arm();
+          char c = 0;
+          ::close(go[1]);
+          ::_exit(int(::write(ready[1], &c, 1) + ::read(go[0], &c, 1)));
+        }
+      ::close(ready[1]);
+      char c;
+      ASSERT_TRUE(::read(ready[0], &c, 1) == 1);
+    }
+    crpcut::stack_snapshot *snapshot;
+    pid_t pid;
+    int ready[2];
+    int go[2];
+  };
+
+  TEST(nothing_captured_writes_nothing, fix)
+  {
+    std::ostringstream os;
+    snapshot->write(os);
+    ASSERT_TRUE(os.str().empty());
+  }
+
+#if defined(USE_BACKTRACE) && defined(HAVE_TGKILL)
+  TEST(the_stack_of_an_armed_process_is_captured, fix,
+       DEADLINE_REALTIME_MS(1000))
+  {
+    spawn(true);
+    ASSERT_TRUE(snapshot->capture(pid) == 1U);
+    std::ostringstream os;
+    snapshot->write(os);
+    std::ostringstream expected;
+    expected << "thread " << pid << ":\n  ";
+    ASSERT_TRUE(os.str().compare(0, expected.str().length(), expected.str())
+                == 0);
+  }
+
+  TEST(a_process_that_is_not_armed_is_not_waited_for, fix,
+       DEADLINE_REALTIME_MS(100))
+  {
+    spawn(false);
+    ASSERT_TRUE(snapshot->capture(pid) == 0U);
+    std::ostringstream os;
+    snapshot->write(os);
+    ASSERT_TRUE(os.str().empty());
+  }
+
+  TEST(an_armed_process_in_the_process_group_is_captured, fix,
+       DEADLINE_REALTIME_MS(1000))
+  {
+    char c;
+    pid = ::fork();
+    ASSERT_TRUE(pid >= 0);
+    if (pid == 0)
+      {
+        ::setpgid(0, 0);
+        ::close(go[1]);
+        pid_t child = ::fork();
+        if (child == 0)
+          {
+            snapshot->arm();
+            c = 0;
+            ::_exit(int(::write(ready[1], &c, 1) + ::read(go[0], &c, 1)));
+          }
+        ::_exit(child > 0 && ::waitpid(child, 0, 0) == child ? 0 : 1);
+      }
+    ::close(ready[1]);
+    ASSERT_TRUE(::read(ready[0], &c, 1) == 1);
+    ASSERT_TRUE(snapshot->capture(pid) == 1U);
+    std::ostringstream os;
+    snapshot->write(os);
+    ASSERT_TRUE(os.str().compare(0, 7, "thread ") == 0);
+  }
+#endif
+}
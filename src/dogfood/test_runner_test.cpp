@@ -54,7 +54,10 @@ TESTSUITE(test_runner)
     MAKE_MOCK1(set_deadline, void(crpcut::crpcut_test_case_registrator*));
     MAKE_MOCK1(clear_deadline, void(crpcut::crpcut_test_case_registrator*));
     MAKE_MOCK1(return_dir, void(unsigned));
-    MAKE_MOCK1(calc_cputime, unsigned long(const struct timeval&));
+    MAKE_MOCK2(calc_cputime, unsigned long(const struct timeval&,
+                                         const struct rusage&));
+    MAKE_MOCK2(save_profile, void(crpcut::crpcut_test_case_registrator*,
+                                  const crpcut::profile&));
   };
 
   class mock_environment : public crpcut::test_environment
@@ -93,7 +96,7 @@ TESTSUITE(test_runner)
   public:
     MAKE_MOCK2(getrusage, int(int, struct rusage*));
     MAKE_MOCK2(killpg, int(int, int));
-    MAKE_MOCK4(waitid, int(idtype_t, id_t, siginfo_t*, int));
+    MAKE_MOCK5(waitid, int(idtype_t, id_t, siginfo_t*, int, struct rusage*));
   };
 
   class mock_fsops : public crpcut::filesystem_operations
@@ -182,6 +185,8 @@ TESTSUITE(test_runner)
           &reporter, &process_control, &fsops, &runner)
     {
       reg.set_test_environment(&env);
+      metrics = NAMED_ALLOW_CALL(runner, present(_, crpcut::comm::metric,
+                                                 _, _, _));
     }
     template <size_t N1, size_t N2>
     void make_message(char (&buffer)[N1], const char (&msg)[N2])
@@ -206,12 +211,13 @@ TESTSUITE(test_runner)
       info.si_code   = code;
 
       auto idpid = id_t(pid);
-      waitid_x2 = NAMED_REQUIRE_CALL(process_control, waitid(P_PGID, idpid, _, WEXITED))
+      waitid_x2 = NAMED_REQUIRE_CALL(process_control, waitid(P_PGID, idpid, _, WEXITED, _))
         .SIDE_EFFECT(errno = ECHILD)
         .RETURN(-1);
 
-      waitid_x1 = NAMED_REQUIRE_CALL(process_control, waitid(P_PGID, idpid, _, WEXITED))
+      waitid_x1 = NAMED_REQUIRE_CALL(process_control, waitid(P_PGID, idpid, _, WEXITED, _))
         .SIDE_EFFECT(*_3 = info)
+        .SIDE_EFFECT(*_5 = rusage())
         .RETURN(0);
     }
 
@@ -226,6 +232,7 @@ TESTSUITE(test_runner)
     test_registrator<dump_policy>         reg;
     std::unique_ptr<trompeloeil::expectation> waitid_x1;
     std::unique_ptr<trompeloeil::expectation> waitid_x2;
+    std::unique_ptr<trompeloeil::expectation> metrics;
   };
 
   TESTSUITE(just_constructed)
@@ -533,7 +540,7 @@ TESTSUITE(test_runner)
       reg.set_phase(crpcut::destroying);
       prepare_siginfo(test_pid, 0, CLD_EXITED, s);
 
-      REQUIRE_CALL(runner, calc_cputime(_))
+      REQUIRE_CALL(runner, calc_cputime(_, _))
         .RETURN(10U);
 
       REQUIRE_CALL(reg, crpcut_is_expected_exit(0))
@@ -573,7 +580,7 @@ TESTSUITE(test_runner)
         prepare_siginfo(test_pid, 0, CLD_DUMPED, s);
 
 
-        REQUIRE_CALL(runner, calc_cputime(_))
+        REQUIRE_CALL(runner, calc_cputime(_, _))
           .RETURN(10U);
 
         REQUIRE_CALL(runner, present(test_pid,
@@ -633,7 +640,7 @@ TESTSUITE(test_runner)
       SET_WD(3);
       prepare_siginfo(test_pid, 3, CLD_EXITED, s);
 
-      REQUIRE_CALL(runner, calc_cputime(_))
+      REQUIRE_CALL(runner, calc_cputime(_, _))
         .RETURN(10U);
 
       REQUIRE_CALL(reg, crpcut_is_expected_exit(3))
@@ -677,7 +684,7 @@ TESTSUITE(test_runner)
       SET_WD(100);
       prepare_siginfo(test_pid, 15, CLD_KILLED, s);
 
-      REQUIRE_CALL(runner, calc_cputime(_))
+      REQUIRE_CALL(runner, calc_cputime(_, _))
         .RETURN(10U);
 
       REQUIRE_CALL(reg, crpcut_is_expected_signal(15))
@@ -726,7 +733,7 @@ TESTSUITE(test_runner)
 
       prepare_siginfo(test_pid, 9, CLD_KILLED, s);
 
-      REQUIRE_CALL(runner, calc_cputime(_))
+      REQUIRE_CALL(runner, calc_cputime(_, _))
         .RETURN(1000000U);
 
       REQUIRE_CALL(reg, crpcut_is_expected_signal(9))
@@ -774,7 +781,7 @@ TESTSUITE(test_runner)
 
       prepare_siginfo(test_pid, 6, CLD_KILLED, s);
 
-      REQUIRE_CALL(runner, calc_cputime(_))
+      REQUIRE_CALL(runner, calc_cputime(_, _))
         .RETURN(1000000U);
 
       REQUIRE_CALL(reg, crpcut_is_expected_signal(6))
@@ -819,7 +826,7 @@ TESTSUITE(test_runner)
 
       prepare_siginfo(test_pid, 6, CLD_KILLED, s);
 
-      REQUIRE_CALL(runner, calc_cputime(_))
+      REQUIRE_CALL(runner, calc_cputime(_, _))
         .RETURN(1000000U);
 
       REQUIRE_CALL(reg, crpcut_is_expected_signal(6))
@@ -858,7 +865,7 @@ TESTSUITE(test_runner)
 
       prepare_siginfo(test_pid, 6, CLD_DUMPED, s);
 
-      REQUIRE_CALL(runner, calc_cputime(_))
+      REQUIRE_CALL(runner, calc_cputime(_, _))
         .RETURN(1000000U);
 
       REQUIRE_CALL(reg, crpcut_is_expected_signal(6))
@@ -897,7 +904,7 @@ TESTSUITE(test_runner)
 
       prepare_siginfo(test_pid, 6, CLD_DUMPED, s);
 
-      REQUIRE_CALL(runner, calc_cputime(_))
+      REQUIRE_CALL(runner, calc_cputime(_, _))
         .RETURN(1000000U);
 
       REQUIRE_CALL(reg, get_location())
@@ -936,7 +943,7 @@ TESTSUITE(test_runner)
 
       prepare_siginfo(test_pid, 0, -1, s);
 
-      REQUIRE_CALL(runner, calc_cputime(_))
+      REQUIRE_CALL(runner, calc_cputime(_, _))
         .RETURN(1000000U);
 
       REQUIRE_CALL(reg, get_location())
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "../timeline.hpp"
+#include <crpcut.hpp>
+#include <string>
+extern "C" {
+#  include <unistd.h>
+}
+
+TESTSUITE(timeline)
+{
+  class fix
+  {
+  protected:
+    fix()
+    {
+      int rv = ::pipe(fds);
+      assert(rv == 0);
+    }
+    ~fix()
+    {
+      ::close(fds[0]);
+    }
+    std::string contents()
+    {
+      std::string rv;
+      char buff[4096];
+      ssize_t n;
+      while ((n = ::read(fds[0], buff, sizeof(buff))) > 0)
+        {
+          rv.append(buff, std::size_t(n));
+        }
+      return rv;
+    }
+    int fds[2];
+  };
+
+  TEST(slots_are_named_tracks, fix)
+  {
+    {
+      crpcut::timeline t(fds[1], 2);
+    }
+    std::string s = contents();
+    ASSERT_PRED(crpcut::match<crpcut::regex>("^[{]\"traceEvents\":[[]\n"),
+                s);
+    ASSERT_PRED(crpcut::match<crpcut::regex>("\"tid\":0,.*\"slot 0\""), s);
+    ASSERT_PRED(crpcut::match<crpcut::regex>("\"tid\":1,.*\"slot 1\""), s);
+    ASSERT_PRED(crpcut::match<crpcut::regex>("\n[]][}]\n$"), s);
+  }
+
+  TEST(events_are_separated_by_commas, fix)
+  {
+    {
+      crpcut::timeline t(fds[1], 1);
+      t.instant(0, "timeout");
+      t.stall(3);
+    }
+    std::string s = contents();
+    ASSERT_PRED(crpcut::match<crpcut::regex>(
+                  "[}],\n[{]\"ph\":\"i\",[^\n]*\"tid\":0,[^\n]*"
+                  "\"s\":\"t\",\"name\":\"timeout\"[}],\n"
+                  "[{]\"ph\":\"i\",[^\n]*\"s\":\"g\","
+                  "\"name\":\"dependency stall\","
+                  "\"args\":[{]\"running\":3[}][}]\n[]][}]\n$"),
+                s);
+  }
+
+  TEST(nothing_is_written_without_file)
+  {
+    crpcut::timeline t(-1, 1);
+    t.instant(0, "killed");
+    t.stall(1);
+  }
+}
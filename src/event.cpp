@@ -41,7 +41,5 @@ namespace crpcut {
   event
   ::~event()
   {
-    wrapped::free(msg_.str);
-    wrapped::free(location_.str);
   }
 }
@@ -30,6 +30,7 @@
 #include <crpcut.hpp>
 namespace crpcut {
 
+  // The strings are not owned by the event.
   struct event : public datatypes::list_elem<event>
   {
     event(comm::type t, datatypes::fixed_string msg, datatypes::fixed_string location);
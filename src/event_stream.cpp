@@ -0,0 +1,249 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "event_stream.hpp"
+#include "clocks/clocks.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace {
+#define QSTR(s) "\"" #s "\""
+  static const char *phase_name[] = { CRPCUT_TEST_PHASES(QSTR) };
+  static const char *kind_name[] = { CRPCUT_COMM_MSGS(QSTR) };
+#undef QSTR
+
+  // The length of the well formed UTF-8 sequence at p, or 0 if there is
+  // none. Overlong forms, surrogates and code points above U+10FFFF are
+  // not well formed.
+  std::size_t utf8_length(const unsigned char *p, std::size_t len)
+  {
+    if (p[0] < 0x80) return 1;
+    std::size_t n;
+    unsigned long cp;
+    if      ((p[0] & 0xe0) == 0xc0) { n = 2; cp = p[0] & 0x1fU; }
+    else if ((p[0] & 0xf0) == 0xe0) { n = 3; cp = p[0] & 0x0fU; }
+    else if ((p[0] & 0xf8) == 0xf0) { n = 4; cp = p[0] & 0x07U; }
+    else return 0;
+    if (n > len) return 0;
+    for (std::size_t i = 1; i < n; ++i)
+      {
+        if ((p[i] & 0xc0) != 0x80) return 0;
+        cp = (cp << 6) | (p[i] & 0x3fU);
+      }
+    static const unsigned long min_cp[] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (cp < min_cp[n] || cp > 0x10ffff) return 0;
+    if (cp >= 0xd800 && cp <= 0xdfff) return 0;
+    return n;
+  }
+
+  // Output from tests is written as is, except for what JSON requires
+  // to be escaped. Bytes that are not UTF-8 become U+FFFD, so that every
+  // line is JSON whatever the test writes.
+  std::ostream &quoted(std::ostream &os, const char *s, std::size_t len)
+  {
+    const unsigned char *p = reinterpret_cast<const unsigned char*>(s);
+    os << '"';
+    for (std::size_t i = 0; i < len; )
+      {
+        const char c = s[i];
+        switch (c)
+          {
+          case '"':  os << "\\\""; break;
+          case '\\': os << "\\\\"; break;
+          case '\n': os << "\\n";  break;
+          case '\r': os << "\\r";  break;
+          case '\t': os << "\\t";  break;
+          default:
+            if (p[i] < 0x20)
+              {
+                os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                   << int(c) << std::dec;
+              }
+            else if (const std::size_t n = utf8_length(p + i, len - i))
+              {
+                os.write(s + i, std::streamsize(n));
+                i += n;
+                continue;
+              }
+            else
+              {
+                os << "\\ufffd";
+              }
+          }
+        ++i;
+      }
+    return os << '"';
+  }
+
+  std::ostream &quoted(std::ostream &os, const std::string &s)
+  {
+    return quoted(os, s.data(), s.length());
+  }
+
+  std::ostream &quoted(std::ostream &os, crpcut::datatypes::fixed_string s)
+  {
+    return quoted(os, s.str, s.len);
+  }
+}
+
+namespace crpcut {
+
+  event_stream
+  ::event_stream(int fd)
+    : fd_(fd),
+      start_us_(clocks::monotonic::timestamp_absolute())
+  {
+  }
+
+  std::ostream &
+  event_stream
+  ::header(std::ostream &os, const char *event)
+  {
+    return os << "{\"event\":\"" << event << "\",\"time_us\":"
+              << clocks::monotonic::timestamp_absolute() - start_us_;
+  }
+
+  std::ostream &
+  event_stream
+  ::test_header(std::ostream &os, const char *event, const std::string &test)
+  {
+    header(os, event) << ",\"test\":";
+    return quoted(os, test);
+  }
+
+  void
+  event_stream
+  ::write(const std::string &s) const
+  {
+    const char *p = s.data();
+    std::size_t len = s.length();
+    while (len)
+      {
+        ssize_t rv = wrapped::write(fd_, p, len);
+        if (rv < 0 && errno == EINTR) continue;
+        if (rv <= 0) return;
+        p += rv;
+        len -= std::size_t(rv);
+      }
+  }
+
+  void
+  event_stream
+  ::scheduled(const std::string &test)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    test_header(os, "scheduled", test) << "}\n";
+    write(os.str());
+  }
+
+  void
+  event_stream
+  ::started(const std::string &test)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    test_header(os, "started", test) << "}\n";
+    write(os.str());
+  }
+
+  void
+  event_stream
+  ::phase(const std::string &test, test_phase p)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    test_header(os, "phase", test) << ",\"phase\":" << phase_name[p] << "}\n";
+    write(os.str());
+  }
+
+  void
+  event_stream
+  ::output(const std::string       &test,
+           comm::type               t,
+           datatypes::fixed_string  location,
+           datatypes::fixed_string  text)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    test_header(os, "output", test) << ",\"kind\":" << kind_name[t];
+    if (location.len)
+      {
+        quoted(os << ",\"location\":", location);
+      }
+    quoted(os << ",\"text\":", text) << "}\n";
+    write(os.str());
+  }
+
+  void
+  event_stream
+  ::finished(const std::string       &test,
+             bool                     pass,
+             bool                     critical,
+             test_phase               p,
+             unsigned long            duration_us,
+             unsigned long            cputime_us,
+             datatypes::fixed_string  reason)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    test_header(os, "finished", test)
+      << ",\"result\":" << (pass ? "\"passed\"" : "\"failed\"")
+      << ",\"critical\":" << (critical ? "true" : "false")
+      << ",\"phase\":" << phase_name[p]
+      << ",\"duration_us\":" << duration_us
+      << ",\"cputime_us\":" << cputime_us;
+    if (reason.len)
+      {
+        quoted(os << ",\"reason\":", reason);
+      }
+    os << "}\n";
+    write(os.str());
+  }
+
+  void
+  event_stream
+  ::blocked(const std::string &test)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    test_header(os, "blocked", test) << "}\n";
+    write(os.str());
+  }
+
+  void
+  event_stream
+  ::done(unsigned num_run, unsigned num_failed)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    header(os, "done") << ",\"run\":" << num_run
+                       << ",\"failed\":" << num_failed << "}\n";
+    write(os.str());
+  }
+}
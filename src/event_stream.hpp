@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef EVENT_STREAM_HPP
+#define EVENT_STREAM_HPP
+
+#include <crpcut.hpp>
+
+namespace crpcut {
+
+  // The life of each test as events, one JSON object per line, written
+  // as the presenter receives them, for following a run live. Every
+  // event has its name and the time in microseconds since the stream
+  // was opened, and all but the last its test. Lines are written
+  // unbuffered, since the stream may be written from the process that
+  // forks the tests. The stream does not own fd, which may have been
+  // inherited. Nothing is written if fd is -1.
+  class event_stream
+  {
+  public:
+    explicit event_stream(int fd);
+    void scheduled(const std::string &test);
+    void started(const std::string &test);
+    void phase(const std::string &test, test_phase phase);
+    void output(const std::string       &test,
+                comm::type               t,
+                datatypes::fixed_string  location,
+                datatypes::fixed_string  text);
+    void finished(const std::string       &test,
+                  bool                     pass,
+                  bool                     critical,
+                  test_phase               phase,
+                  unsigned long            duration_us,
+                  unsigned long            cputime_us,
+                  datatypes::fixed_string  reason);
+    // test was never run, since tests it depends on failed.
+    void blocked(const std::string &test);
+    void done(unsigned num_run, unsigned num_failed);
+  private:
+    event_stream(const event_stream&);
+    event_stream& operator=(const event_stream&);
+    std::ostream &header(std::ostream &os, const char *event);
+    std::ostream &test_header(std::ostream      &os,
+                              const char        *event,
+                              const std::string &test);
+    void write(const std::string &s) const;
+
+    int           fd_;
+    unsigned long start_us_;
+  };
+}
+
+#endif // EVENT_STREAM_HPP
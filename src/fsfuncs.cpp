@@ -28,6 +28,27 @@
 #include "wrapped/posix_encapsulation.hpp"
 extern "C" {
 #  include <dirent.h>
+#  include <fcntl.h>
+}
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+  // The process group from a stat file in /proc. The command name, which
+  // may contain anything, ends with the last ')' on the line.
+  bool read_pgrp(const std::string &name, pid_t &pgrp)
+  {
+    std::string line;
+    if (!crpcut::read_file(name, line)) return false;
+    const std::string::size_type pos = line.rfind(')');
+    if (pos == std::string::npos) return false;
+    std::istringstream is(line.substr(pos + 1));
+    char state;
+    pid_t ppid;
+    is >> state >> ppid >> pgrp;
+    return !is.fail();
+  }
 }
 
 namespace crpcut {
@@ -49,4 +70,74 @@ namespace crpcut {
       }
     return empty;
   }
+
+  std::vector<std::string> dir_entries(const char *name)
+  {
+    std::vector<std::string> entries;
+    if (DIR *d = wrapped::opendir(name))
+      {
+        char buff[sizeof(dirent) + PATH_MAX];
+        dirent *ent = reinterpret_cast<dirent*>(buff),*result = ent;
+        while (result && (wrapped::readdir_r(d, ent, &result) == 0) && result)
+          {
+            if (wrapped::strcmp(ent->d_name, ".") == 0 ||
+                wrapped::strcmp(ent->d_name, "..") == 0)
+              continue;
+            entries.push_back(ent->d_name);
+          }
+        wrapped::closedir(d);
+      }
+    return entries;
+  }
+  bool read_file(const std::string &name, std::string &contents)
+  {
+    int fd = wrapped::open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    contents.clear();
+    char buff[1024];
+    ssize_t rv;
+    for (;;)
+      {
+        rv = wrapped::read(fd, buff, sizeof(buff));
+        if (rv == -1 && errno == EINTR) continue;
+        if (rv <= 0) break;
+        contents.append(buff, std::size_t(rv));
+      }
+    wrapped::close(fd);
+    return rv == 0;
+  }
+
+  std::vector<pid_t> process_group(pid_t pgid)
+  {
+    std::vector<pid_t> members;
+    pid_t pgrp;
+    std::ostringstream os;
+    os << "/proc/" << pgid << "/stat";
+    if (!read_pgrp(os.str(), pgrp)) return members;
+    members.push_back(pgid);
+    process_groups groups;
+    read_process_groups(groups);
+    const std::vector<pid_t> &group = groups[pgid];
+    for (std::size_t i = 0; i < group.size(); ++i)
+      {
+        if (group[i] != pgid) members.push_back(group[i]);
+      }
+    return members;
+  }
+
+  void read_process_groups(process_groups &groups)
+  {
+    groups.clear();
+    const std::vector<std::string> entries = dir_entries("/proc");
+    for (std::size_t i = 0; i < entries.size(); ++i)
+      {
+        const char *name = entries[i].c_str();
+        if (*name < '1' || *name > '9') continue;
+        pid_t pgrp;
+        if (read_pgrp("/proc/" + entries[i] + "/stat", pgrp))
+          {
+            groups[pgrp].push_back(pid_t(std::atoi(name)));
+          }
+      }
+  }
 }
@@ -27,8 +27,23 @@
 #ifndef FSFUNCS_HPP
 #define FSFUNCS_HPP
 
+#include <map>
+#include <string>
+#include <vector>
+extern "C" {
+#  include <sys/types.h>
+}
+
 namespace crpcut {
   bool is_dir_empty(const char *name);
+  std::vector<std::string> dir_entries(const char *name);
+  bool read_file(const std::string &name, std::string &contents);
+  // The processes of process group pgid, as found in /proc, with pgid
+  // itself first. Empty if pgid is not a live process.
+  std::vector<pid_t> process_group(pid_t pgid);
+  // All processes in /proc, by process group, read in one pass.
+  typedef std::map<pid_t, std::vector<pid_t> > process_groups;
+  void read_process_groups(process_groups &groups);
 }
 
 #endif // FSFUNCS_HPP
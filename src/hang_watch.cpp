@@ -0,0 +1,270 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "hang_watch.hpp"
+#include "clocks/clocks.hpp"
+#include "fsfuncs.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#include <new>
+#include <sstream>
+#include <vector>
+
+namespace {
+  // The state, and the user and system CPU time, from a stat file in
+  // /proc. The command name, which may contain anything, ends with the
+  // last ')' on the line.
+  bool read_stat(const std::string &name, char &state, unsigned long &ticks)
+  {
+    std::string line;
+    if (!crpcut::read_file(name, line)) return false;
+    const std::string::size_type pos = line.rfind(')');
+    if (pos == std::string::npos) return false;
+    std::istringstream is(line.substr(pos + 1));
+    std::string field;
+    is >> state;
+    for (int i = 0; i < 10; ++i) is >> field;
+    unsigned long utime = 0, stime = 0;
+    is >> utime >> stime;
+    ticks = utime + stime;
+    return !is.fail();
+  }
+
+  std::string proc_dir(pid_t pid)
+  {
+    std::ostringstream os;
+    os << "/proc/" << pid << '/';
+    return os.str();
+  }
+
+  // The /proc directories of the threads of a process.
+  std::vector<std::string> list_threads(const std::string &proc_dir)
+  {
+    const std::string task_dir = proc_dir + "task/";
+    std::vector<std::string> threads
+      = crpcut::dir_entries(task_dir.c_str());
+    for (std::size_t i = 0; i < threads.size(); ++i)
+      {
+        threads[i] = task_dir + threads[i];
+      }
+    return threads;
+  }
+
+  // A zombie is as good as blocked, it will not make progress either.
+  bool is_blocked(char state)
+  {
+    return state == 'S' || state == 'D' || state == 'Z' || state == 'X';
+  }
+
+  // The process groups in /proc, read at most once per check, and only
+  // if a test process is blocked, since that means going through all of
+  // /proc. The same reading then serves all tests, and the description
+  // of any suspected one.
+  class group_scan
+  {
+  public:
+    group_scan() : groups_(), read_(false) {}
+    const std::vector<pid_t> &members(pid_t pgid)
+    {
+      if (!read_)
+        {
+          crpcut::read_process_groups(groups_);
+          read_ = true;
+        }
+      return groups_[pgid];
+    }
+  private:
+    crpcut::process_groups groups_;
+    bool                   read_;
+  };
+
+  bool sample_process(pid_t pid, unsigned long &ticks, bool &blocked)
+  {
+    const std::string dir = proc_dir(pid);
+    char state;
+    if (!read_stat(dir + "stat", state, ticks)) return false;
+    const std::vector<std::string> threads = list_threads(dir);
+    blocked = !threads.empty();
+    for (std::size_t i = 0; blocked && i < threads.size(); ++i)
+      {
+        unsigned long thread_ticks;
+        blocked = read_stat(threads[i] + "/stat", state, thread_ticks)
+          && is_blocked(state);
+      }
+    return true;
+  }
+
+  bool sample_group(pid_t pid, group_scan &scan,
+                    unsigned long &ticks, bool &blocked)
+  {
+    if (!sample_process(pid, ticks, blocked)) return false;
+    // Only if the test process itself is stuck are the other processes
+    // of the test looked for.
+    if (!blocked) return true;
+    const std::vector<pid_t> &group = scan.members(pid);
+    for (std::size_t i = 0; blocked && i < group.size(); ++i)
+      {
+        if (group[i] == pid) continue;
+        unsigned long process_ticks;
+        bool process_blocked;
+        if (!sample_process(group[i], process_ticks, process_blocked))
+          {
+            continue; // gone
+          }
+        ticks += process_ticks;
+        blocked = process_blocked;
+      }
+    return true;
+  }
+
+  std::string describe_group(pid_t pid, group_scan &scan)
+  {
+    std::vector<std::string> threads = list_threads(proc_dir(pid));
+    const std::vector<pid_t> &group = scan.members(pid);
+    for (std::size_t i = 0; i < group.size(); ++i)
+      {
+        if (group[i] == pid) continue;
+        const std::vector<std::string> t = list_threads(proc_dir(group[i]));
+        threads.insert(threads.end(), t.begin(), t.end());
+      }
+    std::ostringstream os;
+    for (std::size_t i = 0; i < threads.size(); ++i)
+      {
+        char state = '?';
+        unsigned long ticks;
+        std::string wchan;
+        read_stat(threads[i] + "/stat", state, ticks);
+        if (!crpcut::read_file(threads[i] + "/wchan", wchan)
+            || wchan.empty())
+          {
+            wchan = "?";
+          }
+        const std::string::size_type pos = threads[i].rfind('/');
+        os << "thread " << threads[i].substr(pos + 1) << ' ' << state
+           << " waiting in " << wchan << '\n';
+      }
+    return os.str();
+  }
+}
+
+namespace crpcut {
+
+  std::size_t
+  hang_watch
+  ::space_for(std::size_t num_slots)
+  {
+    return buffer_vector<slot>::space_for(num_slots);
+  }
+
+  hang_watch
+  ::hang_watch(void *storage, std::size_t num_slots,
+               unsigned long period_ms, bool kill)
+    : slots_(storage, num_slots),
+      period_us_(period_ms*1000),
+      interval_us_(period_ms >= 400 ? 100000 : period_ms*250),
+      kill_(kill),
+      next_check_us_(0)
+  {
+    const slot s = { 0, 0, 0, 0, false };
+    for (std::size_t i = 0; i < num_slots; ++i)
+      {
+        slots_.push_back(s);
+      }
+  }
+
+  void
+  hang_watch
+  ::begin_test(unsigned n, crpcut_test_case_registrator *reg, pid_t pid)
+  {
+    const slot s = { reg, pid, 0, clocks::monotonic::timestamp_absolute(),
+                     false };
+    slots_.at(n) = s;
+  }
+
+  void
+  hang_watch
+  ::end_test(unsigned n)
+  {
+    slots_.at(n).reg = 0;
+  }
+
+  int
+  hang_watch
+  ::ms_until_check() const
+  {
+    for (const slot *s = slots_.begin(); s != slots_.end(); ++s)
+      {
+        if (!s->reg || s->suspected) continue;
+        const unsigned long now = clocks::monotonic::timestamp_absolute();
+        if (now >= next_check_us_) return 0;
+        return int((next_check_us_ - now + 999) / 1000);
+      }
+    return -1;
+  }
+
+  void
+  hang_watch
+  ::check()
+  {
+    const unsigned long now = clocks::monotonic::timestamp_absolute();
+    if (now < next_check_us_) return;
+    next_check_us_ = now + interval_us_;
+    group_scan scan;
+    for (slot *s = slots_.begin(); s != slots_.end(); ++s)
+      {
+        if (!s->reg || s->suspected) continue;
+        unsigned long ticks;
+        bool blocked;
+        if (!sample_group(s->pid, scan, ticks, blocked)) continue;
+        if (ticks != s->ticks || !blocked)
+          {
+            s->ticks = ticks;
+            s->progress_us = now;
+            continue;
+          }
+        if (now - s->progress_us < period_us_) continue;
+        s->suspected = true;
+        s->reg->suspected_deadlock((now - s->progress_us) / 1000,
+                                   describe_group(s->pid, scan),
+                                   kill_);
+      }
+  }
+
+  bool
+  hang_watch
+  ::sample(pid_t pid, unsigned long &ticks, bool &blocked)
+  {
+    group_scan scan;
+    return sample_group(pid, scan, ticks, blocked);
+  }
+
+  std::string
+  hang_watch
+  ::describe_threads(pid_t pid)
+  {
+    group_scan scan;
+    return describe_group(pid, scan);
+  }
+}
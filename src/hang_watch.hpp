@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef HANG_WATCH_HPP
+#define HANG_WATCH_HPP
+
+#include <crpcut.hpp>
+#include "buffer_vector.hpp"
+
+namespace crpcut {
+
+  // Watches the running tests for suspected deadlocks, i.e. tests that
+  // have used no CPU time for a period, while all their threads are
+  // blocked in the kernel. The CPU time and the state of the threads
+  // are sampled from /proc/<pid>/stat and /proc/<pid>/task, so nothing
+  // is ever suspected where there is no /proc. The processes of a test
+  // are those in its process group, so a test waiting for a process it
+  // has started, or one in a PID namespace of its own, where the
+  // process the runner started only waits for it, is not suspected
+  // while that process makes progress. A suspected test is reported
+  // once, with the wait channel of each thread, and is killed if so
+  // configured.
+  class hang_watch
+  {
+    struct slot
+    {
+      crpcut_test_case_registrator *reg;
+      pid_t                         pid;
+      unsigned long                 ticks;
+      unsigned long                 progress_us;
+      bool                          suspected;
+    };
+  public:
+    static std::size_t space_for(std::size_t num_slots);
+    hang_watch(void *storage, std::size_t num_slots,
+               unsigned long period_ms, bool kill);
+    void begin_test(unsigned slot, crpcut_test_case_registrator *reg,
+                    pid_t pid);
+    void end_test(unsigned slot);
+    // -1 if no test is watched.
+    int ms_until_check() const;
+    void check();
+    // The CPU time, in clock ticks, used by the processes of process
+    // group pid, and whether all their threads are blocked. False if
+    // there is no such process.
+    static bool sample(pid_t pid, unsigned long &ticks, bool &blocked);
+    // A line for each thread of the processes of process group pid,
+    // with its id, state and wait channel.
+    static std::string describe_threads(pid_t pid);
+  private:
+    hang_watch(const hang_watch&);
+    hang_watch& operator=(const hang_watch&);
+
+    buffer_vector<slot> slots_;
+    const unsigned long period_us_;
+    const unsigned long interval_us_;
+    const bool          kill_;
+    unsigned long       next_check_us_;
+  };
+}
+
+#endif // HANG_WATCH_HPP
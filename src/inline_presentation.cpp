@@ -0,0 +1,159 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "inline_presentation.hpp"
+#include "output/buffer.hpp"
+#include "posix_error.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+extern "C" {
+#  include <fcntl.h>
+}
+
+namespace crpcut {
+
+  inline_presentation
+  ::inline_presentation(output::buffer            &buffer,
+                        output::formatter         &fmt,
+                        int                        fd,
+                        output::buffer            &summary_buffer,
+                        output::formatter         &summary_fmt,
+                        int                        summary_fd,
+                        bool                       verbose,
+                        const char                *working_dir,
+                        registrator_list          &reg,
+                        journal                   *log,
+                        const journal::entry_list &completed,
+                        run_statistics            *stats,
+                        event_stream              *events)
+    : reader_(fmt, summary_fmt, verbose, working_dir, reg, log, stats, events),
+      output_(buffer, fd),
+      summary_(summary_buffer, summary_fd)
+  {
+    for (const journal::entry *e = completed.first();
+         e;
+         e = completed.next_after(e))
+      {
+        reader_.replay(*e);
+      }
+    if (log) log->sync();
+  }
+
+  inline_presentation
+  ::~inline_presentation()
+  {
+  }
+
+  presentation_reader &
+  inline_presentation
+  ::reader()
+  {
+    return reader_;
+  }
+
+  bool
+  inline_presentation
+  ::write_output()
+  {
+    bool done = output_.write();
+    done &= summary_.write();
+    return done;
+  }
+
+  unsigned
+  inline_presentation
+  ::finish()
+  {
+    reader_.finish();
+    output_.write_all();
+    summary_.write_all();
+    return reader_.num_failed();
+  }
+
+  inline_presentation::destination
+  ::destination(output::buffer &buffer, int fd)
+    : buffer_(buffer),
+      fd_(fd),
+      flags_(fd < 0 ? 0 : wrapped::fcntl(fd, F_GETFL, 0)),
+      pos_(0)
+  {
+    if (fd_ >= 0 && flags_ >= 0)
+      {
+        wrapped::fcntl(fd_, F_SETFL, flags_ | O_NONBLOCK);
+      }
+  }
+
+  inline_presentation::destination
+  ::~destination()
+  {
+    if (fd_ >= 0 && flags_ >= 0)
+      {
+        wrapped::fcntl(fd_, F_SETFL, flags_);
+      }
+  }
+
+  bool
+  inline_presentation::destination
+  ::write()
+  {
+    while (!buffer_.is_empty())
+      {
+        if (fd_ < 0)
+          {
+            buffer_.advance();
+            continue;
+          }
+        static const std::size_t max_chunks = 64;
+        struct iovec v[max_chunks];
+        std::size_t count = buffer_.get_buffers(v, max_chunks);
+        v[0].iov_base = static_cast<char*>(v[0].iov_base) + pos_;
+        v[0].iov_len -= pos_;
+        ssize_t n = wrapped::writev(fd_, v, int(count));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == EAGAIN) return false;
+        if (n < 0) throw posix_error(errno, "writing test results");
+        std::size_t written = std::size_t(n);
+        for (std::size_t i = 0; i < count && written >= v[i].iov_len; ++i)
+          {
+            written -= v[i].iov_len;
+            pos_ = 0;
+            buffer_.advance();
+          }
+        pos_ += written;
+      }
+    return true;
+  }
+
+  void
+  inline_presentation::destination
+  ::write_all()
+  {
+    if (fd_ >= 0 && flags_ >= 0)
+      {
+        wrapped::fcntl(fd_, F_SETFL, flags_);
+      }
+    write();
+  }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef INLINE_PRESENTATION_HPP
+#define INLINE_PRESENTATION_HPP
+
+#include "presentation_reader.hpp"
+#include <cstddef>
+
+namespace crpcut {
+  namespace output {
+    class buffer;
+  }
+
+  // Presents the results from the process that runs the tests, instead
+  // of from a presenter process of its own. Frames are handed to the
+  // presentation_reader as they are written, and the output is written
+  // without blocking whenever the runner is about to wait.
+  class inline_presentation
+  {
+  public:
+    inline_presentation(output::buffer            &buffer,
+                        output::formatter         &fmt,
+                        int                        fd,
+                        output::buffer            &summary_buffer,
+                        output::formatter         &summary_fmt,
+                        int                        summary_fd,
+                        bool                       verbose,
+                        const char                *working_dir,
+                        registrator_list          &reg,
+                        journal                   *log,
+                        const journal::entry_list &completed,
+                        run_statistics            *stats = 0,
+                        event_stream              *events = 0);
+    ~inline_presentation();
+    presentation_reader &reader();
+    // Returns false if some output could not be written without blocking.
+    bool write_output();
+    // Presents the statistics, and writes all remaining output.
+    unsigned finish();
+  private:
+    class destination
+    {
+    public:
+      destination(output::buffer &buffer, int fd);
+      ~destination();
+      bool write();
+      void write_all();
+    private:
+      output::buffer &buffer_;
+      const int       fd_;
+      int             flags_;
+      std::size_t     pos_;
+      destination(const destination&);
+      destination& operator=(const destination&);
+    };
+
+    presentation_reader reader_;
+    destination         output_;
+    destination         summary_;
+    inline_presentation(const inline_presentation&);
+    inline_presentation& operator=(const inline_presentation&);
+  };
+}
+
+#endif // INLINE_PRESENTATION_HPP
@@ -0,0 +1,360 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "journal.hpp"
+#include "printer.hpp"
+#include "posix_error.hpp"
+#include "registrator_list.hpp"
+#include "output/formatter.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#include <map>
+#include <cstring>
+extern "C" {
+#  include <fcntl.h>
+}
+
+namespace {
+  static const char        magic[]  = "crpcut journal 1\n";
+  static const std::size_t magic_len = sizeof(magic) - 1;
+
+  enum { op_print = 'p', op_terminate = 't', op_metric = 'm' };
+
+  struct record_header
+  {
+    unsigned len;
+    unsigned checksum;
+  };
+
+  unsigned checksum(const char *p, std::size_t len)
+  {
+    unsigned sum = 2166136261U; // FNV-1a
+    while (len--)
+      {
+        sum ^= static_cast<unsigned char>(*p++);
+        sum *= 16777619U;
+      }
+    return sum;
+  }
+
+  template <typename T>
+  void put(std::string &s, T v)
+  {
+    s.append(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+
+  void put(std::string &s, const char *str, std::size_t len)
+  {
+    put(s, static_cast<unsigned>(len));
+    s.append(str, len);
+  }
+
+  class bad_record {};
+
+  class cursor
+  {
+  public:
+    cursor(const std::string &s, std::size_t pos) : s_(s), pos_(pos) {}
+    template <typename T>
+    T get()
+    {
+      T v;
+      std::memcpy(&v, reserve(sizeof(v)), sizeof(v));
+      return v;
+    }
+    crpcut::datatypes::fixed_string get_string()
+    {
+      crpcut::datatypes::fixed_string rv;
+      rv.len = get<unsigned>();
+      rv.str = reserve(rv.len);
+      return rv;
+    }
+    bool at_end() const { return pos_ == s_.length(); }
+    std::size_t pos() const { return pos_; }
+  private:
+    const char *reserve(std::size_t n)
+    {
+      if (s_.length() - pos_ < n) throw bad_record();
+      const char *p = s_.data() + pos_;
+      pos_ += n;
+      return p;
+    }
+    const std::string &s_;
+    std::size_t        pos_;
+  };
+
+  void write_all(int fd, const char *p, std::size_t len)
+  {
+    while (len)
+      {
+        ssize_t rv = crpcut::wrapped::write(fd, p, len);
+        if (rv == -1 && errno == EINTR) continue;
+        if (rv <= 0) throw crpcut::posix_error(errno, "writing journal");
+        p   += rv;
+        len -= std::size_t(rv);
+      }
+  }
+}
+
+namespace crpcut {
+
+  journal
+  ::journal(int fd, unsigned sync_interval, bool continued)
+    : fd_(fd),
+      sync_interval_(sync_interval),
+      num_unsynced_(0),
+      continued_(continued)
+  {
+    if (fd_ >= 0 && !continued_)
+      {
+        write_all(fd_, magic, magic_len);
+      }
+  }
+
+  journal
+  ::~journal()
+  {
+    if (fd_ >= 0)
+      {
+        sync();
+        wrapped::close(fd_);
+      }
+  }
+
+  void
+  journal
+  ::begin_case(const std::string &name,
+               bool               result,
+               bool               critical,
+               unsigned long      duration_us)
+  {
+    body_.clear();
+    put(body_, name.data(), name.length());
+    put(body_, static_cast<unsigned char>(result));
+    put(body_, static_cast<unsigned char>(critical));
+    put(body_, duration_us);
+  }
+
+  void
+  journal
+  ::print(datatypes::fixed_string label,
+          datatypes::fixed_string data,
+          datatypes::fixed_string location)
+  {
+    put(body_, static_cast<unsigned char>(op_print));
+    put(body_, label.str, label.len);
+    put(body_, data.str, data.len);
+    put(body_, location.str, location.len);
+  }
+
+  void
+  journal
+  ::terminate(test_phase              phase,
+              datatypes::fixed_string msg,
+              datatypes::fixed_string location,
+              const std::string      &dirname)
+  {
+    put(body_, static_cast<unsigned char>(op_terminate));
+    put(body_, phase);
+    put(body_, msg.str, msg.len);
+    put(body_, location.str, location.len);
+    put(body_, dirname.data(), dirname.length());
+  }
+
+  void
+  journal
+  ::metric(datatypes::fixed_string name,
+           datatypes::fixed_string value)
+  {
+    put(body_, static_cast<unsigned char>(op_metric));
+    put(body_, name.str, name.len);
+    put(body_, value.str, value.len);
+  }
+
+  void
+  journal
+  ::end_case()
+  {
+    write_record(body_);
+  }
+
+  void
+  journal
+  ::append(const entry &e)
+  {
+    if (continued_) return;
+    write_record(e.body_);
+  }
+
+  void
+  journal
+  ::write_record(const std::string &body)
+  {
+    if (fd_ < 0) return;
+    try {
+      record_header hdr = { unsigned(body.length()),
+                            checksum(body.data(), body.length()) };
+      write_all(fd_, reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+      write_all(fd_, body.data(), body.length());
+      if (++num_unsynced_ >= sync_interval_)
+        {
+          sync();
+        }
+    }
+    catch (posix_error &e)
+    {
+      // A failing journal must not stop the test run, but the
+      // remainder of the journal would be of no use.
+      std::cerr << "crpcut: " << e.what() << ", journal abandoned\n";
+      wrapped::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  void
+  journal
+  ::sync()
+  {
+    if (fd_ < 0 || num_unsynced_ == 0) return;
+    (void)wrapped::fsync(fd_);
+    num_unsynced_ = 0;
+  }
+
+  long
+  journal
+  ::load(const char *path, entry_list &entries)
+  {
+    int fd = wrapped::open(path, O_RDONLY, 0);
+    if (fd < 0) return -1;
+    std::string contents;
+    char buff[8192];
+    for (;;)
+      {
+        ssize_t rv = wrapped::read(fd, buff, sizeof(buff));
+        if (rv == -1 && errno == EINTR) continue;
+        if (rv <= 0) break;
+        contents.append(buff, std::size_t(rv));
+      }
+    wrapped::close(fd);
+    if (contents.compare(0, magic_len, magic) != 0) return -1;
+
+    std::size_t intact = magic_len;
+    try {
+      while (intact < contents.length())
+        {
+          cursor c(contents, intact);
+          record_header hdr = c.get<record_header>();
+          if (contents.length() - c.pos() < hdr.len) break;
+          std::string body(contents, c.pos(), hdr.len);
+          if (checksum(body.data(), body.length()) != hdr.checksum) break;
+          entry *e = new entry(body);
+          e->link_before(entries);
+          intact = c.pos() + hdr.len;
+        }
+    }
+    catch (bad_record &)
+    {
+    }
+    return long(intact);
+  }
+
+  void
+  journal
+  ::skip_completed(registrator_list &reg, entry_list &entries)
+  {
+    typedef std::map<std::string, entry*> index_t;
+    index_t index;
+    for (entry *e = entries.first(); e; e = entries.next_after(e))
+      {
+        index[e->name()] = e;
+      }
+    for (crpcut_test_case_registrator *i = reg.first(); i;)
+      {
+        crpcut_test_case_registrator *r = i;
+        i = reg.next_after(i);
+        std::ostringstream os;
+        os << *r;
+        index_t::iterator found = index.find(os.str());
+        if (found == index.end()) continue;
+        found->second->test = r;
+        r->unlink();
+        r->crpcut_register_success(found->second->result());
+      }
+    for (entry *e = entries.first(); e;)
+      {
+        entry *current = e;
+        e = entries.next_after(e);
+        if (!current->test) delete current;
+      }
+  }
+
+  journal::entry
+  ::entry(const std::string &body)
+    : test(0),
+      body_(body)
+  {
+    cursor c(body_, 0);
+    datatypes::fixed_string name = c.get_string();
+    name_.assign(name.str, name.len);
+    result_      = c.get<unsigned char>();
+    critical_    = c.get<unsigned char>();
+    duration_us_ = c.get<unsigned long>();
+    ops_offset_  = c.pos();
+  }
+
+  void
+  journal::entry
+  ::replay(output::formatter &fmt) const
+  {
+    printer print(fmt, name_, result_, critical_, duration_us_);
+    cursor c(body_, ops_offset_);
+    while (!c.at_end())
+      {
+        const unsigned char op = c.get<unsigned char>();
+        if (op == op_print)
+          {
+            datatypes::fixed_string label    = c.get_string();
+            datatypes::fixed_string data     = c.get_string();
+            datatypes::fixed_string location = c.get_string();
+            fmt.print(label, data, location);
+          }
+        else if (op == op_metric)
+          {
+            datatypes::fixed_string name  = c.get_string();
+            datatypes::fixed_string value = c.get_string();
+            fmt.metric(name, value);
+          }
+        else
+          {
+            test_phase              phase    = c.get<test_phase>();
+            datatypes::fixed_string msg      = c.get_string();
+            datatypes::fixed_string location = c.get_string();
+            datatypes::fixed_string dirname  = c.get_string();
+            fmt.terminate(phase, msg, location,
+                          std::string(dirname.str, dirname.len));
+          }
+      }
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <crpcut.hpp>
+
+namespace crpcut {
+  class registrator_list;
+  namespace output {
+    class formatter;
+  }
+
+  // A crash safe record of completed test results, kept by the presenter
+  // so that an interrupted run can be resumed. A result is recorded as the
+  // sequence of formatter calls made for it. Every record is written with
+  // its length and a checksum, so that a record torn by a crash is detected
+  // and ignored when the journal is read back.
+  class journal
+  {
+  public:
+    class entry;
+    typedef datatypes::list_elem<entry> entry_list;
+
+    // A continued journal already holds the records of the run it
+    // resumes, so appending replayed entries to it is a no-op.
+    journal(int fd, unsigned sync_interval, bool continued);
+    ~journal();
+    void begin_case(const std::string &name,
+                    bool               result,
+                    bool               critical,
+                    unsigned long      duration_us);
+    void print(datatypes::fixed_string label,
+               datatypes::fixed_string data,
+               datatypes::fixed_string location);
+    void terminate(test_phase              phase,
+                   datatypes::fixed_string msg,
+                   datatypes::fixed_string location,
+                   const std::string      &dirname);
+    void metric(datatypes::fixed_string name,
+                datatypes::fixed_string value);
+    void end_case();
+    void append(const entry &e);
+    void sync();
+
+    // Reads all intact records from the journal file at path. Returns the
+    // length of the intact part of the file, or -1 if it could not be
+    // read as a journal.
+    static long load(const char *path, entry_list &entries);
+
+    // Removes the tests with a recorded result from reg, and registers
+    // their outcome for dependency purposes. Entries for tests not in reg
+    // are discarded.
+    static void skip_completed(registrator_list &reg, entry_list &entries);
+  private:
+    void write_record(const std::string &body);
+
+    int          fd_;
+    unsigned     sync_interval_;
+    unsigned     num_unsynced_;
+    bool         continued_;
+    std::string  body_;
+    journal(const journal&);
+    journal& operator=(const journal&);
+  };
+
+  class journal::entry : public datatypes::list_elem<entry>
+  {
+  public:
+    entry(const std::string &body);
+    const std::string &name() const { return name_; }
+    bool result() const { return result_; }
+    void replay(output::formatter &fmt) const;
+    crpcut_test_case_registrator *test;
+  private:
+    friend class journal;
+    std::string  body_;
+    std::string  name_;
+    bool         result_;
+    bool         critical_;
+    unsigned long duration_us_;
+    std::size_t  ops_offset_;
+  };
+}
+
+#endif // JOURNAL_HPP
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include "namespace_isolation.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+
+#ifdef HAVE_UNSHARE
+extern "C" {
+#  include <fcntl.h>
+#  include <net/if.h>
+#  include <netinet/in.h>
+#  include <sched.h>
+#  include <sys/ioctl.h>
+#  include <sys/mount.h>
+#  include <sys/wait.h>
+}
+#include <cassert>
+
+namespace {
+  bool write_file(const char *name, const char *data, std::size_t len)
+  {
+    int fd = crpcut::wrapped::open(name, O_WRONLY, 0);
+    if (fd < 0) return false;
+    ssize_t rv = crpcut::wrapped::write(fd, data, len);
+    crpcut::wrapped::close(fd);
+    return rv == ssize_t(len);
+  }
+
+  bool map_id(const char *name, unsigned long id)
+  {
+    crpcut::stream::toastream<64> os;
+    os << id << ' ' << id << " 1\n";
+    return write_file(name, os.begin(), os.size());
+  }
+
+  // Privileged processes get the namespaces directly. Others must first
+  // become root in a user namespace of their own, where they keep their
+  // ids so that files left in the working directory are theirs.
+  // Returns 0 on success, -1 if namespaces are unavailable, and 1 if the
+  // namespaces were created but the id mapping failed.
+  int unshare_namespaces(int flags)
+  {
+    if (crpcut::wrapped::unshare(flags) == 0) return 0;
+    if (errno != EPERM) return -1;
+
+    const unsigned long uid = crpcut::wrapped::getuid();
+    const unsigned long gid = crpcut::wrapped::getgid();
+    if (crpcut::wrapped::unshare(flags | CLONE_NEWUSER) != 0) return -1;
+
+    // setgroups does not exist on kernels older than 3.19, where the
+    // gid_map can be written without it
+    static const char deny[] = "deny";
+    write_file("/proc/self/setgroups", deny, sizeof(deny) - 1);
+    if (!map_id("/proc/self/uid_map", uid)) return 1;
+    if (!map_id("/proc/self/gid_map", gid)) return 1;
+    return 0;
+  }
+
+  bool bring_up_loopback()
+  {
+    int fd = crpcut::wrapped::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return false;
+    struct ifreq req = ifreq();
+    crpcut::wrapped::memcpy(req.ifr_name, "lo", 3);
+    bool ok = crpcut::wrapped::ioctl(fd, SIOCGIFFLAGS, &req) == 0;
+    if (ok)
+      {
+        req.ifr_flags |= IFF_UP | IFF_RUNNING;
+        ok = crpcut::wrapped::ioctl(fd, SIOCSIFFLAGS, &req) == 0;
+      }
+    crpcut::wrapped::close(fd);
+    return ok;
+  }
+
+  bool mount_private_tmp()
+  {
+    // The working directory usually lives under /tmp. The test process
+    // is already in it, so it stays reachable below the new mount.
+    return crpcut::wrapped::mount(0, "/", 0, MS_REC | MS_PRIVATE, 0) == 0
+      && crpcut::wrapped::mount("tmpfs", "/tmp", "tmpfs",
+                                MS_NOSUID | MS_NODEV, "mode=1777") == 0;
+  }
+
+  siginfo_t wait_for(pid_t pid)
+  {
+    siginfo_t info;
+    int rv;
+    do {
+      rv = crpcut::wrapped::waitid(P_PID, id_t(pid), &info, WEXITED);
+    } while (rv == -1 && errno == EINTR);
+    assert(rv == 0);
+    return info;
+  }
+
+  // Process 1 in a PID namespace is immune to signals it does not handle,
+  // so the test runs as process 2. Its death is passed on through a pipe
+  // to the process outside the namespace, which dies the same way, since
+  // that is the death the runner sees. A core dump is not repeated, so a
+  // test that dumps core appears killed by the signal.
+  CRPCUT_NORETURN void reproduce_death(pid_t pid, int status_fd)
+  {
+    siginfo_t info = wait_for(pid);
+    int death[2] = { info.si_code, info.si_status };
+    crpcut::wrapped::read(status_fd, death, sizeof(death));
+    if (death[0] == CLD_EXITED) crpcut::wrapped::_Exit(death[1]);
+
+    rlimit r = { 0, 0 };
+    crpcut::wrapped::setrlimit(RLIMIT_CORE, &r);
+    crpcut::wrapped::signal(death[1], SIG_DFL);
+    crpcut::wrapped::kill(crpcut::wrapped::getpid(), death[1]);
+    crpcut::wrapped::_Exit(1);
+  }
+
+  void fork_into_pid_namespace()
+  {
+    int status[2];
+    if (crpcut::wrapped::pipe(status) != 0) return;
+
+    pid_t init = crpcut::wrapped::fork();
+    if (init < 0) crpcut::wrapped::_Exit(1);
+    if (init > 0)
+      {
+        crpcut::wrapped::close(status[1]);
+        reproduce_death(init, status[0]);
+      }
+    crpcut::wrapped::close(status[0]);
+    pid_t test = crpcut::wrapped::fork();
+    if (test < 0) crpcut::wrapped::_Exit(1);
+    if (test > 0)
+      {
+        siginfo_t info = wait_for(test);
+        int death[2] = { info.si_code, info.si_status };
+        crpcut::wrapped::write(status[1], death, sizeof(death));
+        crpcut::wrapped::_Exit(0);
+      }
+    crpcut::wrapped::close(status[1]);
+  }
+}
+
+namespace crpcut {
+  void enter_namespaces(unsigned flags, datatypes::fixed_string location)
+  {
+    int clone_flags = 0;
+    if (flags & isolate::network) clone_flags |= CLONE_NEWNET;
+    if (flags & isolate::tmp)     clone_flags |= CLONE_NEWNS;
+    if (flags & isolate::pid)     clone_flags |= CLONE_NEWPID;
+
+    int rv = unshare_namespaces(clone_flags);
+    if (rv < 0)
+      {
+        stream::toastream<256> os;
+        os << "Running without isolation, namespaces are unavailable: "
+           << wrapped::strerror(errno);
+        comm::report(comm::info, os, location);
+        return;
+      }
+    if (rv > 0)
+      {
+        comm::report(comm::exit_fail,
+                     "Failed to map user id in isolated namespaces",
+                     location);
+      }
+    if ((flags & isolate::network) && !bring_up_loopback())
+      {
+        comm::report(comm::exit_fail,
+                     "Failed to bring up loopback in isolated namespace",
+                     location);
+      }
+    if ((flags & isolate::tmp) && !mount_private_tmp())
+      {
+        comm::report(comm::exit_fail,
+                     "Failed to mount private /tmp in isolated namespace",
+                     location);
+      }
+    if (flags & isolate::pid)
+      {
+        fork_into_pid_namespace();
+        if (flags & isolate::tmp)
+          {
+            wrapped::mount("proc", "/proc", "proc",
+                           MS_NOSUID | MS_NODEV | MS_NOEXEC, 0);
+          }
+      }
+  }
+}
+#else
+namespace crpcut {
+  void enter_namespaces(unsigned, datatypes::fixed_string location)
+  {
+    comm::report(comm::info,
+                 "Running without isolation, namespaces are not supported "
+                 "on this system",
+                 location);
+  }
+}
+#endif
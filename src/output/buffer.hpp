@@ -31,6 +31,7 @@
 #include <utility>
 extern "C" {
 #  include <sys/types.h>
+#  include <sys/uio.h>
 }
 namespace crpcut {
   namespace output {
@@ -42,9 +43,25 @@ namespace crpcut {
       virtual void advance() = 0;
       virtual ssize_t write(const char *buff, std::size_t len) = 0;
       virtual bool is_empty() const = 0;
+      // Fills v with at most max of the chunks not yet advanced past,
+      // in order, and returns how many. The first is get_buffer().
+      virtual std::size_t get_buffers(struct iovec *v, std::size_t max) const;
     private:
     };
 
+    inline
+    std::size_t
+    buffer
+    ::get_buffers(struct iovec *v, std::size_t max) const
+    {
+      if (max == 0) return 0;
+      std::pair<const char*, std::size_t> data = get_buffer();
+      if (data.second == 0) return 0;
+      v[0].iov_base = const_cast<char*>(data.first);
+      v[0].iov_len  = data.second;
+      return 1;
+    }
+
 
   }
 }
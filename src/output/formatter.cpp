@@ -39,6 +39,12 @@ namespace crpcut {
       return str[phase];
     }
 
+    void
+    formatter
+    ::summary(const run_statistics &)
+    {
+    }
+
     formatter
     ::~formatter()
     {
@@ -31,6 +31,7 @@
 #include <crpcut.hpp>
 #include <iosfwd>
 namespace crpcut {
+  class run_statistics;
   namespace output {
     class buffer;
 
@@ -49,6 +50,11 @@ namespace crpcut {
       virtual void print(datatypes::fixed_string label,
                          datatypes::fixed_string data,
                          datatypes::fixed_string location) = 0;
+      virtual void metric(datatypes::fixed_string name,
+                          datatypes::fixed_string value) = 0;
+      // The slowest tests, and how the time of the run was spent.
+      // Presented just before the statistics.
+      virtual void summary(const run_statistics &s);
       virtual void statistics(unsigned num_run,
                               unsigned num_failed) = 0;
       virtual void nonempty_dir(const  char*)  = 0;
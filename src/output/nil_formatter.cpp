@@ -77,6 +77,13 @@ namespace crpcut {
     {
     }
 
+    void
+    nil_formatter
+    ::metric(datatypes::fixed_string /*name*/,
+             datatypes::fixed_string /*value*/)
+    {
+    }
+
     void
     nil_formatter
     ::statistics(unsigned /*num_run*/,
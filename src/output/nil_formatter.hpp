@@ -55,6 +55,8 @@ namespace crpcut {
       virtual void print(datatypes::fixed_string label,
                          datatypes::fixed_string data,
                          datatypes::fixed_string location);
+      virtual void metric(datatypes::fixed_string name,
+                          datatypes::fixed_string value);
       virtual void statistics(unsigned num_run,
                               unsigned num_failed);
       virtual void nonempty_dir(const char *s);
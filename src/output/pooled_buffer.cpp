@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "pooled_buffer.hpp"
+#include "../wrapped/posix_encapsulation.hpp"
+#include <algorithm>
+
+namespace crpcut {
+  namespace output {
+
+    struct pooled_buffer::segment
+    {
+      segment() : next_(0), len_(0) {}
+
+      segment     *next_;
+      std::size_t  len_;
+      char         mem_[segment_size];
+    };
+
+    const std::size_t pooled_buffer::segment_size;
+    const std::size_t pooled_buffer::max_spare;
+
+    pooled_buffer
+    ::pooled_buffer()
+      : head_(0),
+        tail_(0),
+        spare_(0),
+        num_spare_(0)
+    {
+    }
+
+    pooled_buffer
+    ::~pooled_buffer()
+    {
+      while (head_)
+        {
+          segment *tmp = head_;
+          head_ = head_->next_;
+          delete tmp;
+        }
+      while (spare_)
+        {
+          segment *tmp = spare_;
+          spare_ = spare_->next_;
+          delete tmp;
+        }
+    }
+
+    ssize_t
+    pooled_buffer
+    ::write(const char *buff, std::size_t len)
+    {
+      if (!tail_ || tail_->len_ == segment_size)
+        {
+          segment *s = spare_;
+          if (s)
+            {
+              spare_ = s->next_;
+              --num_spare_;
+              s->next_ = 0;
+              s->len_ = 0;
+            }
+          else
+            {
+              s = new segment;
+            }
+          if (tail_) tail_->next_ = s; else head_ = s;
+          tail_ = s;
+        }
+      std::size_t size = std::min(len, segment_size - tail_->len_);
+      wrapped::memcpy(tail_->mem_ + tail_->len_, buff, size);
+      tail_->len_ += size;
+      return ssize_t(size);
+    }
+
+    std::pair<const char *, std::size_t>
+    pooled_buffer
+    ::get_buffer() const
+    {
+      static const char *null = 0;
+      static const std::size_t zero = 0;
+
+      if (!head_) return std::make_pair(null, zero);
+
+      return std::make_pair(head_->mem_, head_->len_);
+    }
+
+    std::size_t
+    pooled_buffer
+    ::get_buffers(struct iovec *v, std::size_t max) const
+    {
+      std::size_t n = 0;
+      for (segment *s = head_; s && n < max; s = s->next_)
+        {
+          v[n].iov_base = s->mem_;
+          v[n].iov_len  = s->len_;
+          ++n;
+        }
+      return n;
+    }
+
+    void
+    pooled_buffer
+    ::advance()
+    {
+      segment *s = head_;
+      if (!s) return;
+      head_ = s->next_;
+      if (!head_) tail_ = 0;
+      if (num_spare_ == max_spare)
+        {
+          delete s;
+          return;
+        }
+      s->next_ = spare_;
+      spare_ = s;
+      ++num_spare_;
+    }
+
+    bool
+    pooled_buffer
+    ::is_empty() const
+    {
+      return !head_;
+    }
+  }
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef OUTPUT_POOLED_BUFFER_HPP
+#define OUTPUT_POOLED_BUFFER_HPP
+
+#include "buffer.hpp"
+
+namespace crpcut {
+  namespace output {
+    // Output kept in large segments, so that a report is written with
+    // few system calls. Segments that have been written are kept for
+    // reuse, a few at most.
+    class pooled_buffer : public buffer
+    {
+    public:
+      static const std::size_t segment_size = 65536;
+      static const std::size_t max_spare = 4;
+      pooled_buffer();
+      ~pooled_buffer();
+      virtual std::pair<const char*, std::size_t> get_buffer() const;
+      virtual void advance();
+      virtual ssize_t write(const char *buff, std::size_t len);
+      virtual bool is_empty() const;
+      virtual std::size_t get_buffers(struct iovec *v, std::size_t max) const;
+    private:
+      pooled_buffer(const pooled_buffer&);
+      pooled_buffer& operator=(const pooled_buffer&);
+
+      struct segment;
+
+      segment     *head_;
+      segment     *tail_;
+      segment     *spare_;
+      std::size_t  num_spare_;
+    };
+  }
+}
+
+#endif // OUTPUT_POOLED_BUFFER_HPP
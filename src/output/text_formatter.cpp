@@ -171,6 +171,14 @@ namespace crpcut {
       write("\n", conversion_type_);
     }
 
+    void
+    text_formatter
+    ::metric(datatypes::fixed_string /*name*/,
+             datatypes::fixed_string /*value*/)
+    {
+      // measurements are for tools, and only make it to the XML report
+    }
+
     void
     text_formatter
     ::display_tag_list_header()
@@ -187,6 +195,114 @@ namespace crpcut {
       write(os, conversion_type_);
     }
 
+    void
+    text_formatter
+    ::display_distributions(const char                          *title,
+                            const run_statistics::distributions &d)
+    {
+      if (d.empty()) return;
+      std::size_t width = wrapped::strlen(title);
+      typedef run_statistics::distributions::const_iterator iter;
+      for (iter i = d.begin(); i != d.end(); ++i)
+        {
+          width = std::max(width, i->name.length());
+        }
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(1)
+         << " " << std::setw(int(width))
+         << std::setiosflags(std::ios::left) << title
+         << std::resetiosflags(std::ios::left)
+         << std::setw(8) << "count"
+         << std::setw(10) << "p50 ms"
+         << std::setw(10) << "p90 ms"
+         << std::setw(10) << "max ms"
+         << '\n';
+      for (iter i = d.begin(); i != d.end(); ++i)
+        {
+          os << " " << std::setw(int(width))
+             << std::setiosflags(std::ios::left) << i->name
+             << std::resetiosflags(std::ios::left)
+             << std::setw(8) << i->count
+             << std::setw(10) << double(i->p50_us)/1000
+             << std::setw(10) << double(i->p90_us)/1000
+             << std::setw(10) << double(i->max_us)/1000
+             << '\n';
+        }
+      write(os, conversion_type_);
+    }
+
+    void
+    text_formatter
+    ::display_overhead(const run_statistics::figures &f)
+    {
+      if (f.empty()) return;
+      std::size_t width = 0;
+      typedef run_statistics::figures::const_iterator iter;
+      for (iter i = f.begin(); i != f.end(); ++i)
+        {
+          width = std::max(width, i->name.length());
+        }
+      std::ostringstream os;
+      os << "Overhead of running the tests:\n"
+         << " " << std::setw(int(width))
+         << std::setiosflags(std::ios::left) << "figure"
+         << std::resetiosflags(std::ios::left)
+         << std::setw(8) << "count"
+         << std::setw(12) << "mean"
+         << std::setw(12) << "max"
+         << '\n';
+      for (iter i = f.begin(); i != f.end(); ++i)
+        {
+          os << " " << std::setw(int(width))
+             << std::setiosflags(std::ios::left) << i->name
+             << std::resetiosflags(std::ios::left)
+             << std::setw(8) << i->count
+             << std::setw(12) << i->mean
+             << std::setw(12) << i->max
+             << '\n';
+        }
+      write(os, conversion_type_);
+    }
+
+    void
+    text_formatter
+    ::summary(const run_statistics &s)
+    {
+      if (s.empty()) return;
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(1) << "Slowest tests:\n";
+      const run_statistics::test_times slowest = s.slowest();
+      typedef run_statistics::test_times::const_iterator iter;
+      for (iter i = slowest.begin(); i != slowest.end(); ++i)
+        {
+          os << std::setw(12) << double(i->duration_us)/1000 << " ms  "
+             << i->name << '\n';
+        }
+      write(os, conversion_type_);
+      display_distributions("suite", s.per_suite());
+      display_distributions("tag", s.per_tag());
+
+      std::ostringstream ts;
+      ts << std::fixed << std::setprecision(3)
+         << "CPU time " << double(s.cputime_us())/1000000
+         << "s over " << double(s.walltime_us())/1000000 << "s wall time\n";
+      const double slot_us = double(s.busy_slot_us()
+                                    + s.blocked_slot_us()
+                                    + s.idle_slot_us());
+      if (slot_us > 0)
+        {
+          ts << std::setprecision(1)
+             << "Slot utilisation " << 100*double(s.busy_slot_us())/slot_us
+             << "% of " << s.num_slots() << " slots, idle "
+             << 100*double(s.blocked_slot_us())/slot_us
+             << "% blocked by dependencies and "
+             << 100*double(s.idle_slot_us())/slot_us
+             << "% otherwise\n";
+        }
+      write(ts, conversion_type_);
+      display_overhead(s.overhead());
+    }
+
     void
     text_formatter
     ::statistics(unsigned num_run,
@@ -30,6 +30,7 @@
 #include <vector>
 #include "formatter.hpp"
 #include "writer.hpp"
+#include "../run_statistics.hpp"
 
 namespace crpcut {
   namespace output {
@@ -60,6 +61,9 @@ namespace crpcut {
       virtual void print(datatypes::fixed_string label,
                          datatypes::fixed_string data,
                          datatypes::fixed_string location);
+      virtual void metric(datatypes::fixed_string name,
+                          datatypes::fixed_string value);
+      virtual void summary(const run_statistics &s);
       virtual void statistics(unsigned num_run,
                               unsigned num_failed);
       virtual void nonempty_dir(const char *s);
@@ -68,6 +72,9 @@ namespace crpcut {
       void tag_summary(const tag& t) const;
       static const text_modifier& default_text_modifier();
       void display_tag_list_header();
+      void display_distributions(const char                          *title,
+                                 const run_statistics::distributions &d);
+      void display_overhead(const run_statistics::figures &f);
 
       bool                 did_output_;
       bool                 blocked_tests_;
@@ -61,6 +61,7 @@ namespace crpcut {
                xml_replacement(get_illegal_char_representation())),
         non_critical_fail_sum_(0),
         last_closed_(false),
+        metrics_(false),
         blocked_tests_(false),
         tag_summary_(false),
         tags_(tags),
@@ -179,13 +180,18 @@ namespace crpcut {
       static const char *rstring[] = { "\"FAILED\"", "\"PASSED\"" };
       write(rstring[result]);
       last_closed_ = false;
+      metrics_ = false;
     }
 
     void
     xml_formatter
     ::end_case()
     {
-      if (last_closed_)
+      if (metrics_)
+        {
+          write("    </metrics>\n  </test>\n");
+        }
+      else if (last_closed_)
         {
           write("    </log>\n  </test>\n");
         }
@@ -251,6 +257,98 @@ namespace crpcut {
       write(">\n");
     }
 
+    void
+    xml_formatter
+    ::metric(datatypes::fixed_string name,
+             datatypes::fixed_string value)
+    {
+      assert(name);
+      if (!metrics_)
+        {
+          write(last_closed_ ? "    </log>\n" : ">\n");
+          write("    <metrics>\n");
+          last_closed_ = true;
+          metrics_ = true;
+        }
+      write("      <metric name=\"");
+      write(name, translated);
+      write("\" value=\"");
+      write(value, translated);
+      write("\"/>\n");
+    }
+
+    void
+    xml_formatter
+    ::distributions(const char                          *element,
+                    const run_statistics::distributions &d)
+    {
+      typedef run_statistics::distributions::const_iterator iter;
+      for (iter i = d.begin(); i != d.end(); ++i)
+        {
+          write("    <");
+          write(element);
+          write(" name=\"");
+          write(i->name, translated);
+          write("\" count=\"");
+          write(i->count);
+          write("\" p50_us=\"");
+          write(i->p50_us);
+          write("\" p90_us=\"");
+          write(i->p90_us);
+          write("\" max_us=\"");
+          write(i->max_us);
+          write("\"/>\n");
+        }
+    }
+
+    void
+    xml_formatter
+    ::summary(const run_statistics &s)
+    {
+      if (s.empty()) return;
+      close_blocked_tests();
+      write("  <run_summary wall_time_us=\"");
+      write(s.walltime_us());
+      write("\" cpu_time_us=\"");
+      write(s.cputime_us());
+      write("\" slots=\"");
+      write(s.num_slots());
+      write("\" busy_slot_us=\"");
+      write(s.busy_slot_us());
+      write("\" dependency_idle_slot_us=\"");
+      write(s.blocked_slot_us());
+      write("\" other_idle_slot_us=\"");
+      write(s.idle_slot_us());
+      write("\">\n");
+      const run_statistics::test_times slowest = s.slowest();
+      typedef run_statistics::test_times::const_iterator iter;
+      for (iter i = slowest.begin(); i != slowest.end(); ++i)
+        {
+          write("    <slowest_test name=\"");
+          write(i->name, translated);
+          write("\" duration_us=\"");
+          write(i->duration_us);
+          write("\"/>\n");
+        }
+      distributions("suite", s.per_suite());
+      distributions("tag", s.per_tag());
+      const run_statistics::figures overhead = s.overhead();
+      typedef run_statistics::figures::const_iterator fiter;
+      for (fiter i = overhead.begin(); i != overhead.end(); ++i)
+        {
+          write("    <overhead name=\"");
+          write(i->name);
+          write("\" count=\"");
+          write(i->count);
+          write("\" mean=\"");
+          write(i->mean);
+          write("\" max=\"");
+          write(i->max);
+          write("\"/>\n");
+        }
+      write("  </run_summary>\n");
+    }
+
     void
     xml_formatter
     ::statistics(unsigned num_run,
@@ -321,13 +419,20 @@ namespace crpcut {
 
     void
     xml_formatter
-    ::tag_summary(const tag &t)
+    ::close_blocked_tests()
     {
       if (blocked_tests_)
         {
           write("  </blocked_tests>\n");
           blocked_tests_ = false;
         }
+    }
+
+    void
+    xml_formatter
+    ::tag_summary(const tag &t)
+    {
+      close_blocked_tests();
       if (t.get_importance() != tag::critical)
         {
           non_critical_fail_sum_+= t.num_failed();
@@ -29,6 +29,7 @@
 
 #include "formatter.hpp"
 #include "writer.hpp"
+#include "../run_statistics.hpp"
 
 namespace crpcut {
   namespace output {
@@ -57,17 +58,24 @@ namespace crpcut {
       virtual void print(datatypes::fixed_string label,
                          datatypes::fixed_string data,
                          datatypes::fixed_string location);
+      virtual void metric(datatypes::fixed_string name,
+                          datatypes::fixed_string value);
+      virtual void summary(const run_statistics &s);
       virtual void statistics(unsigned num_run,
                               unsigned num_failed);
       virtual void nonempty_dir(const char *s);
       virtual void blocked_test(tag::importance i, std::string name);
     private:
       void tag_summary(const tag& t);
+      void close_blocked_tests();
+      void distributions(const char                          *element,
+                         const run_statistics::distributions &d);
       virtual datatypes::fixed_string escape(char c) const;
       void make_closed();
 
       std::size_t          non_critical_fail_sum_;
       bool                 last_closed_;
+      bool                 metrics_;
       bool                 blocked_tests_;
       bool                 tag_summary_;
       const tag_list_root &tags_;
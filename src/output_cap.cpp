@@ -0,0 +1,251 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "output_cap.hpp"
+#include "posix_error.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+extern "C" {
+#  include <fcntl.h>
+#  include <limits.h>
+}
+#include <sstream>
+
+namespace {
+#define ESTR(s) #s
+  const char * const stream_names[] = { CRPCUT_COMM_MSGS(ESTR) };
+#undef ESTR
+
+  // The text written to the file for a message. An info message is
+  // its location and its text on lines of their own.
+  void append_text(std::string    &out,
+                   crpcut::comm::type t,
+                   const char     *buff,
+                   std::size_t     len)
+  {
+    if (t != crpcut::comm::info)
+      {
+        out.append(buff, len);
+        return;
+      }
+    std::size_t location_len;
+    assert(len >= sizeof(location_len));
+    crpcut::wrapped::memcpy(&location_len, buff, sizeof(location_len));
+    buff += sizeof(location_len);
+    len -= sizeof(location_len);
+    assert(len >= location_len);
+    out.append(buff, location_len);
+    out += '\n';
+    out.append(buff + location_len, len - location_len);
+    out += '\n';
+  }
+}
+
+namespace crpcut {
+
+  output_cap
+  ::output_cap(std::size_t limit, const std::string &test_name)
+    : limit_(limit),
+      name_(test_name)
+  {
+  }
+
+  output_cap
+  ::~output_cap()
+  {
+  }
+
+  bool
+  output_cap
+  ::admit(comm::type t, std::size_t &len, const char *buff)
+  {
+    if (t != comm::stdout && t != comm::stderr && t != comm::info)
+      {
+        return true;
+      }
+    return streams_[t].admit(t, len, buff, limit_, name_);
+  }
+
+  void
+  output_cap
+  ::present(const crpcut_test_monitor &mon) const
+  {
+    streams_[comm::stdout].present(comm::stdout, mon);
+    streams_[comm::stderr].present(comm::stderr, mon);
+    streams_[comm::info].present(comm::info, mon);
+  }
+
+  output_cap::stream
+  ::stream()
+    : num_bytes_(0),
+      head_bytes_(0),
+      tail_bytes_(0),
+      truncated_(false),
+      file_ok_(false)
+  {
+  }
+
+  output_cap::stream
+  ::~stream()
+  {
+  }
+
+  bool
+  output_cap::stream
+  ::admit(comm::type         t,
+          std::size_t       &len,
+          const char        *buff,
+          std::size_t        limit,
+          const std::string &test_name)
+  {
+    const std::size_t head_limit = limit / 2;
+    num_bytes_ += len;
+    if (!truncated_ && head_bytes_ + len <= head_limit)
+      {
+        // kept for the file, in case the limit is exceeded later
+        head_bytes_ += len;
+        append_text(head_, t, buff, len);
+        return true;
+      }
+    if (!truncated_)
+      {
+        truncated_ = true;
+        open_file(t, test_name);
+        write_file(head_);
+        std::string().swap(head_);
+      }
+    std::size_t n = 0;
+    if (t != comm::info && head_bytes_ < head_limit)
+      {
+        // the beginning of a chunk of stdout or stderr can be presented
+        n = head_limit - head_bytes_;
+        head_bytes_ = head_limit;
+      }
+    std::string text;
+    append_text(text, t, buff, len);
+    write_file(text);
+    keep_end(t, buff + n, len - n, limit - head_limit);
+    len = n;
+    return n > 0;
+  }
+
+  void
+  output_cap::stream
+  ::present(comm::type t, const crpcut_test_monitor &mon) const
+  {
+    if (!truncated_) return;
+    std::ostringstream os;
+    const std::size_t name_len = wrapped::strlen(stream_names[t]);
+    os.write(reinterpret_cast<const char*>(&name_len), sizeof(name_len));
+    os.write(stream_names[t], std::streamsize(name_len));
+    os << (num_bytes_ - head_bytes_ - tail_bytes_) << " bytes left out";
+    if (file_ok_)
+      {
+        os << ", all output is in " << filename_;
+      }
+    std::string msg = os.str();
+    mon.send_to_presentation(comm::truncated, msg.length(), msg.c_str());
+    if (t == comm::info)
+      {
+        for (std::deque<std::string>::const_iterator i = tail_.begin();
+             i != tail_.end();
+             ++i)
+          {
+            mon.send_to_presentation(t, i->length(), i->c_str());
+          }
+        return;
+      }
+    std::string tail;
+    tail.reserve(tail_bytes_);
+    for (std::deque<std::string>::const_iterator i = tail_.begin();
+         i != tail_.end();
+         ++i)
+      {
+        tail += *i;
+      }
+    if (!tail.empty())
+      {
+        mon.send_to_presentation(t, tail.length(), tail.c_str());
+      }
+  }
+
+  void
+  output_cap::stream
+  ::open_file(comm::type t, const std::string &test_name)
+  {
+    char cwd[PATH_MAX];
+    if (!wrapped::getcwd(cwd, sizeof(cwd))) return;
+    filename_ = cwd;
+    filename_ += '/';
+    filename_ += test_name;
+    filename_ += '.';
+    filename_ += stream_names[t];
+    int fd = wrapped::open(filename_.c_str(),
+                           O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                           0666);
+    if (fd < 0) return;
+    comm::wfile_descriptor(fd).swap(file_);
+    file_ok_ = true;
+  }
+
+  void
+  output_cap::stream
+  ::write_file(const std::string &text)
+  {
+    if (!file_ok_) return;
+    try {
+      file_.write_loop(text.c_str(), text.length(), filename_.c_str());
+    }
+    catch (posix_error &)
+    {
+      file_ok_ = false;
+      comm::wfile_descriptor().swap(file_);
+    }
+  }
+
+  void
+  output_cap::stream
+  ::keep_end(comm::type t, const char *buff, std::size_t len,
+             std::size_t limit)
+  {
+    if (!len) return;
+    tail_.push_back(std::string(buff, len));
+    tail_bytes_ += len;
+    while (tail_bytes_ > limit)
+      {
+        std::string &first = tail_.front();
+        const std::size_t excess = tail_bytes_ - limit;
+        if (t != comm::info && first.length() > excess)
+          {
+            // stdout and stderr are streams of bytes, info is not
+            first.erase(0, excess);
+            tail_bytes_ = limit;
+            break;
+          }
+        tail_bytes_ -= first.length();
+        tail_.pop_front();
+      }
+  }
+}
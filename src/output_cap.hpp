@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef OUTPUT_CAP_HPP
+#define OUTPUT_CAP_HPP
+
+#include <crpcut.hpp>
+#include <deque>
+#include <string>
+
+namespace crpcut {
+
+  // Limits the stdout, stderr and info output of a test that the runner
+  // passes on to the presenter, so that a test stuck printing cannot
+  // make the presenter grow without bound. When a stream exceeds the
+  // limit, its beginning has been passed on and its end is kept until
+  // the test has died. All of it is written to a file named after the
+  // test and the stream, in the current directory.
+  class output_cap
+  {
+  public:
+    output_cap(std::size_t limit, const std::string &test_name);
+    ~output_cap();
+    // Returns false if no part of the message is to be presented now.
+    // len is reduced if only its beginning is.
+    bool admit(comm::type t, std::size_t &len, const char *buff);
+    // Sends a truncated message and the kept end, for each stream that
+    // exceeded the limit.
+    void present(const crpcut_test_monitor &mon) const;
+  private:
+    class stream
+    {
+    public:
+      stream();
+      ~stream();
+      bool admit(comm::type         t,
+                 std::size_t       &len,
+                 const char        *buff,
+                 std::size_t        limit,
+                 const std::string &test_name);
+      void present(comm::type t, const crpcut_test_monitor &mon) const;
+    private:
+      void open_file(comm::type t, const std::string &test_name);
+      void write_file(const std::string &text);
+      void keep_end(comm::type t, const char *buff, std::size_t len,
+                    std::size_t limit);
+
+      unsigned long long      num_bytes_;
+      std::size_t             head_bytes_;
+      std::string             head_;
+      std::deque<std::string> tail_;
+      std::size_t             tail_bytes_;
+      bool                    truncated_;
+      bool                    file_ok_;
+      comm::wfile_descriptor  file_;
+      std::string             filename_;
+      stream(const stream&);
+      stream& operator=(const stream&);
+    };
+    const std::size_t limit_;
+    const std::string name_;
+    stream            streams_[3];
+    output_cap(const output_cap&);
+    output_cap& operator=(const output_cap&);
+  };
+}
+
+#endif // OUTPUT_CAP_HPP
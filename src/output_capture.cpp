@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "output_capture.hpp"
+#include "posix_error.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+extern "C" {
+#  include <fcntl.h>
+#  include <unistd.h>
+#  ifdef HAVE_MEMFD_CREATE
+#    include <sys/mman.h>
+#  endif
+}
+
+namespace crpcut {
+
+  output_capture
+  ::output_capture()
+    : stdout_(create("crpcut stdout")),
+      stderr_(-1)
+  {
+    try {
+      stderr_ = create("crpcut stderr");
+    }
+    catch (...) {
+      wrapped::close(stdout_);
+      throw;
+    }
+  }
+
+  output_capture
+  ::~output_capture()
+  {
+    wrapped::close(stdout_);
+    wrapped::close(stderr_);
+  }
+
+  int
+  output_capture
+  ::fd(comm::type t) const
+  {
+    assert(t == comm::stdout || t == comm::stderr);
+    return t == comm::stdout ? stdout_ : stderr_;
+  }
+
+  void
+  output_capture
+  ::present(const crpcut_test_monitor &mon) const
+  {
+    present(stdout_, comm::stdout, mon);
+    present(stderr_, comm::stderr, mon);
+  }
+
+  int
+  output_capture
+  ::create(const char *name)
+  {
+#ifdef HAVE_MEMFD_CREATE
+    int fd = wrapped::memfd_create(name, MFD_CLOEXEC);
+    if (fd >= 0) return fd;
+    if (errno != ENOSYS) throw posix_error(errno, name);
+#endif
+    static unsigned long count = 0;
+    stream::toastream<64> filename;
+    filename << "capture." << wrapped::getpid() << '.' << ++count << '\0';
+    int rv = wrapped::open(filename.begin(),
+                           O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+                           0600);
+    if (rv < 0) throw posix_error(errno, name);
+    wrapped::remove(filename.begin());
+    return rv;
+  }
+
+  void
+  output_capture
+  ::present(int fd, comm::type t, const crpcut_test_monitor &mon)
+  {
+    if (wrapped::lseek(fd, 0, SEEK_SET) != 0) return;
+    static char buff[65536];
+    for (;;)
+      {
+        ssize_t rv = wrapped::read(fd, buff, sizeof(buff));
+        if (rv == -1 && errno == EINTR) continue;
+        if (rv <= 0) break;
+        mon.send_to_presentation(t, size_t(rv), buff);
+      }
+  }
+}
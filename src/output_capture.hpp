@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef OUTPUT_CAPTURE_HPP
+#define OUTPUT_CAPTURE_HPP
+
+#include <crpcut.hpp>
+
+namespace crpcut {
+
+  // Files that stdout and stderr of a test process are written to when
+  // output is not read live through pipes. They are read once, when the
+  // test process has died. A memfd is used if available, otherwise an
+  // unlinked file in the current directory.
+  class output_capture
+  {
+  public:
+    output_capture(); // throws posix_error
+    ~output_capture();
+    int fd(comm::type t) const;
+    // Sends the captured output as stdout and stderr messages.
+    void present(const crpcut_test_monitor &mon) const;
+  private:
+    static int create(const char *name);
+    static void present(int fd, comm::type t, const crpcut_test_monitor &mon);
+
+    int stdout_;
+    int stderr_;
+    output_capture(const output_capture&);
+    output_capture& operator=(const output_capture&);
+  };
+}
+
+#endif // OUTPUT_CAPTURE_HPP
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKET_WRITER_HPP
+#define PACKET_WRITER_HPP
+
+#include <crpcut.hpp>
+
+namespace crpcut {
+
+  // Writes to a SOCK_SEQPACKET socket, where each write is received whole
+  // by one read. A write larger than max_packet is split into packets of
+  // at most max_packet bytes, which the reader joins again. A message of
+  // up to max_packet bytes is sent as one frame, and thus one packet.
+  class packet_writer : public comm::wfile_descriptor
+  {
+  public:
+    static const std::size_t max_packet = 65536;
+    packet_writer(int fd);
+    virtual ssize_t write(const void *buff, size_t len) const;
+    virtual size_t max_frame() const;
+  private:
+    packet_writer(const packet_writer&);
+    packet_writer& operator=(const packet_writer&);
+  };
+}
+
+#endif // PACKET_WRITER_HPP
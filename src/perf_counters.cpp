@@ -0,0 +1,186 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "perf_counters.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#ifdef HAVE_PERF_EVENT
+extern "C" {
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+}
+#endif
+#include <cerrno>
+
+namespace {
+  struct event_info
+  {
+    unsigned long long hw_config;
+    unsigned long long sw_config;
+    const char        *name;
+    const char        *fallback_name;
+    const char        *metric;
+    const char        *fallback_metric;
+  };
+
+#ifdef HAVE_PERF_EVENT
+  const event_info events[] = {
+    { PERF_COUNT_HW_INSTRUCTIONS,  PERF_COUNT_SW_TASK_CLOCK,
+      "instructions",  "task_clock_ns",
+      "perf.instructions", "perf.task_clock_ns" },
+    { PERF_COUNT_HW_CPU_CYCLES,    PERF_COUNT_SW_TASK_CLOCK,
+      "cycles",        "task_clock_ns",
+      "perf.cycles", "perf.task_clock_ns" },
+    { PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_PAGE_FAULTS,
+      "branch_misses", "page_faults",
+      "perf.branch_misses", "perf.page_faults" },
+    { PERF_COUNT_HW_CACHE_MISSES,  PERF_COUNT_SW_PAGE_FAULTS,
+      "cache_misses",  "page_faults",
+      "perf.cache_misses", "perf.page_faults" }
+  };
+
+  int open_counter(unsigned type, unsigned long long config,
+                   pid_t pid, bool inherit)
+  {
+    struct perf_event_attr attr = perf_event_attr();
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.inherit        = inherit;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    long rv;
+    do {
+      rv = ::syscall(__NR_perf_event_open, &attr, pid, -1, -1,
+                     PERF_FLAG_FD_CLOEXEC);
+    } while (rv == -1 && errno == EINTR);
+    return int(rv);
+  }
+#else
+  const event_info events[] = {
+    { 0, 0, "instructions",  "task_clock_ns", "perf.instructions",  0 },
+    { 0, 0, "cycles",        "task_clock_ns", "perf.cycles",        0 },
+    { 0, 0, "branch_misses", "page_faults",   "perf.branch_misses", 0 },
+    { 0, 0, "cache_misses",  "page_faults",   "perf.cache_misses",  0 }
+  };
+#endif
+}
+
+namespace crpcut {
+  namespace perf {
+
+    int open(event e, pid_t pid, bool inherit, bool &fallback)
+    {
+#ifdef HAVE_PERF_EVENT
+      fallback = false;
+      int fd = open_counter(PERF_TYPE_HARDWARE, events[e].hw_config,
+                            pid, inherit);
+      if (fd >= 0) return fd;
+      fallback = true;
+      return open_counter(PERF_TYPE_SOFTWARE, events[e].sw_config,
+                          pid, inherit);
+#else
+      (void)e;
+      (void)pid;
+      (void)inherit;
+      fallback = false;
+      return -1;
+#endif
+    }
+
+    bool read(int fd, unsigned long long &count)
+    {
+      if (fd < 0) return false;
+      ssize_t rv;
+      do {
+        rv = wrapped::read(fd, &count, sizeof(count));
+      } while (rv == -1 && errno == EINTR);
+      return rv == sizeof(count);
+    }
+
+    const char *name(event e, bool fallback)
+    {
+      return fallback ? events[e].fallback_name : events[e].name;
+    }
+  }
+
+  perf_counters
+  ::perf_counters(pid_t pid)
+    : num_counters_(0)
+  {
+    static const perf::event all[] = {
+      scope::counter_base::instructions,
+      scope::counter_base::cycles,
+      scope::counter_base::branch_misses,
+      scope::counter_base::cache_misses
+    };
+    for (std::size_t i = 0; i < sizeof(all)/sizeof(all[0]); ++i)
+      {
+        bool fallback;
+        int fd = perf::open(all[i], pid, true, fallback);
+        if (fd < 0) continue;
+        const event_info &info = events[all[i]];
+        const char *name = fallback ? info.fallback_metric : info.metric;
+        // instructions and cycles may both be replaced by task-clock
+        bool is_counted = false;
+        for (std::size_t j = 0; j < num_counters_; ++j)
+          {
+            is_counted |= counters_[j].name == name;
+          }
+        if (is_counted)
+          {
+            wrapped::close(fd);
+            continue;
+          }
+        counters_[num_counters_].fd   = fd;
+        counters_[num_counters_].name = name;
+        ++num_counters_;
+      }
+  }
+
+  perf_counters
+  ::~perf_counters()
+  {
+    for (std::size_t i = 0; i < num_counters_; ++i)
+      {
+        wrapped::close(counters_[i].fd);
+      }
+  }
+
+  void
+  perf_counters
+  ::read_usage(usage &u) const
+  {
+    for (std::size_t i = 0; i < num_counters_; ++i)
+      {
+        unsigned long long count;
+        if (perf::read(counters_[i].fd, count))
+          {
+            u.push_back(std::make_pair(counters_[i].name, count));
+          }
+      }
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <crpcut.hpp>
+#include <utility>
+#include <vector>
+
+namespace crpcut {
+  // Performance counters from perf_event_open(). Where the hardware
+  // counter for an event can't be opened, as in most virtual machines,
+  // a software counter is opened in its place; task-clock for
+  // instructions and cycles, and page faults for branch and cache misses.
+  namespace perf {
+    typedef scope::counter_base::event event;
+
+    // Returns the file descriptor of a counter of e for pid, where 0 is
+    // the calling thread, or -1 if neither the hardware counter nor its
+    // replacement can be opened. With inherit, processes spawned by pid
+    // are counted too, once they have exited. Does not allocate.
+    int open(event e, pid_t pid, bool inherit, bool &fallback);
+
+    bool read(int fd, unsigned long long &count);
+
+    // What is counted, e.g. "instructions", or "task_clock_ns" in its place
+    const char *name(event e, bool fallback);
+  }
+
+  // The counters of one test process, and everything it spawns, from
+  // just after fork.
+  class perf_counters
+  {
+  public:
+    typedef std::pair<const char*, unsigned long long> measurement;
+    typedef std::vector<measurement> usage;
+
+    explicit perf_counters(pid_t pid);
+    ~perf_counters();
+
+    // Appends the counts available to u.
+    void read_usage(usage &u) const;
+  private:
+    struct counter
+    {
+      int         fd;
+      const char *name;
+    };
+    counter     counters_[4];
+    std::size_t num_counters_;
+    perf_counters(const perf_counters&);
+    perf_counters& operator=(const perf_counters&);
+  };
+}
+
+#endif // PERF_COUNTERS_HPP
@@ -40,8 +40,16 @@ namespace {
 
 namespace crpcut {
   pipe_pair
-  ::pipe_pair(const char *purpose_msg)
+  ::pipe_pair(const char *purpose_msg, kind k)
+    : kind_(k)
   {
+    // a pipe is used if packets aren't supported
+    if (kind_ == packets
+        && wrapped::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0)
+      {
+        return;
+      }
+    kind_ = bytes;
     int rv = wrapped::pipe(fds);
     if (rv < 0) throw posix_error(errno, purpose_msg);
   }
@@ -81,4 +89,11 @@ namespace crpcut {
     if (p == release_ownership) fds[1] = -1;
     return n;
   }
+
+  pipe_pair::kind
+  pipe_pair
+  ::get_kind() const
+  {
+    return kind_;
+  }
 }
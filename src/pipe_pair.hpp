@@ -32,15 +32,18 @@ namespace crpcut {
   {
   public:
     typedef enum { release_ownership, keep_ownership } purpose;
-    pipe_pair(const char *purpose_msg);
+    typedef enum { bytes, packets } kind;
+    pipe_pair(const char *purpose_msg, kind k = bytes);
     ~pipe_pair();
     void close();
     int for_reading(purpose p = keep_ownership);
     int for_writing(purpose p = keep_ownership);
+    kind get_kind() const;
   private:
     pipe_pair(const pipe_pair&);
     pipe_pair& operator=(const pipe_pair&);
     int fds[2];
+    kind kind_;
   };
 }
 
@@ -31,4 +31,20 @@ namespace crpcut {
   ::~posix_write()
   {
   }
+
+  ssize_t
+  posix_write
+  ::do_writev(int fd, const struct iovec *v, int count)
+  {
+    // one write per chunk, up to the first one not written in full
+    ssize_t sum = 0;
+    for (int i = 0; i < count; ++i)
+      {
+        ssize_t n = do_write(fd, v[i].iov_base, v[i].iov_len);
+        if (n < 0) return sum ? sum : n;
+        sum += n;
+        if (std::size_t(n) < v[i].iov_len) break;
+      }
+    return sum;
+  }
 }
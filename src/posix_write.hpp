@@ -31,6 +31,7 @@
 extern "C"
 {
 #  include <sys/types.h>
+#  include <sys/uio.h>
 }
 namespace crpcut {
   class posix_write
@@ -41,8 +42,13 @@ namespace crpcut {
     {
       return do_write(fd, p, n);
     }
+    ssize_t operator()(int fd, const struct iovec *v, int count)
+    {
+      return do_writev(fd, v, count);
+    }
   private:
     virtual ssize_t do_write(int fd, const void *p, std::size_t n) = 0;
+    virtual ssize_t do_writev(int fd, const struct iovec *v, int count);
   };
 }
 
@@ -44,7 +44,11 @@ namespace crpcut {
                              output::formatter &summary_fmt,
                              bool               verbose,
                              const char        *working_dir,
-                             registrator_list  &reg)
+                             registrator_list  &reg,
+                             journal           *log,
+                             const journal::entry_list &completed,
+                             run_statistics    *stats,
+                             event_stream      *events)
   {
     comm::rfile_descriptor presenter_pipe(presentation_fd);
 
@@ -56,7 +60,17 @@ namespace crpcut {
                           summary_fmt,
                           verbose,
                           working_dir,
-                          reg);
+                          reg,
+                          log,
+                          stats,
+                          events);
+    for (const journal::entry *e = completed.first();
+         e;
+         e = completed.next_after(e))
+      {
+        r.replay(*e);
+      }
+    if (log) log->sync();
     presentation_output o(buffer, poller, output_fd);
     presentation_output so(summary_buffer, poller, output_fd == 1 ? -1 : 1);
     while (poller.num_fds() > 0)
@@ -27,8 +27,12 @@
 #ifndef PRESENTATION_HPP
 #define PRESENTATION_HPP
 
+#include "journal.hpp"
+
 namespace crpcut {
   class registrator_list;
+  class run_statistics;
+  class event_stream;
   namespace output {
     class formatter;
     class buffer;
@@ -41,6 +45,10 @@ namespace crpcut {
                              output::formatter &summary_fmt,
                              bool               verbose,
                              const char        *working_dir,
-                             registrator_list  &reg);
+                             registrator_list  &reg,
+                             journal           *log,
+                             const journal::entry_list &completed,
+                             run_statistics    *stats = 0,
+                             event_stream      *events = 0);
 }
 #endif // PRESENTATION_HPP
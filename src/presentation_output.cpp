@@ -90,22 +90,27 @@ namespace crpcut {
     assert(enabled());
     assert(!buffer_.is_empty());
 
-    std::pair<const char *, size_t> data = buffer_.get_buffer();
-    const char *buff = data.first;
-    size_t      len  = data.second;
+    // all that is pending, as far as a writev takes it
+    static const std::size_t max_chunks = 64;
+    struct iovec v[max_chunks];
+    std::size_t count = buffer_.get_buffers(v, max_chunks);
 
-    assert(buff);
-    assert(len);
+    assert(count);
+    assert(v[0].iov_base);
 
-    ssize_t n = write_(fd_, buff + pos_, len - pos_);
+    v[0].iov_base = static_cast<char*>(v[0].iov_base) + pos_;
+    v[0].iov_len -= pos_;
+    ssize_t n = write_(fd_, v, int(count));
 
     assert(n >= 0);
-    pos_+= size_t(n);
-    if (pos_ == len)
+    std::size_t written = std::size_t(n);
+    for (std::size_t i = 0; i < count && written >= v[i].iov_len; ++i)
       {
+        written -= v[i].iov_len;
         pos_ = 0;
         buffer_.advance();
       }
+    pos_ += written;
     return false;
   }
 
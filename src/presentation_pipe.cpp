@@ -0,0 +1,177 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "presentation_pipe.hpp"
+#include "presentation_reader.hpp"
+#include "posix_error.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+
+namespace crpcut {
+
+  const std::size_t presentation_pipe::header_size;
+
+  void
+  presentation_pipe
+  ::encode_header(char        *dest,
+                  pid_t        pid,
+                  comm::type   t,
+                  test_phase   phase,
+                  std::size_t  len)
+  {
+    wrapped::memcpy(dest, &pid, sizeof(pid));
+    dest += sizeof(pid);
+    wrapped::memcpy(dest, &t, sizeof(t));
+    dest += sizeof(t);
+    wrapped::memcpy(dest, &phase, sizeof(phase));
+    dest += sizeof(phase);
+    wrapped::memcpy(dest, &len, sizeof(len));
+  }
+
+  std::size_t
+  presentation_pipe
+  ::decode_header(const char *src,
+                  pid_t      &pid,
+                  comm::type &t,
+                  test_phase &phase)
+  {
+    wrapped::memcpy(&pid, src, sizeof(pid));
+    src += sizeof(pid);
+    wrapped::memcpy(&t, src, sizeof(t));
+    src += sizeof(t);
+    wrapped::memcpy(&phase, src, sizeof(phase));
+    src += sizeof(phase);
+    std::size_t len;
+    wrapped::memcpy(&len, src, sizeof(len));
+    return len;
+  }
+
+  presentation_pipe
+  ::presentation_pipe()
+    : comm::wfile_descriptor(),
+      reader_(0),
+      pending_len_(0)
+  {
+  }
+
+  presentation_pipe
+  ::presentation_pipe(int fd)
+    : comm::wfile_descriptor(fd),
+      reader_(0),
+      pending_len_(0)
+  {
+  }
+
+  void
+  presentation_pipe
+  ::write_frame(pid_t        pid,
+                comm::type   t,
+                test_phase   phase,
+                std::size_t  len,
+                const void  *buff)
+  {
+    if (reader_)
+      {
+        reader_->present_frame(pid, t, phase,
+                               static_cast<const char*>(buff), len);
+        return;
+      }
+    if (pending_len_ + header_size + len <= sizeof(pending_))
+      {
+        encode_header(pending_ + pending_len_, pid, t, phase, len);
+        pending_len_ += header_size;
+        if (len) wrapped::memcpy(pending_ + pending_len_, buff, len);
+        pending_len_ += len;
+        return;
+      }
+    char header[header_size];
+    encode_header(header, pid, t, phase, len);
+    struct iovec v[3];
+    v[0].iov_base = pending_;
+    v[0].iov_len  = pending_len_;
+    v[1].iov_base = header;
+    v[1].iov_len  = header_size;
+    v[2].iov_base = const_cast<void*>(buff);
+    v[2].iov_len  = len;
+    pending_len_ = 0;
+    writev_loop(v, 3);
+  }
+
+  void
+  presentation_pipe
+  ::flush()
+  {
+    if (pending_len_ == 0) return;
+    struct iovec v;
+    v.iov_base = pending_;
+    v.iov_len  = pending_len_;
+    pending_len_ = 0;
+    writev_loop(&v, 1);
+  }
+
+  void
+  presentation_pipe
+  ::deliver_to(presentation_reader *r)
+  {
+    assert(pending_len_ == 0);
+    reader_ = r;
+  }
+
+  void
+  presentation_pipe
+  ::writev_loop(struct iovec *v, int count)
+  {
+    while (count)
+      {
+        if (v->iov_len == 0)
+          {
+            ++v;
+            --count;
+            continue;
+          }
+        ssize_t rv = wrapped::writev(fd_, v, count);
+        if (rv == -1 && errno == EINTR)
+          {
+            continue;
+          }
+        if (rv <= 0)
+          {
+            throw posix_error(errno, "writing to presentation process");
+          }
+        std::size_t n = std::size_t(rv);
+        while (count && n >= v->iov_len)
+          {
+            n -= v->iov_len;
+            ++v;
+            --count;
+          }
+        if (n)
+          {
+            v->iov_base = static_cast<char*>(v->iov_base) + n;
+            v->iov_len -= n;
+          }
+      }
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PRESENTATION_PIPE_HPP
+#define PRESENTATION_PIPE_HPP
+
+#include <crpcut.hpp>
+
+extern "C" {
+#  include <sys/uio.h>
+}
+
+namespace crpcut {
+
+  class presentation_reader;
+
+  // Each message to the presentation process is a frame of a fixed size
+  // header, pid -> type -> phase -> size_t(length), followed by length bytes
+  // of payload. Small frames are collected and written together, large
+  // ones are written with the frames pending before them in one writev.
+  // When presenting in the same process, frames are instead handed
+  // directly to the presentation_reader.
+  class presentation_pipe : public comm::wfile_descriptor
+  {
+  public:
+    static const std::size_t header_size = sizeof(pid_t)
+                                         + sizeof(comm::type)
+                                         + sizeof(test_phase)
+                                         + sizeof(std::size_t);
+    static void encode_header(char        *dest,
+                              pid_t        pid,
+                              comm::type   t,
+                              test_phase   phase,
+                              std::size_t  len);
+    static std::size_t decode_header(const char *src,
+                                     pid_t      &pid,
+                                     comm::type &t,
+                                     test_phase &phase);
+    presentation_pipe();
+    presentation_pipe(int fd);
+    void write_frame(pid_t        pid,
+                     comm::type   t,
+                     test_phase   phase,
+                     std::size_t  len,
+                     const void  *buff);
+    void flush();
+    void deliver_to(presentation_reader *r);
+  private:
+    presentation_pipe(const presentation_pipe&);
+    presentation_pipe& operator=(const presentation_pipe&);
+    void writev_loop(struct iovec *v, int count);
+
+    presentation_reader *reader_;
+    std::size_t          pending_len_;
+    char                 pending_[16384];
+  };
+}
+
+#endif // PRESENTATION_PIPE_HPP
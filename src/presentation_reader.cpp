@@ -26,19 +26,66 @@
 
 
 #include "presentation_reader.hpp"
+#include "presentation_pipe.hpp"
 #include "printer.hpp"
 #include "output/formatter.hpp"
 #include "poll.hpp"
 #include "posix_error.hpp"
 #include "registrator_list.hpp"
+#include "run_statistics.hpp"
+#include "event_stream.hpp"
+#include "clocks/clocks.hpp"
 #include "wrapped/posix_encapsulation.hpp"
 #include <crpcut.hpp>
+#include <algorithm>
+#include <cstddef>
 
 namespace {
 #define ESTR(s) { #s, sizeof(#s)-1 }
   static const crpcut::datatypes::fixed_string tag_info[]
   =  { CRPCUT_COMM_MSGS(ESTR) };
 #undef ESTR
+
+  bool is(crpcut::datatypes::fixed_string s, const char *name)
+  {
+    return s.len == crpcut::wrapped::strlen(name)
+      && crpcut::wrapped::strncmp(s.str, name, s.len) == 0;
+  }
+
+  unsigned long value_of(crpcut::datatypes::fixed_string s)
+  {
+    unsigned long v = 0;
+    for (std::size_t i = 0; i < s.len; ++i)
+      {
+        if (s.str[i] < '0' || s.str[i] > '9') break;
+        v = v*10 + (unsigned long)(s.str[i] - '0');
+      }
+    return v;
+  }
+
+  typedef crpcut::datatypes::list_elem<crpcut::event> event_list;
+
+  // user + system time, from the rusage measurements of a test
+  unsigned long cputime_us(const event_list &l)
+  {
+    unsigned long sum = 0;
+    for (const crpcut::event *i = l.first(); i; i = l.next_after(i))
+      {
+        if (is(i->location_, "rusage.user_us")
+            || is(i->location_, "rusage.system_us"))
+          {
+            sum += value_of(i->msg_);
+          }
+      }
+    return sum;
+  }
+
+  std::string name_of(const crpcut::crpcut_test_case_registrator &t)
+  {
+    std::ostringstream os;
+    os << t;
+    return os.str();
+  }
 }
 
 namespace crpcut {
@@ -50,31 +97,94 @@ namespace crpcut {
                         output::formatter      &summary_fmt,
                         bool                    verbose,
                         const char             *working_dir,
-                        registrator_list       &reg)
-    : poller_(poller),
-      fd_(fd),
+                        registrator_list       &reg,
+                        journal                *log,
+                        run_statistics         *stats,
+                        event_stream           *events)
+    : results_(),
+      poller_(&poller),
+      fd_(&fd),
+      fmt_(fmt),
+      summary_fmt_(summary_fmt),
+      working_dir_(working_dir),
+      verbose_(verbose),
+      num_run_(0),
+      num_failed_(0),
+      reg_(reg),
+      log_(log),
+      stats_(stats),
+      events_(events),
+      buffer_begin_(0),
+      buffer_end_(0)
+  {
+    poller_->add_fd(*fd_, this);
+    schedule();
+  }
+
+  presentation_reader
+  ::presentation_reader(output::formatter      &fmt,
+                        output::formatter      &summary_fmt,
+                        bool                    verbose,
+                        const char             *working_dir,
+                        registrator_list       &reg,
+                        journal                *log,
+                        run_statistics         *stats,
+                        event_stream           *events)
+    : results_(),
+      poller_(0),
+      fd_(0),
       fmt_(fmt),
       summary_fmt_(summary_fmt),
       working_dir_(working_dir),
       verbose_(verbose),
       num_run_(0),
       num_failed_(0),
-      reg_(reg)
+      reg_(reg),
+      log_(log),
+      stats_(stats),
+      events_(events),
+      buffer_begin_(0),
+      buffer_end_(0)
   {
-    poller_.add_fd(fd_, this);
+    schedule();
   }
 
   presentation_reader
   ::~presentation_reader()
   {
+    while (test_case_result *s = results_.any())
+      {
+        results_.erase(s->id);
+        delete s;
+      }
+  }
+
+  void
+  presentation_reader
+  ::schedule()
+  {
+    if (!events_) return;
+    for (crpcut_test_case_registrator *i = reg_.first();
+         i;
+         i = reg_.next_after(i))
+      {
+        events_->scheduled(name_of(*i));
+      }
   }
 
   void
   presentation_reader
   ::exception()
   {
-    poller_.del_fd(&fd_);
-    comm::rfile_descriptor().swap(fd_);
+    poller_->del_fd(fd_);
+    comm::rfile_descriptor().swap(*fd_);
+    finish();
+  }
+
+  void
+  presentation_reader
+  ::finish()
+  {
     for (crpcut_test_case_registrator *i = reg_.first();
          i;
          i = reg_.next_after(i))
@@ -85,110 +195,212 @@ namespace crpcut {
         tag::importance importance = i->get_importance();
         fmt_.blocked_test(importance, name);
         summary_fmt_.blocked_test(importance, name);
+        if (events_) events_->blocked(name);
+      }
+    if (stats_)
+      {
+        fmt_.summary(*stats_);
       }
     fmt_.statistics(num_run_, num_failed_);
     summary_fmt_.statistics(num_run_, num_failed_);
+    if (events_) events_->done(num_run_, num_failed_);
   }
 
   test_case_result *
   presentation_reader
   ::find_result_for(pid_t id)
   {
-    // a linear search isn't that great, but the
-    // amount of data is small.
-    for (test_case_result *i = messages_.first();
-         i;
-         i = messages_.next_after(i))
-      {
-        if (i->id == id)
-          {
-            return i;
-          }
-      }
-    return 0;
+    return results_.find(id);
   }
 
   void
   presentation_reader
-  ::begin_test(test_case_result *s)
+  ::begin_test(test_case_result *s, const char *payload, size_t len)
   {
     assert(!s->test);
     assert(s->history.is_empty());
     // introduction to test case follows
 
-    size_t len = 0;
-    fd_.read_loop(&len, sizeof(len));
-    assert(len == sizeof(s->test));
-    fd_.read_loop(&s->test, len);
+    struct begin_data
+    {
+      crpcut_test_case_registrator *test;
+      unsigned long                 stalled_slot_us;
+    } info;
+    assert(len == sizeof(info) || len == offsetof(begin_data, stalled_slot_us));
+    info.stalled_slot_us = 0;
+    wrapped::memcpy(&info, payload, len);
+    s->test = info.test;
     s->test->unlink();
     s->success = true;
     s->nonempty_dir = false;
+    if (stats_)
+      {
+        stats_->begin_test(clocks::monotonic::timestamp_absolute(),
+                           info.stalled_slot_us);
+      }
+    if (events_) events_->started(name_of(*s->test));
   }
 
   void
   presentation_reader
-  ::end_test(test_phase phase, test_case_result* s)
+  ::end_test(test_phase        phase,
+             test_case_result *s,
+             const char       *payload,
+             size_t            len)
   {
     assert(s->test);
 
-    size_t len;
-    fd_.read_loop(&len, sizeof(len));
-    struct
+    struct end_data
     {
       unsigned long critical;
       unsigned long duration_us;
+      unsigned long sent_us; // only with runner stats
     } info;
-    assert(len == sizeof(info));
-    fd_.read_loop(&info, len);
+    assert(len == sizeof(info) || len == offsetof(end_data, sent_us));
+    info.sent_us = 0;
+    wrapped::memcpy(&info, payload, len);
 
     const bool pass = s->success && !s->explicit_fail;
     tag &t = s->test->crpcut_tag();
     if (pass) t.pass(); else t.fail();
     ++num_run_;
-    if (!pass || verbose_)
+    const bool print = !pass || verbose_;
+    if (events_)
+      {
+        events_->finished(name_of(*s->test), pass, info.critical, phase,
+                          info.duration_us, cputime_us(s->metrics),
+                          pass ? datatypes::fixed_string::make("")
+                               : s->termination);
+      }
+    if (stats_)
+      {
+        std::ostringstream name;
+        name << *s->test;
+        datatypes::fixed_string tag_name = t.get_name();
+        stats_->end_test(clocks::monotonic::timestamp_absolute(),
+                         name.str(),
+                         tag_name
+                         ? std::string(tag_name.str, tag_name.len)
+                         : std::string(),
+                         info.duration_us,
+                         cputime_us(s->metrics));
+        if (stats_->with_overhead())
+          {
+            add_overhead(s->metrics);
+            if (info.sent_us)
+              {
+                stats_->add_overhead("presenter.lag_us",
+                                     clocks::monotonic::timestamp_absolute()
+                                     - info.sent_us);
+              }
+          }
+      }
+    if (print || log_)
       {
         num_failed_ += !pass;
 
         std::ostringstream name;
         name << *s->test;
-        printer print(fmt_, name.str(), pass, info.critical, info.duration_us);
-
-        for (event *i = s->history.first();
-             i;
-             i = s->history.next_after(i))
+        if (log_)
           {
-            fmt_.print(tag_info[i->tag_], i->msg_, i->location_);
+            log_->begin_case(name.str(), pass, info.critical, info.duration_us);
           }
-        if (s->termination || s->nonempty_dir || s->explicit_fail)
+        if (print)
           {
-            if (s->nonempty_dir)
+            printer p(fmt_, name.str(), pass, info.critical, info.duration_us);
+
+            for (event *i = s->history.first();
+                 i;
+                 i = s->history.next_after(i))
               {
-                std::ostringstream dirname;
-                dirname << working_dir_ << "/" << *s->test;
-                fmt_.terminate(phase, s->termination, s->location, dirname.str());
+                fmt_.print(tag_info[i->tag_], i->msg_, i->location_);
+                if (log_)
+                  {
+                    log_->print(tag_info[i->tag_], i->msg_, i->location_);
+                  }
               }
-            else
+            if (s->termination || s->nonempty_dir || s->explicit_fail)
               {
-                fmt_.terminate(phase, s->termination, s->location);
+                std::string dirname;
+                if (s->nonempty_dir)
+                  {
+                    std::ostringstream os;
+                    os << working_dir_ << "/" << *s->test;
+                    dirname = os.str();
+                  }
+                fmt_.terminate(phase, s->termination, s->location, dirname);
+                if (log_)
+                  {
+                    log_->terminate(phase, s->termination, s->location,
+                                    dirname);
+                  }
+              }
+            for (event *i = s->metrics.first();
+                 i;
+                 i = s->metrics.next_after(i))
+              {
+                fmt_.metric(i->location_, i->msg_);
+                if (log_)
+                  {
+                    log_->metric(i->location_, i->msg_);
+                  }
               }
           }
+        if (log_)
+          {
+            log_->end_case();
+          }
       }
+    results_.erase(s->id);
     delete s;
   }
 
   void
   presentation_reader
-  ::nonempty_dir(test_case_result *s)
+  ::replay(const journal::entry &e)
+  {
+    tag &t = e.test->crpcut_tag();
+    if (e.result()) t.pass(); else t.fail();
+    ++num_run_;
+    if (!e.result() || verbose_)
+      {
+        num_failed_ += !e.result();
+        e.replay(fmt_);
+      }
+    if (log_)
+      {
+        log_->append(e);
+      }
+  }
+
+  void
+  presentation_reader
+  ::add_overhead(const datatypes::list_elem<event> &metrics)
+  {
+    static const char prefix[] = "runner.";
+    const std::size_t prefix_len = sizeof(prefix) - 1;
+    for (const event *i = metrics.first(); i; i = metrics.next_after(i))
+      {
+        datatypes::fixed_string name = i->location_;
+        if (name.len > prefix_len
+            && wrapped::strncmp(name.str, prefix, prefix_len) == 0)
+          {
+            stats_->add_overhead(std::string(name.str, name.len),
+                                 value_of(i->msg_));
+          }
+      }
+  }
+
+  void
+  presentation_reader
+  ::nonempty_dir(test_case_result *s, const char *payload, size_t len)
   {
-    size_t len;
-    fd_.read_loop(&len, sizeof(len));
     assert(s || len > 0U);
     if (!s)
       {
-        char *name = static_cast<char*>(alloca(len));
-        fd_.read_loop(name, len);
-        fmt_.nonempty_dir(name);
-        summary_fmt_.nonempty_dir(name);
+        // the name is sent with its terminating '\0'
+        fmt_.nonempty_dir(payload);
+        summary_fmt_.nonempty_dir(payload);
         return;
       }
     s->success = false;
@@ -199,89 +411,178 @@ namespace crpcut {
   presentation_reader
   ::output_data(comm::type t, test_case_result *s, datatypes::fixed_string msg, datatypes::fixed_string location)
   {
-    if (s->termination) return;
+    if (t == comm::metric)
+      {
+        // the name of a measurement is sent as its location
+        event *e = s->make_event(t, msg, location);
+        e->link_before(s->metrics);
+        return;
+      }
+    // output collected by the runner may follow the termination of a test
+    if (s->termination && (t == comm::exit_ok
+                           || t == comm::exit_fail
+                           || t == comm::fail)) return;
     if (t == comm::exit_ok || t == comm::exit_fail)
       {
         s->termination = msg;
         s->location    = location;
         return;
       }
-    event *e = new event(t, msg, location);
+    event *e = s->make_event(t, msg, location);
     e->link_before(s->history);
+    if (events_) events_->output(name_of(*s->test), t, location, msg);
   }
 
   bool
   presentation_reader
-  ::read()
+  ::fill_buffer()
   {
-    try {
-      pid_t test_case_id;
-      fd_.read_loop(&test_case_id, sizeof(test_case_id));
-
-      comm::type t;
-      fd_.read_loop(&t, sizeof(t));
+    static const size_t chunk_size = 65536;
+    if (buffer_begin_ == buffer_end_)
+      {
+        buffer_begin_ = buffer_end_ = 0;
+      }
+    else if (buffer_begin_)
+      {
+        // keep the start of a frame that is not yet complete
+        std::copy(buffer_.begin() + long(buffer_begin_),
+                  buffer_.begin() + long(buffer_end_),
+                  buffer_.begin());
+        buffer_end_ -= buffer_begin_;
+        buffer_begin_ = 0;
+      }
+    if (buffer_.size() - buffer_end_ < chunk_size)
+      {
+        buffer_.resize(buffer_end_ + chunk_size);
+      }
+    for (;;)
+      {
+        ssize_t rv = fd_->read(&buffer_[buffer_end_],
+                               buffer_.size() - buffer_end_);
+        if (rv == -1 && errno == EINTR)
+          {
+            continue;
+          }
+        if (rv <= 0)
+          {
+            return false;
+          }
+        buffer_end_ += size_t(rv);
+        if (stats_ && stats_->with_overhead())
+          {
+            // what was waiting in the pipe, up to a chunk
+            stats_->add_overhead("presenter.queue_bytes", (unsigned long)rv);
+          }
+        return true;
+      }
+  }
 
-      test_phase phase;
-      fd_.read_loop(&phase, sizeof(phase));
+  bool
+  presentation_reader
+  ::parse_frames()
+  {
+    bool parsed = false;
+    const size_t header_size = presentation_pipe::header_size;
+    while (buffer_end_ - buffer_begin_ >= header_size)
+      {
+        const char *frame = &buffer_[buffer_begin_];
+        pid_t      test_case_id;
+        comm::type t;
+        test_phase phase;
+        size_t len = presentation_pipe::decode_header(frame,
+                                                      test_case_id,
+                                                      t,
+                                                      phase);
+        if (buffer_end_ - buffer_begin_ - header_size < len) break;
+        buffer_begin_ += header_size + len;
+        present_frame(test_case_id, t, phase, frame + header_size, len);
+        parsed = true;
+      }
+    return parsed;
+  }
 
-      test_case_result *s = find_result_for(test_case_id);
-      if (!s && test_case_id)
+  void
+  presentation_reader
+  ::present_frame(pid_t       test_case_id,
+                  comm::type  t,
+                  test_phase  phase,
+                  const char *payload,
+                  size_t      len)
+  {
+    test_case_result *s = find_result_for(test_case_id);
+    if (!s && test_case_id)
+      {
+        s = new test_case_result(test_case_id);
+        results_.insert(s);
+      }
+    assert(test_case_id || t == comm::dir);
+    int mask = t & comm::kill_me;
+    t = static_cast<comm::type>(t & ~mask);
+    if (s && s->test && phase != s->phase)
+      {
+        s->phase = phase;
+        if (events_) events_->phase(name_of(*s->test), phase);
+      }
+    datatypes::fixed_string location = { 0, 0 };
+    bool with_location = false;
+    switch (t)
+      {
+      case comm::begin_test:
+        begin_test(s, payload, len);
+        break;
+      case comm::end_test:
+        end_test(phase, s, payload, len);
+        break;
+      case comm::dir:
+        nonempty_dir(s, payload, len);
+        break;
+      case comm::fail:
+      case comm::exit_fail:
+        s->explicit_fail = true;
+                                         /* no break */
+      case comm::exit_ok:
+        s->success &= t == comm::exit_ok;
+                                         /* no break */
+      case comm::metric:
+      case comm::truncated:
+      case comm::info:
+        with_location = t != comm::exit_ok;
+                                         /* no break */
+      case comm::stdout:
+      case comm::stderr:
         {
-          s = new test_case_result(test_case_id);
-          s->link_after(messages_);
+          datatypes::fixed_string msg = { 0, len };
+          assert(!with_location || msg.len);
+          if (with_location)
+            {
+              wrapped::memcpy(&location.len, payload, sizeof(location.len));
+              payload += sizeof(location.len);
+              assert(location.len);
+              location = s->arena.copy(payload, location.len);
+              payload += location.len;
+              msg.len -= location.len + sizeof(location.len);
+            }
+          msg = s->arena.copy(payload, msg.len);
+          output_data(t, s, msg, location);
         }
-      assert(test_case_id || t == comm::dir);
-      int mask = t & comm::kill_me;
-      t = static_cast<comm::type>(t & ~mask);
-      datatypes::fixed_string location = { 0, 0 };
-      bool with_location = false;
-      switch (t)
+        break;
+      default:
+        assert("unreachable code reached" == 0);
+        /* no break */
+      }
+  }
+
+  bool
+  presentation_reader
+  ::read()
+  {
+    try {
+      // at least one whole frame is presented for each call
+      do
         {
-        case comm::begin_test:
-          begin_test(s);
-          break;
-        case comm::end_test:
-          end_test(phase, s);
-          break;
-        case comm::dir:
-          nonempty_dir(s);
-          break;
-        case comm::fail:
-        case comm::exit_fail:
-          s->explicit_fail = true;
-                                           /* no break */
-        case comm::exit_ok:
-          s->success &= t == comm::exit_ok;
-                                           /* no break */
-        case comm::info:
-          with_location = t != comm::exit_ok;
-                                           /* no break */
-        case comm::stdout:
-        case comm::stderr:
-          {
-            datatypes::fixed_string msg = { 0, 0 };
-            fd_.read_loop(&msg.len, sizeof(msg.len));
-            assert(!with_location || msg.len);
-            if (with_location)
-              {
-                fd_.read_loop(&location.len, sizeof(location.len));
-                assert(location.len);
-                char *buff = static_cast<char*>(wrapped::malloc(location.len));
-                assert(buff);
-                fd_.read_loop(buff, location.len);
-                location.str = buff;
-                msg.len -= location.len + sizeof(location.len);
-              }
-            char *buff = static_cast<char*>(wrapped::malloc(msg.len));
-            fd_.read_loop(buff, msg.len);
-            msg.str = buff;
-            output_data(t, s, msg, location);
-          }
-          break;
-        default:
-          assert("unreachable code reached" == 0);
-          /* no break */
+          if (!fill_buffer()) return true;
         }
+      while (!parse_frames());
     }
     catch (posix_error &)
     {
@@ -28,10 +28,15 @@
 #define PRESENTATION_READER_HPP
 
 #include "test_case_result.hpp"
+#include "result_table.hpp"
+#include "journal.hpp"
 
 #include "io.hpp"
+#include <vector>
 namespace crpcut {
   class registrator_list;
+  class run_statistics;
+  class event_stream;
   namespace output {
     class formatter;
   }
@@ -47,25 +52,52 @@ namespace crpcut {
                         output::formatter      &summary_fmt,
                         bool                    verbose,
                         const char             *working_dir,
-                        registrator_list       &reg);
+                        registrator_list       &reg,
+                        journal                *log = 0,
+                        run_statistics         *stats = 0,
+                        event_stream           *events = 0);
+    // For presenting in the process that runs the tests, where frames
+    // are not read from a pipe, but passed to present_frame().
+    presentation_reader(output::formatter      &fmt,
+                        output::formatter      &summary_fmt,
+                        bool                    verbose,
+                        const char             *working_dir,
+                        registrator_list       &reg,
+                        journal                *log = 0,
+                        run_statistics         *stats = 0,
+                        event_stream           *events = 0);
     virtual ~presentation_reader();
+    void replay(const journal::entry &e);
     virtual bool read();
     virtual bool write();
     virtual void exception();
+    void present_frame(pid_t       test_case_id,
+                       comm::type  t,
+                       test_phase  phase,
+                       const char *payload,
+                       size_t      len);
+    // Presents the tests that never ran, the run summary, and the
+    // statistics.
+    void finish();
     unsigned num_failed() const;
   private:
     test_case_result *find_result_for(pid_t);
-    void begin_test(test_case_result*);
-    void end_test(test_phase phase, test_case_result *);
-    void nonempty_dir(test_case_result *);
+    bool fill_buffer();
+    bool parse_frames();
+    void begin_test(test_case_result*, const char *payload, size_t len);
+    void end_test(test_phase phase, test_case_result *,
+                  const char *payload, size_t len);
+    void nonempty_dir(test_case_result *, const char *payload, size_t len);
+    void add_overhead(const datatypes::list_elem<event> &metrics);
     void output_data(comm::type               t,
                      test_case_result        *result,
                      datatypes::fixed_string  msg,
                      datatypes::fixed_string  location);
     void blocked_test();
-    datatypes::list_elem<test_case_result>  messages_;
-    poll<io>                               &poller_;
-    comm::rfile_descriptor                 &fd_;
+    void schedule();
+    result_table                            results_;
+    poll<io>                               *poller_;
+    comm::rfile_descriptor                 *fd_;
     output::formatter                      &fmt_;
     output::formatter                      &summary_fmt_;
     const char                             *working_dir_;
@@ -73,6 +105,12 @@ namespace crpcut {
     unsigned                                num_run_;
     unsigned                                num_failed_;
     registrator_list                       &reg_;
+    journal                                *log_;
+    run_statistics                         *stats_;
+    event_stream                           *events_;
+    std::vector<char>                       buffer_;
+    size_t                                  buffer_begin_;
+    size_t                                  buffer_end_;
     presentation_reader();
     presentation_reader(const presentation_reader&);
     presentation_reader& operator=(const presentation_reader&);
@@ -26,6 +26,7 @@
 
 #include "process_control.hpp"
 #include "wrapped/posix_encapsulation.hpp"
+#include <cerrno>
 namespace crpcut {
   process_control::~process_control()
   {
@@ -46,9 +47,19 @@ namespace crpcut {
 
 
   int
-  process_control::waitid(idtype_t t, id_t i, siginfo_t *si, int o)
+  process_control::waitid(idtype_t t, id_t i, siginfo_t *si, int o,
+                          struct rusage *usage)
   {
-    return wrapped::waitid(t, i, si, o);
+    // Only wait4() tells the resource usage of one child, so the child
+    // is found with waitid() but left for wait4() to reap.
+    int rv = wrapped::waitid(t, i, si, o | WNOWAIT);
+    if (rv != 0 || si->si_pid == 0 || (o & WNOWAIT)) return rv;
+    int status;
+    pid_t pid;
+    do {
+      pid = wrapped::wait4(si->si_pid, &status, 0, usage);
+    } while (pid == -1 && errno == EINTR);
+    return pid == -1 ? -1 : 0;
   }
 
   process_control *process_control_root()
@@ -43,7 +43,10 @@ namespace crpcut {
     virtual ~process_control();
     virtual int getrusage(int, struct rusage *);
     virtual int killpg(int pid, int signo);
-    virtual int waitid(idtype_t t, id_t i, siginfo_t *si, int o);
+    // As waitid(), but also fills in the resource usage of the child
+    // reaped, as wait4() does
+    virtual int waitid(idtype_t t, id_t i, siginfo_t *si, int o,
+                       struct rusage *usage);
   };
 
 }
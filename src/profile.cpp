@@ -0,0 +1,202 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "profile.hpp"
+#include "symbols.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#include <map>
+#include <string>
+#include <sstream>
+#include <vector>
+extern "C" {
+#  include <sys/mman.h>
+#  include <sys/time.h>
+#  include <signal.h>
+#  include <errno.h>
+#ifdef USE_BACKTRACE
+#  include <execinfo.h>
+#endif
+}
+
+namespace crpcut {
+  namespace wrapped {
+    int getitimer(int w, struct itimerval *v);
+    int setitimer(int w, const struct itimerval *iv, struct itimerval *ov);
+  }
+
+  namespace {
+    // frames[0] is profile::on_signal() and frames[1] the signal trampoline
+    const int handler_frames = 2;
+  }
+
+  const std::size_t profile::max_samples;
+  profile *profile::current_;
+
+  profile *
+  profile
+  ::create(std::size_t num)
+  {
+    void *addr = wrapped::mmap(0, num * sizeof(profile),
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_ANONYMOUS,
+                               -1, 0);
+    if (addr == MAP_FAILED) return 0;
+    return static_cast<profile*>(addr);
+  }
+
+  void
+  profile
+  ::destroy(profile *profiles, std::size_t num)
+  {
+    if (profiles) wrapped::munmap(profiles, num * sizeof(profile));
+  }
+
+  void
+  profile
+  ::reset()
+  {
+    num_samples_ = 0;
+    num_dropped_ = 0;
+    for (std::size_t i = 0; i < max_samples; ++i)
+      {
+        samples_[i].depth = 0;
+      }
+  }
+
+  void
+  profile
+  ::start()
+  {
+#ifdef USE_BACKTRACE
+    struct itimerval v;
+    if (wrapped::getitimer(ITIMER_PROF, &v) != 0) return;
+    if (v.it_value.tv_sec || v.it_value.tv_usec) return;
+    // The first call of backtrace() may load libgcc_s, which must not
+    // happen in the signal handler.
+    void *frame;
+    ::backtrace(&frame, 1);
+    current_ = this;
+    wrapped::signal(SIGPROF, &profile::on_signal);
+    v.it_interval.tv_sec = 0;
+    v.it_interval.tv_usec = interval_us;
+    v.it_value = v.it_interval;
+    wrapped::setitimer(ITIMER_PROF, &v, 0);
+#endif
+  }
+
+  void
+  profile
+  ::on_signal(int)
+  {
+#ifdef USE_BACKTRACE
+    profile *p = current_;
+    if (!p) return;
+    // threads of the test may take the signal at the same time
+    const std::size_t n = __sync_fetch_and_add(&p->num_samples_, 1);
+    if (n >= max_samples)
+      {
+        __sync_fetch_and_add(&p->num_dropped_, 1);
+        return;
+      }
+    const int e = errno;
+    stack &s = p->samples_[n];
+    const int depth = ::backtrace(s.frames, max_depth);
+    __sync_synchronize();
+    s.depth = depth;
+    errno = e;
+#endif
+  }
+
+  void
+  profile
+  ::write_folded(std::ostream &os) const
+  {
+    typedef std::map<std::string, unsigned long> folded;
+    folded stacks;
+    const std::size_t num = num_samples_ < max_samples
+      ? num_samples_
+      : max_samples;
+    for (std::size_t i = 0; i < num; ++i)
+      {
+        const stack &s = samples_[i];
+        const int depth = s.depth;
+        if (depth <= handler_frames) continue;
+
+        // The outermost frames are main() and the runner, in the crpcut
+        // library. The test begins at the first frame after them.
+        int top = depth;
+        bool runner_seen = false;
+        for (int j = depth; j-- > handler_frames;)
+          {
+            if (in_libcrpcut(s.frames[j]))
+              {
+                runner_seen = true;
+              }
+            else if (runner_seen)
+              {
+                top = j + 1;
+                break;
+              }
+          }
+        std::vector<std::string> names;
+        for (int j = top; j-- > handler_frames;)
+          {
+            names.push_back(symbol_name(s.frames[j]));
+          }
+        // What remains of the harness, compiled into the test program,
+        // ends with the call to the test function, if named.
+        std::vector<std::string>::iterator begin = names.begin();
+        for (std::vector<std::string>::iterator j = names.begin();
+             j != names.end();
+             ++j)
+          {
+            if (is_test_wrapper(*j))
+              {
+                begin = j + 1;
+                break;
+              }
+          }
+        std::string line;
+        for (std::vector<std::string>::iterator j = begin;
+             j != names.end();
+             ++j)
+          {
+            if (!line.empty()) line += ';';
+            line += *j;
+          }
+        if (line.empty()) continue;
+        ++stacks[line];
+      }
+    for (folded::const_iterator i = stacks.begin(); i != stacks.end(); ++i)
+      {
+        os << i->first << ' ' << i->second << '\n';
+      }
+    if (num_dropped_)
+      {
+        os << "[dropped] " << num_dropped_ << '\n';
+      }
+  }
+}
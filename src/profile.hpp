@@ -0,0 +1,77 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+#include <crpcut.hpp>
+
+namespace crpcut {
+
+  // Stack samples of one test process, taken on SIGPROF from a
+  // setitimer(ITIMER_PROF) timer, in memory shared between the runner
+  // and the test process of one slot. The samples outlive the test
+  // process, so tests killed for overrunning their deadline can be
+  // profiled too.
+  class profile
+  {
+  public:
+    static const unsigned interval_us = 1000;
+
+    static profile *create(std::size_t num);
+    static void destroy(profile *profiles, std::size_t num);
+    void reset();
+
+    // Arms the timer in the test process. Does nothing if the timer is
+    // already in use, e.g. as the clock for CPU time.
+    void start();
+
+    // Writes the samples as folded stacks, one line per distinct stack,
+    // outermost function first, followed by the number of samples.
+    // Frames from the crpcut library below the test are left out.
+    void write_folded(std::ostream &os) const;
+  private:
+    profile();
+    profile(const profile&);
+    profile& operator=(const profile&);
+    static void on_signal(int);
+
+    static const std::size_t max_samples = 4096;
+    static const int         max_depth   = 64;
+    struct stack
+    {
+      volatile int depth;
+      void        *frames[max_depth];
+    };
+
+    static profile     *current_;
+    volatile std::size_t num_samples_;
+    volatile std::size_t num_dropped_;
+    stack                samples_[max_samples];
+  };
+}
+
+#endif // PROFILE_HPP
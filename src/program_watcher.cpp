@@ -0,0 +1,151 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifdef HAVE_INOTIFY
+#include <crpcut.hpp>
+#include "program_watcher.hpp"
+#include "posix_error.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+extern "C" {
+#  include <sys/inotify.h>
+#  include <sys/select.h>
+#  include <sys/wait.h>
+}
+
+namespace {
+  // A linker writes the executable in several steps (create, write,
+  // chmod, sometimes a rename) so wait until the directory has been quiet
+  // for a short while before the new binary is trusted.
+  static const long settle_time_us = 100000;
+
+  bool fd_is_readable(int fd, long timeout_us)
+  {
+    for (;;)
+      {
+        fd_set rset;
+        FD_ZERO(&rset);
+        FD_SET(fd, &rset);
+        struct timeval tv = { timeout_us / 1000000, timeout_us % 1000000 };
+        int rv = crpcut::wrapped::select(fd + 1, &rset, 0, 0,
+                                         timeout_us < 0 ? 0 : &tv);
+        if (rv == -1 && errno == EINTR) continue;
+        if (rv < 0) throw crpcut::posix_error(errno, "select on inotify");
+        return rv > 0;
+      }
+  }
+
+  bool read_events_for(int fd, const char *name)
+  {
+    union {
+      struct inotify_event ev;
+      char                 buff[4096];
+    } events;
+    const char *buff = events.buff;
+    ssize_t len;
+    do {
+      len = crpcut::wrapped::read(fd, events.buff, sizeof(events.buff));
+    } while (len == -1 && errno == EINTR);
+    if (len <= 0) throw crpcut::posix_error(errno, "read inotify events");
+
+    bool found = false;
+    for (const char *p = buff; p < buff + len;)
+      {
+        const struct inotify_event *ev
+          = reinterpret_cast<const struct inotify_event*>(p);
+        if (ev->len && crpcut::wrapped::strcmp(ev->name, name) == 0)
+          {
+            found = true;
+          }
+        p += sizeof(struct inotify_event) + ev->len;
+      }
+    return found;
+  }
+
+  void wait_for_change(int fd, const char *name)
+  {
+    while (!read_events_for(fd, name))
+      ;
+    while (fd_is_readable(fd, settle_time_us))
+      {
+        (void)read_events_for(fd, name);
+      }
+  }
+}
+
+namespace crpcut {
+  void rerun_on_change(const char *const *argv, std::ostream &err_os)
+  {
+    char path[PATH_MAX];
+    const ssize_t len = wrapped::readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (len < 0) throw posix_error(errno, "readlink /proc/self/exe");
+    path[len] = 0;
+    rerun_on_change(path, argv, err_os);
+  }
+
+  void rerun_on_change(const char        *exe,
+                       const char *const *argv,
+                       std::ostream      &err_os)
+  {
+    char path[PATH_MAX];
+    std::size_t len = wrapped::strlen(exe);
+    if (len >= sizeof(path)) throw posix_error(ENAMETOOLONG, exe);
+    lib::strcpy(path, exe);
+
+    char *name = path + len;
+    while (name != path && name[-1] != '/') --name;
+    if (name == path) throw posix_error(ENOENT, "locating test program");
+
+    int fd = wrapped::inotify_init1(IN_CLOEXEC);
+    if (fd < 0) throw posix_error(errno, "inotify_init1");
+
+    name[-1] = 0;
+    int wd = wrapped::inotify_add_watch(fd, name == path + 1 ? "/" : path,
+                                        IN_CLOSE_WRITE | IN_MOVED_TO);
+    name[-1] = '/';
+    if (wd < 0) throw posix_error(errno, "inotify_add_watch");
+
+    pid_t pid = wrapped::fork();
+    if (pid < 0) throw posix_error(errno, "fork test program");
+    if (pid == 0)
+      {
+        wrapped::close(fd);
+        return;
+      }
+    siginfo_t info;
+    while (wrapped::waitid(P_PID, id_t(pid), &info, WEXITED) == -1
+           && errno == EINTR)
+      ;
+    err_os << "Watching " << path << " for changes\n" << std::flush;
+    for (;;)
+      {
+        wait_for_change(fd, name);
+        wrapped::execv(path, const_cast<char *const*>(argv));
+        err_os << "Failed to restart " << path << ": "
+               << wrapped::strerror(errno) << '\n' << std::flush;
+      }
+  }
+}
+#endif // HAVE_INOTIFY
@@ -26,10 +26,13 @@
 
 #include <crpcut.hpp>
 #include "test_runner.hpp"
+#include "report_ring.hpp"
+#include "packet_writer.hpp"
 #include "clocks/clocks.hpp"
 #include "wrapped/posix_encapsulation.hpp"
 #include "posix_error.hpp"
 #include "sigignore.hpp"
+#include <algorithm>
 
 namespace {
 void make_message(crpcut::datatypes::fixed_string location,
@@ -43,13 +46,126 @@ void make_message(crpcut::datatypes::fixed_string location,
   os << msg;
   os.str().swap(result);
 }
+
+// Reads and throws away what is left of a frame longer than is kept.
+void skip(const crpcut::comm::data_reader &reader, size_t len)
+{
+  char buff[1024];
+  while (len)
+    {
+      const size_t n = std::min(len, sizeof(buff));
+      reader.read_loop(buff, n);
+      len -= n;
+    }
+}
+
+// Reads the length of a frame, which is cut at
+// report_reader::max_message, and left_out what is left of it.
+size_t read_length(const crpcut::comm::data_reader &reader,
+                   size_t                          &left_out)
+{
+  size_t len = 0;
+  reader.read_loop(&len, sizeof(len));
+  left_out = 0;
+  if (len > crpcut::report_reader::max_message)
+    {
+      left_out = len - crpcut::report_reader::max_message;
+      len = crpcut::report_reader::max_message;
+    }
+  return len;
+}
+
+size_t read_message(const crpcut::comm::data_reader &reader,
+                    int                             &t,
+                    std::vector<char>               &buff,
+                    size_t                          &left_out)
+{
+  reader.read_loop(&t, sizeof(crpcut::comm::type));
+  const size_t len = read_length(reader, left_out);
+  buff.resize(crpcut::report_ring::header_size + len);
+  reader.read_loop(&buff[0] + crpcut::report_ring::header_size, len);
+  skip(reader, left_out);
+  return len;
+}
+
+#define ESTR(s) #s
+const char * const type_names[] = { CRPCUT_COMM_MSGS(ESTR) };
+#undef ESTR
 }
 namespace crpcut {
 
+  const size_t report_reader::max_message;
+
   report_reader
   ::report_reader(crpcut_test_monitor *r)
-    : fdreader(r)
+    : fdreader(r),
+      ring_(0),
+      packets_(false),
+      packet_(0),
+      packet_len_(0),
+      packet_pos_(0),
+      partial_(),
+      left_out_(0)
+  {
+  }
+
+  report_reader
+  ::~report_reader()
   {
+    wrapped::free(packet_);
+  }
+
+  void
+  report_reader
+  ::set_channel(report_ring *ring, bool packets)
+  {
+    ring_ = ring;
+    packets_ = packets;
+    packet_len_ = packet_pos_ = 0;
+  }
+
+  void
+  report_reader
+  ::close()
+  {
+    // the ring is the test's own, and nothing is read from it after this
+    report_ring::destroy(ring_);
+    ring_ = 0;
+    // nor is the packet buffer kept for the next test, since every test
+    // has a reader of its own
+    wrapped::free(packet_);
+    packet_ = 0;
+    packet_len_ = packet_pos_ = 0;
+    fdreader::close();
+  }
+
+  ssize_t
+  report_reader
+  ::read(void *buff, size_t len) const
+  {
+    if (!packets_)
+      {
+        return fdreader::read(buff, len);
+      }
+    // Each read from the socket gets one whole packet, which is then
+    // handed out in the pieces asked for.
+    if (packet_pos_ == packet_len_)
+      {
+        if (!packet_)
+          {
+            void *p = wrapped::malloc(packet_writer::max_packet);
+            if (!p) throw std::bad_alloc();
+            packet_ = static_cast<char*>(p);
+          }
+        ssize_t rv = fdreader::read(packet_, packet_writer::max_packet);
+        if (rv <= 0) return rv;
+        packet_len_ = size_t(rv);
+        packet_pos_ = 0;
+      }
+    size_t n = std::min(len, packet_len_ - packet_pos_);
+    wrapped::memcpy(buff, packet_ + packet_pos_, n);
+    packet_pos_ += n;
+    return ssize_t(n);
   }
 
   void
@@ -72,89 +188,229 @@ namespace crpcut {
     mon_->clear_deadline();
   }
 
+  bool
+  report_reader
+  ::drain_ring(int t, size_t len, char *buff, size_t left_out)
+  {
+    // A message from the pipe is either a wakeup, or a message whose place
+    // is at the next marker in the ring.
+    bool marked = t != report_ring::wakeup;
+    std::vector<char> msg;
+    report_ring::pop_result r;
+    while ((r = ring_->pop(msg)) == report_ring::popped)
+      {
+        int rt;
+        size_t rlen;
+        size_t rleft_out = 0;
+        wrapped::memcpy(&rt, &msg[0], sizeof(comm::type));
+        wrapped::memcpy(&rlen, &msg[0] + sizeof(comm::type), sizeof(rlen));
+        if (rt == report_ring::in_pipe)
+          {
+            if (marked)
+              {
+                marked = false;
+                if (!handle_frame(t, len, buff, left_out)) return false;
+                continue;
+              }
+            do
+              {
+                rlen = read_message(*this, rt, msg, rleft_out);
+              }
+            while (rt == report_ring::wakeup);
+          }
+        char *rbuff = &msg[0] + report_ring::header_size;
+        if (!handle_frame(rt, rlen, rbuff, rleft_out)) return false;
+      }
+    if (r == report_ring::corrupt)
+      {
+        // The test has written over its own ring, so nothing more in it
+        // can be trusted, nor placed in order with what comes in the pipe.
+        report_ring::destroy(ring_);
+        ring_ = 0;
+        std::string s;
+        make_message(mon_->get_location(), "Report ring corrupted", s);
+        mon_->crpcut_register_success(false);
+        mon_->send_to_presentation(comm::exit_fail, s.length(), &s[0]);
+        mon_->set_death_note();
+        mon_->kill();
+        return false;
+      }
+    assert(!marked);
+    return true;
+  }
+
   bool
   report_reader
   ::do_read_data()
   {
     comm::type t;
-    int kill_mask = 0;
     sigignore ignore(SIGPIPE);
     try {
-      std::string msg;
       read_loop(&t, sizeof(t));
-      kill_mask = t & comm::kill_me;
-      t = static_cast < comm::type >(t & ~kill_mask);
-      if (t == comm::exit_fail || t == comm::fail || kill_mask)
+      size_t left_out;
+      const size_t len = read_length(*this, left_out);
+      char stack_buff[comm::reporter::frame_size];
+      char *buff = stack_buff;
+      std::vector<char> heap_buff;
+      if (len > sizeof(stack_buff))
         {
-          mon_->crpcut_register_success(false);
+          // a frame from a writer that takes longer ones, e.g. a whole
+          // packet, is read in one piece, since its place may be after
+          // messages still in the ring
+          heap_buff.resize(len);
+          buff = &heap_buff[0];
         }
-      size_t len = 0;
-      read_loop(&len, sizeof(len));
-      char *buff = static_cast<char *>(::alloca(len));
       read_loop(buff, len);
-
-      if (kill_mask)
+      skip(*this, left_out);
+      if (ring_)
         {
-          if (len == 0 || t == comm::set_timeout || t == comm::begin_test)
-            {
-              make_message(mon_->get_location(),
-                           "A child process spawned from the test has misbehaved. Process group killed",
-                           msg);
-              buff = const_cast<char*>(msg.c_str());
-              len = msg.length();
-            }
-          t = comm::exit_fail;
-          mon_->set_phase(child);
-          mon_->kill();
+          return drain_ring(t, len, buff, left_out);
         }
-      switch (t)
+      return handle_frame(t, len, buff, left_out);
+    }
+    catch (posix_error &e)
+    {
+      if (ring_)
         {
-        case comm::set_timeout:
-          set_timeout(buff, len);
-          return true;
-        case comm::cancel_timeout:
-          assert(len == 0);
-          cancel_timeout();
-          return true;
-        case comm::begin_test:
-          mon_->set_phase(running);
-          {
-            void *addr = buff;
-            assert(len == sizeof(struct timeval));
-            struct timeval *start_time = static_cast<struct timeval*>(addr);
-            mon_->set_cputime_at_start(*start_time);
+          // what the test process appended to the ring before it died
+          try {
+            drain_ring(report_ring::wakeup, 0, 0, 0);
           }
-          return true;
-        case comm::end_test:
-          if (!mon_->crpcut_failed())
-            {
-              mon_->set_phase(destroying);
-              return true;
-            }
+          catch (posix_error &)
           {
-            make_message(mon_->get_location(), "Earlier VERIFY failed", msg);
-            buff = const_cast<char*>(msg.c_str());
-            len = msg.length();
-            t = comm::exit_fail;
-            break;
           }
-        default:
-          break; // silence warning
-        }
-      mon_->send_to_presentation(t, len, buff);
-      if (t == comm::exit_ok || t == comm::exit_fail)
-        {
-          mon_->set_death_note();
         }
-    }
-    catch (posix_error &e)
-    {
       if (!e.what() || e.get_errno() == EPIPE)
         {
           return false;
         }
       throw;
     }
+  }
+
+  bool
+  report_reader
+  ::handle_frame(int t, size_t len, char *buff, size_t left_out)
+  {
+    if (t == report_ring::abandoned)
+      {
+        // the producer of the frames so far died before the last one
+        partial_.clear();
+        left_out_ = 0;
+        return true;
+      }
+    // a message is kept up to max_message, and the rest is counted
+    left_out_ += left_out;
+    if (len > max_message - partial_.length())
+      {
+        left_out_ += len - (max_message - partial_.length());
+        len = max_message - partial_.length();
+      }
+    if (t & comm::continued)
+      {
+        partial_.append(buff, len);
+        return true;
+      }
+    bool rv;
+    if (partial_.empty())
+      {
+        rv = handle_message(comm::type(t), len, buff);
+      }
+    else
+      {
+        partial_.append(buff, len);
+        std::string msg;
+        msg.swap(partial_);
+        rv = handle_message(comm::type(t), msg.length(), &msg[0]);
+      }
+    if (left_out_)
+      {
+        present_left_out(t);
+      }
+    return rv;
+  }
+
+  void
+  report_reader
+  ::present_left_out(int t)
+  {
+    const size_t n = size_t(t & ~(comm::kill_me | comm::continued));
+    const size_t num_types = sizeof(type_names)/sizeof(type_names[0]);
+    const char *name = n < num_types ? type_names[n] : "message";
+    std::ostringstream os;
+    const size_t name_len = wrapped::strlen(name);
+    os.write(reinterpret_cast<const char*>(&name_len), sizeof(name_len));
+    os.write(name, std::streamsize(name_len));
+    os << left_out_ << " bytes left out";
+    left_out_ = 0;
+    std::string msg = os.str();
+    mon_->send_to_presentation(comm::truncated, msg.length(), msg.c_str());
+  }
+
+  bool
+  report_reader
+  ::handle_message(comm::type t, size_t len, char *buff)
+  {
+    std::string msg;
+    int kill_mask = t & comm::kill_me;
+    t = static_cast < comm::type >(t & ~kill_mask);
+    if (t == comm::exit_fail || t == comm::fail || kill_mask)
+      {
+        mon_->crpcut_register_success(false);
+      }
+    if (kill_mask)
+      {
+        if (len == 0 || t == comm::set_timeout || t == comm::begin_test)
+          {
+            make_message(mon_->get_location(),
+                         "A child process spawned from the test has misbehaved. Process group killed",
+                         msg);
+            buff = const_cast<char*>(msg.c_str());
+            len = msg.length();
+          }
+        t = comm::exit_fail;
+        mon_->set_phase(child);
+        mon_->kill();
+      }
+    switch (t)
+      {
+      case comm::set_timeout:
+        set_timeout(buff, len);
+        return true;
+      case comm::cancel_timeout:
+        assert(len == 0);
+        cancel_timeout();
+        return true;
+      case comm::begin_test:
+        mon_->set_phase(running);
+        {
+          void *addr = buff;
+          assert(len == sizeof(struct timeval));
+          struct timeval *start_time = static_cast<struct timeval*>(addr);
+          mon_->set_cputime_at_start(*start_time);
+        }
+        return true;
+      case comm::end_test:
+        if (!mon_->crpcut_failed())
+          {
+            mon_->set_phase(destroying);
+            return true;
+          }
+        {
+          make_message(mon_->get_location(), "Earlier VERIFY failed", msg);
+          buff = const_cast<char*>(msg.c_str());
+          len = msg.length();
+          t = comm::exit_fail;
+          break;
+        }
+      default:
+        break; // silence warning
+      }
+    mon_->send_to_presentation(t, len, buff);
+    if (t == comm::exit_ok || t == comm::exit_fail)
+      {
+        mon_->set_death_note();
+      }
     return !kill_mask;
   }
 }
@@ -0,0 +1,250 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "report_ring.hpp"
+#include "posix_error.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#include <algorithm>
+extern "C" {
+#  include <sys/mman.h>
+}
+
+namespace crpcut {
+
+  const std::size_t report_ring::header_size;
+
+  report_ring *
+  report_ring
+  ::create()
+  {
+    void *addr = wrapped::mmap(0, sizeof(report_ring),
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_ANONYMOUS,
+                               -1, 0);
+    if (addr == MAP_FAILED) return 0;
+    report_ring *ring = static_cast<report_ring*>(addr);
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    int rv = pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#ifdef HAVE_ROBUST_MUTEX
+    if (rv == 0) rv = pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+#endif
+    if (rv == 0) rv = pthread_mutex_init(&ring->lock_, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (rv != 0)
+      {
+        wrapped::munmap(addr, sizeof(report_ring));
+        return 0;
+      }
+    return ring;
+  }
+
+  void
+  report_ring
+  ::destroy(report_ring *ring)
+  {
+    if (ring) wrapped::munmap(ring, sizeof(report_ring));
+  }
+
+  bool
+  report_ring
+  ::lock()
+  {
+    int rv = pthread_mutex_lock(&lock_);
+    bool owner_died = false;
+#ifdef HAVE_ROBUST_MUTEX
+    if (rv == EOWNERDEAD)
+      {
+        // head_ is only moved when a frame is complete, so the ring itself
+        // is intact, but the frames of a message may have been cut short
+        owner_died = true;
+        rv = pthread_mutex_consistent(&lock_);
+      }
+#endif
+    if (rv != 0) throw posix_error(rv, "lock report ring");
+    return owner_died;
+  }
+
+  void
+  report_ring
+  ::unlock()
+  {
+    pthread_mutex_unlock(&lock_);
+  }
+
+  void
+  report_ring
+  ::copy_in(std::size_t pos, const void *src, std::size_t len)
+  {
+    const std::size_t offset = pos % capacity;
+    const std::size_t first = std::min(len, capacity - offset);
+    const char *p = static_cast<const char*>(src);
+    wrapped::memcpy(data_ + offset, p, first);
+    if (first < len) wrapped::memcpy(data_, p + first, len - first);
+  }
+
+  void
+  report_ring
+  ::copy_out(std::size_t pos, void *dest, std::size_t len) const
+  {
+    const std::size_t offset = pos % capacity;
+    const std::size_t first = std::min(len, capacity - offset);
+    char *p = static_cast<char*>(dest);
+    wrapped::memcpy(p, data_ + offset, first);
+    if (first < len) wrapped::memcpy(p + first, data_, len - first);
+  }
+
+  report_ring::result
+  report_ring
+  ::append(const void *msg, std::size_t len)
+  {
+    // A message is only appended if there is still room for a marker
+    // after it, so that an overflow can always be marked once the
+    // runner has caught up with the previous one.
+    const std::size_t head = head_;
+    __sync_synchronize();
+    result rv = appended;
+    if (capacity - (head - tail_) >= len + header_size)
+      {
+        copy_in(head, msg, len);
+      }
+    else
+      {
+        while (capacity - (head - tail_) < header_size)
+          {
+            wrapped::sched_yield();
+          }
+        const int marker = in_pipe;
+        const std::size_t zero = 0;
+        copy_in(head, &marker, sizeof(marker));
+        copy_in(head + sizeof(comm::type), &zero, sizeof(zero));
+        len = header_size;
+        rv = overflow;
+      }
+    __sync_synchronize();
+    head_ = head + len;
+    __sync_synchronize();
+    if (rv == appended && tail_ == head) rv = appended_to_empty;
+    return rv;
+  }
+
+  report_ring::pop_result
+  report_ring
+  ::pop(std::vector<char> &msg)
+  {
+    __sync_synchronize();
+    const std::size_t head = head_;
+    const std::size_t tail = tail_;
+    if (head == tail) return empty;
+    const std::size_t filled = head - tail;
+    if (filled < header_size || filled > capacity) return corrupt;
+    __sync_synchronize();
+    std::size_t len;
+    copy_out(tail + sizeof(comm::type), &len, sizeof(len));
+    if (len > filled - header_size) return corrupt;
+    msg.resize(header_size + len);
+    copy_out(tail, &msg[0], header_size + len);
+    __sync_synchronize();
+    tail_ = tail + header_size + len;
+    return popped;
+  }
+
+
+  report_ring_writer
+  ::report_ring_writer(const comm::data_writer &pipe, report_ring *ring)
+    : pipe_(pipe),
+      ring_(ring)
+  {
+  }
+
+  ssize_t
+  report_ring_writer
+  ::write(const void *buff, size_t len) const
+  {
+    return pipe_.write(buff, len);
+  }
+
+  const comm::data_writer &
+  report_ring_writer
+  ::write_loop(const void *buff, size_t len, const char *context) const
+  {
+    assert(len >= report_ring::header_size);
+    switch (ring_->append(buff, len))
+      {
+      case report_ring::appended:
+        break;
+      case report_ring::appended_to_empty:
+        {
+          char msg[report_ring::header_size];
+          const int type = report_ring::wakeup;
+          const std::size_t zero = 0;
+          wrapped::memcpy(msg, &type, sizeof(type));
+          wrapped::memcpy(msg + sizeof(comm::type), &zero, sizeof(zero));
+          pipe_.write_loop(msg, sizeof(msg), context);
+        }
+        break;
+      case report_ring::overflow:
+        pipe_.write_loop(buff, len, context);
+        break;
+      }
+    return *this;
+  }
+  void
+  report_ring_writer
+  ::begin_message() const
+  {
+    if (ring_->lock())
+      {
+        char msg[report_ring::header_size];
+        const int type = report_ring::abandoned;
+        const std::size_t zero = 0;
+        wrapped::memcpy(msg, &type, sizeof(type));
+        wrapped::memcpy(msg + sizeof(comm::type), &zero, sizeof(zero));
+        try {
+          write_loop(msg, sizeof(msg), "report abandoned message");
+        }
+        catch (...)
+          {
+            ring_->unlock();
+            throw;
+          }
+      }
+  }
+
+  void
+  report_ring_writer
+  ::end_message() const
+  {
+    ring_->unlock();
+  }
+
+  size_t
+  report_ring_writer
+  ::max_frame() const
+  {
+    return pipe_.max_frame();
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef REPORT_RING_HPP
+#define REPORT_RING_HPP
+
+#include <crpcut.hpp>
+#include <vector>
+extern "C" {
+#  include <pthread.h>
+}
+
+namespace crpcut {
+
+  // A single producer, single consumer ring of report messages, in memory
+  // shared between the runner and the process of one test. Messages are
+  // stored in the same format as on the report pipe. Since the ring
+  // outlives the test process, every message appended to it is read by
+  // the runner, even if the test process dies right after. Each test gets
+  // a ring of its own, which the runner unmaps when the test is over, so
+  // a process left behind by a test cannot report into the next one.
+  //
+  // The pipe carries a wakeup when a message is appended to an empty ring,
+  // and messages that did not fit, each preceded by an in_pipe marker in
+  // the ring to keep the order. Processes forked by the test report
+  // through the ring too, so producers are serialised by a process shared
+  // mutex in it, held for all frames of a message. It is robust where
+  // supported, so that a producer dying with it held does not stop the
+  // others. The next producer then appends an abandoned marker, telling
+  // the runner to drop the frames of the unfinished message.
+  class report_ring
+  {
+  public:
+    typedef enum { appended, appended_to_empty, overflow } result;
+    typedef enum { empty, popped, corrupt } pop_result;
+    static const int wakeup    = -1;
+    static const int in_pipe   = -2;
+    static const int abandoned = -3;
+    static const std::size_t header_size = sizeof(comm::type)
+                                         + sizeof(std::size_t);
+
+    static report_ring *create();
+    static void destroy(report_ring *ring);
+    // true if the previous producer died with the lock held
+    bool lock();
+    void unlock();
+    result append(const void *msg, std::size_t len);
+    // The header of a message is written by the test process, so it is
+    // not trusted. A length beyond what has been appended makes the ring
+    // corrupt, and nothing more is popped from it.
+    pop_result pop(std::vector<char> &msg);
+  private:
+    report_ring();
+    report_ring(const report_ring&);
+    report_ring& operator=(const report_ring&);
+    void copy_in(std::size_t pos, const void *src, std::size_t len);
+    void copy_out(std::size_t pos, void *dest, std::size_t len) const;
+
+    static const std::size_t capacity = 65536;
+    volatile std::size_t head_;
+    volatile std::size_t tail_;
+    pthread_mutex_t      lock_;
+    char                 data_[capacity];
+  };
+
+  // The report writer of a test process with a ring.
+  class report_ring_writer : public comm::data_writer
+  {
+  public:
+    report_ring_writer(const comm::data_writer &pipe, report_ring *ring);
+    virtual ssize_t write(const void *buff, size_t len) const;
+    virtual const data_writer &
+    write_loop(const void *buff, size_t len,
+               const char *context = "write_loop") const;
+    virtual void begin_message() const;
+    virtual void end_message() const;
+    virtual size_t max_frame() const;
+  private:
+    report_ring_writer(const report_ring_writer&);
+    report_ring_writer& operator=(const report_ring_writer&);
+
+    const comm::data_writer &pipe_;
+    report_ring             *ring_;
+  };
+}
+
+#endif // REPORT_RING_HPP
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include "request_server.hpp"
+#include "posix_error.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+extern "C" {
+#  include <fcntl.h>
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <sys/wait.h>
+}
+
+namespace {
+  bool is_white_space(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  void make_address(struct sockaddr_un &addr, const char *path)
+  {
+    std::size_t len = crpcut::wrapped::strlen(path);
+    if (len >= sizeof(addr.sun_path))
+      {
+        throw crpcut::posix_error(ENAMETOOLONG, "naming server socket");
+      }
+    addr.sun_family = AF_UNIX;
+    crpcut::lib::strcpy(addr.sun_path, path);
+  }
+
+  void reap_finished_children()
+  {
+    for (;;)
+      {
+        siginfo_t info;
+        info.si_pid = 0;
+        int rv = crpcut::wrapped::waitid(P_ALL, 0, &info, WEXITED | WNOHANG);
+        if (rv == -1 && errno == EINTR) continue;
+        if (rv != 0 || info.si_pid == 0) return;
+      }
+  }
+}
+
+namespace crpcut {
+  bool read_request(int fd, char *buff)
+  {
+    std::size_t len = 0;
+    while (len < max_request_len)
+      {
+        ssize_t rv = wrapped::read(fd, buff + len, max_request_len - len);
+        if (rv == -1 && errno == EINTR) continue;
+        if (rv < 0) throw posix_error(errno, "read run request");
+        if (rv == 0) break;
+        const std::size_t end = len + std::size_t(rv);
+        while (len < end)
+          {
+            if (buff[len++] == '\n')
+              {
+                buff[len] = 0;
+                return true;
+              }
+          }
+      }
+    buff[len] = 0;
+    return len < max_request_len;
+  }
+
+  bool split_request(const char *program_name, char *buff,
+                     const char **args)
+  {
+    std::size_t num_args = 0;
+    args[num_args++] = program_name;
+    for (char *s = buff; *s;)
+      {
+        while (is_white_space(*s)) *s++ = 0;
+        if (!*s) break;
+        if (num_args == max_request_args) return false;
+        args[num_args++] = s;
+        while (*s && !is_white_space(*s)) ++s;
+      }
+    args[num_args] = 0;
+    return true;
+  }
+
+  void remove_stale_socket(const char *path)
+  {
+    struct sockaddr_un addr = sockaddr_un();
+    make_address(addr, path);
+    int fd = wrapped::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw posix_error(errno, "socket");
+    const struct sockaddr *p = reinterpret_cast<const struct sockaddr*>(&addr);
+    int rv = wrapped::connect(fd, p, sizeof(addr));
+    int err = errno;
+    wrapped::close(fd);
+    if (rv == 0 || err != ECONNREFUSED) return;
+    // Connecting to a file that is not a socket is refused too, but
+    // only a socket cannot be opened.
+    fd = wrapped::open(path, O_RDONLY | O_NONBLOCK, 0);
+    if (fd >= 0)
+      {
+        wrapped::close(fd);
+        return;
+      }
+    if (errno == ENXIO)
+      {
+        (void)wrapped::remove(path);
+      }
+  }
+
+  const char *const *serve_requests(const char   *program_name,
+                                    const char   *path,
+                                    std::ostream &err_os)
+  {
+    struct sockaddr_un addr = sockaddr_un();
+    make_address(addr, path);
+    remove_stale_socket(path);
+
+    int listen_fd = wrapped::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) throw posix_error(errno, "socket");
+    const struct sockaddr *p = reinterpret_cast<const struct sockaddr*>(&addr);
+    if (wrapped::bind(listen_fd, p, sizeof(addr)) != 0)
+      {
+        throw posix_error(errno, "bind server socket");
+      }
+    if (wrapped::listen(listen_fd, SOMAXCONN) != 0)
+      {
+        throw posix_error(errno, "listen on server socket");
+      }
+    err_os << "Serving run requests on " << path << '\n' << std::flush;
+
+    int conn_fd;
+    for (;;)
+      {
+        conn_fd = wrapped::accept(listen_fd, 0, 0);
+        reap_finished_children();
+        if (conn_fd < 0)
+          {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            throw posix_error(errno, "accept run request");
+          }
+        pid_t pid = wrapped::fork();
+        if (pid == 0) break;
+        wrapped::close(conn_fd);
+        if (pid < 0) throw posix_error(errno, "fork for run request");
+      }
+
+    // child
+    wrapped::close(listen_fd);
+    static char request[max_request_len + 1];
+    const bool complete = read_request(conn_fd, request);
+    wrapped::dup2(conn_fd, 1);
+    wrapped::dup2(conn_fd, 2);
+    wrapped::close(conn_fd);
+    if (!complete)
+      {
+        err_os << "Run request too long\n" << std::flush;
+        wrapped::_Exit(1);
+      }
+
+    static const char *args[max_request_args + 1];
+    if (!split_request(program_name, request, args))
+      {
+        err_os << "Too many arguments in run request\n" << std::flush;
+        wrapped::_Exit(1);
+      }
+    return args;
+  }
+}
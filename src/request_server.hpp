@@ -0,0 +1,67 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef REQUEST_SERVER_HPP
+#define REQUEST_SERVER_HPP
+
+#include <cstddef>
+#include <iosfwd>
+
+namespace crpcut {
+  // The longest request line, and the most arguments of a request,
+  // program name included.
+  static const std::size_t max_request_len  = 4096;
+  static const std::size_t max_request_args = 256;
+
+  // Reads a request line from fd into buff, which holds max_request_len
+  // + 1 characters, and terminates it. The line ends with a newline, or
+  // where the peer stops writing. Returns false if it is too long.
+  bool read_request(int fd, char *buff);
+
+  // Splits the request line in buff, which is changed, at white space,
+  // into args, which holds max_request_args + 1 pointers. The first is
+  // program_name, and the last is 0. Returns false if there are too
+  // many words.
+  bool split_request(const char *program_name, char *buff,
+                     const char **args);
+
+  // Removes the socket at path, if it is left behind by a server that
+  // died. A socket someone is still listening on, or any other file, is
+  // not touched.
+  void remove_stale_socket(const char *path);
+
+  // Listens on a Unix domain socket at path, and serves run requests until
+  // killed. A request is one line of white space separated command line
+  // arguments. Each connection is handed to a forked child, which returns
+  // from this function with stdout and stderr redirected to the connection.
+  // The return value is the argv for the request, i.e. program_name
+  // followed by the words of the request line. Only ever returns in a child.
+  const char *const *serve_requests(const char   *program_name,
+                                    const char   *path,
+                                    std::ostream &err_os);
+}
+
+#endif // REQUEST_SERVER_HPP
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "result_arena.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#include <new>
+
+namespace {
+  const std::size_t alignment = 2 * sizeof(void*);
+
+  inline std::size_t aligned(std::size_t size)
+  {
+    return (size + alignment - 1) & ~(alignment - 1);
+  }
+}
+
+namespace crpcut {
+
+  struct result_arena::chunk
+  {
+    chunk       *next;
+    std::size_t  size;
+    char *mem() { return reinterpret_cast<char*>(this) + aligned(sizeof(chunk)); }
+  };
+
+  const std::size_t result_arena::chunk_size;
+
+  result_arena
+  ::result_arena()
+    : chunks_(0),
+      used_(0)
+  {
+  }
+
+  result_arena
+  ::~result_arena()
+  {
+    while (chunks_)
+      {
+        chunk *c = chunks_;
+        chunks_ = c->next;
+        wrapped::free(c);
+      }
+  }
+
+  result_arena::chunk *
+  result_arena
+  ::new_chunk(std::size_t size)
+  {
+    void *p = wrapped::malloc(aligned(sizeof(chunk)) + size);
+    if (!p) throw std::bad_alloc();
+    chunk *c = static_cast<chunk*>(p);
+    c->next = 0;
+    c->size = size;
+    return c;
+  }
+
+  void *
+  result_arena
+  ::allocate(std::size_t size)
+  {
+    size = aligned(size);
+    if (size > chunk_size / 4)
+      {
+        // large ones get a chunk of their own, behind the current one
+        chunk *c = new_chunk(size);
+        if (!chunks_)
+          {
+            chunks_ = c;
+            used_ = size;
+          }
+        else
+          {
+            c->next = chunks_->next;
+            chunks_->next = c;
+          }
+        return c->mem();
+      }
+    if (!chunks_ || chunks_->size - used_ < size)
+      {
+        chunk *c = new_chunk(chunk_size);
+        c->next = chunks_;
+        chunks_ = c;
+        used_ = 0;
+      }
+    void *p = chunks_->mem() + used_;
+    used_ += size;
+    return p;
+  }
+
+  datatypes::fixed_string
+  result_arena
+  ::copy(const char *str, std::size_t len)
+  {
+    char *p = static_cast<char*>(allocate(len));
+    wrapped::memcpy(p, str, len);
+    return datatypes::fixed_string::make(p, len);
+  }
+}
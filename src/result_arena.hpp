@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef RESULT_ARENA_HPP
+#define RESULT_ARENA_HPP
+
+#include <crpcut.hpp>
+
+namespace crpcut {
+
+  // Bump allocator for what the presenter keeps of a test until the test
+  // ends. Memory is taken from the heap in chunks, and is only released,
+  // all at once, when the arena is destroyed. Objects placed in it are
+  // never destroyed by the arena.
+  class result_arena
+  {
+  public:
+    static const std::size_t chunk_size = 4096;
+    result_arena();
+    ~result_arena();
+    void *allocate(std::size_t size);
+    datatypes::fixed_string copy(const char *str, std::size_t len);
+  private:
+    struct chunk;
+    result_arena(const result_arena&);
+    result_arena& operator=(const result_arena&);
+    static chunk *new_chunk(std::size_t size);
+
+    chunk       *chunks_;
+    std::size_t  used_;
+  };
+}
+
+#endif // RESULT_ARENA_HPP
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "result_table.hpp"
+#include "test_case_result.hpp"
+
+namespace crpcut {
+
+  result_table
+  ::result_table()
+    : slots_(16),
+      size_(0)
+  {
+  }
+
+  std::size_t
+  result_table
+  ::home_of(pid_t id) const
+  {
+    // Fibonacci hashing, since consecutive pids are common
+    const unsigned long h = (unsigned long)(id) * 2654435761UL;
+    return std::size_t(h ^ (h >> 16)) & (slots_.size() - 1);
+  }
+
+  std::size_t
+  result_table
+  ::slot_of(pid_t id) const
+  {
+    const std::size_t mask = slots_.size() - 1;
+    std::size_t i = home_of(id);
+    while (slots_[i] && slots_[i]->id != id)
+      {
+        i = (i + 1) & mask;
+      }
+    return i;
+  }
+
+  test_case_result *
+  result_table
+  ::find(pid_t id) const
+  {
+    return slots_[slot_of(id)];
+  }
+
+  void
+  result_table
+  ::insert(test_case_result *r)
+  {
+    if ((size_ + 1) * 2 > slots_.size())
+      {
+        grow();
+      }
+    std::size_t i = slot_of(r->id);
+    assert(!slots_[i]);
+    slots_[i] = r;
+    ++size_;
+  }
+
+  void
+  result_table
+  ::erase(pid_t id)
+  {
+    const std::size_t mask = slots_.size() - 1;
+    std::size_t hole = slot_of(id);
+    if (!slots_[hole]) return;
+    slots_[hole] = 0;
+    --size_;
+    for (std::size_t i = (hole + 1) & mask; slots_[i]; i = (i + 1) & mask)
+      {
+        // move back the entries that can no longer be found past the hole
+        const std::size_t home = home_of(slots_[i]->id);
+        if (((i - home) & mask) >= ((i - hole) & mask))
+          {
+            slots_[hole] = slots_[i];
+            slots_[i] = 0;
+            hole = i;
+          }
+      }
+  }
+
+  test_case_result *
+  result_table
+  ::any() const
+  {
+    for (std::size_t i = 0; i < slots_.size(); ++i)
+      {
+        if (slots_[i]) return slots_[i];
+      }
+    return 0;
+  }
+
+  std::size_t
+  result_table
+  ::size() const
+  {
+    return size_;
+  }
+
+  void
+  result_table
+  ::grow()
+  {
+    std::vector<test_case_result*> old(slots_.size() * 2);
+    old.swap(slots_);
+    for (std::size_t i = 0; i < old.size(); ++i)
+      {
+        if (old[i]) slots_[slot_of(old[i]->id)] = old[i];
+      }
+  }
+}
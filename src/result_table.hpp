@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef RESULT_TABLE_HPP
+#define RESULT_TABLE_HPP
+
+#include <vector>
+#include <cstddef>
+extern "C" {
+#  include <sys/types.h>
+}
+
+namespace crpcut {
+
+  struct test_case_result;
+
+  // The results of the tests being presented, keyed by the id of the test.
+  // Open addressing with linear probing. Erased entries are filled by
+  // shifting the rest of their run back, so there are no tombstones.
+  class result_table
+  {
+  public:
+    result_table();
+    test_case_result *find(pid_t id) const;
+    void insert(test_case_result *r);
+    void erase(pid_t id);
+    // Any one result, for emptying the table. 0 if it is empty.
+    test_case_result *any() const;
+    std::size_t size() const;
+  private:
+    std::size_t home_of(pid_t id) const;
+    std::size_t slot_of(pid_t id) const;
+    void grow();
+
+    std::vector<test_case_result*> slots_;
+    std::size_t                    size_;
+  };
+}
+
+#endif // RESULT_TABLE_HPP
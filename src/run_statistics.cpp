@@ -0,0 +1,224 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "run_statistics.hpp"
+#include <algorithm>
+
+namespace {
+  // nearest rank, of sorted durations
+  unsigned long percentile(const std::vector<unsigned long> &v, unsigned p)
+  {
+    std::size_t rank = (v.size()*p + 99U)/100U;
+    return v[rank ? rank - 1 : 0];
+  }
+
+  bool slower(const crpcut::run_statistics::test_time &lh,
+              const crpcut::run_statistics::test_time &rh)
+  {
+    return lh.duration_us > rh.duration_us;
+  }
+}
+
+namespace crpcut {
+
+  const std::size_t run_statistics::num_slowest;
+
+  run_statistics
+  ::run_statistics(std::size_t num_slots, bool with_overhead)
+    : num_slots_(num_slots),
+      num_running_(0),
+      started_(false),
+      first_us_(0),
+      last_us_(0),
+      cputime_us_(0),
+      walltime_us_(0),
+      busy_us_(0),
+      blocked_us_(0),
+      idle_us_(0),
+      unclaimed_us_(0),
+      samples_(),
+      with_overhead_(with_overhead),
+      overhead_()
+  {
+  }
+
+  void
+  run_statistics
+  ::advance(unsigned long now_us)
+  {
+    if (!started_)
+      {
+        started_ = true;
+        first_us_ = last_us_ = now_us;
+        return;
+      }
+    if (now_us <= last_us_) return;
+    const unsigned long elapsed = now_us - last_us_;
+    last_us_ = now_us;
+    const std::size_t running = std::min(num_running_, num_slots_);
+    busy_us_ += elapsed*running;
+    unclaimed_us_ += elapsed*(num_slots_ - running);
+  }
+
+  void
+  run_statistics
+  ::begin_test(unsigned long now_us, unsigned long stalled_us)
+  {
+    advance(now_us);
+    ++num_running_;
+    // of the idle slot time until now, the runner knows what was
+    // spent waiting for dependencies
+    const unsigned long blocked = std::min(stalled_us, unclaimed_us_);
+    blocked_us_ += blocked;
+    idle_us_ += unclaimed_us_ - blocked;
+    unclaimed_us_ = 0;
+  }
+
+  void
+  run_statistics
+  ::end_test(unsigned long      now_us,
+             const std::string &name,
+             const std::string &tag,
+             unsigned long      duration_us,
+             unsigned long      cputime_us)
+  {
+    advance(now_us);
+    if (num_running_) --num_running_;
+    walltime_us_ = last_us_ - first_us_;
+    cputime_us_ += cputime_us;
+    std::string::size_type pos = name.rfind("::");
+    sample s = {
+      name,
+      pos == std::string::npos ? std::string() : name.substr(0, pos),
+      tag,
+      duration_us
+    };
+    samples_.push_back(s);
+  }
+
+  void
+  run_statistics
+  ::add_overhead(const std::string &name, unsigned long value)
+  {
+    sums::iterator i = overhead_.find(name);
+    if (i == overhead_.end())
+      {
+        sum s = { 0, 0, 0 };
+        i = overhead_.insert(std::make_pair(name, s)).first;
+      }
+    sum &s = i->second;
+    ++s.count;
+    s.total += value;
+    s.max = std::max(s.max, value);
+  }
+
+  bool
+  run_statistics
+  ::empty() const
+  {
+    return samples_.empty();
+  }
+
+  run_statistics::test_times
+  run_statistics
+  ::slowest() const
+  {
+    test_times rv;
+    rv.reserve(samples_.size());
+    for (samples::const_iterator i = samples_.begin();
+         i != samples_.end();
+         ++i)
+      {
+        test_time t = { i->name, i->duration_us };
+        rv.push_back(t);
+      }
+    const std::size_t n = std::min(rv.size(), num_slowest);
+    std::partial_sort(rv.begin(), rv.begin() + long(n), rv.end(), slower);
+    rv.resize(n);
+    return rv;
+  }
+
+  run_statistics::distributions
+  run_statistics
+  ::group(std::string sample::*key) const
+  {
+    typedef std::map<std::string, std::vector<unsigned long> > groups;
+    groups g;
+    for (samples::const_iterator i = samples_.begin();
+         i != samples_.end();
+         ++i)
+      {
+        const std::string &name = (*i).*key;
+        if (name.empty()) continue;
+        g[name].push_back(i->duration_us);
+      }
+    distributions rv;
+    for (groups::iterator i = g.begin(); i != g.end(); ++i)
+      {
+        std::vector<unsigned long> &v = i->second;
+        std::sort(v.begin(), v.end());
+        distribution d = {
+          i->first,
+          v.size(),
+          percentile(v, 50),
+          percentile(v, 90),
+          v.back()
+        };
+        rv.push_back(d);
+      }
+    return rv;
+  }
+
+  run_statistics::distributions
+  run_statistics
+  ::per_suite() const
+  {
+    return group(&sample::suite);
+  }
+
+  run_statistics::distributions
+  run_statistics
+  ::per_tag() const
+  {
+    return group(&sample::tag);
+  }
+
+  run_statistics::figures
+  run_statistics
+  ::overhead() const
+  {
+    figures rv;
+    for (sums::const_iterator i = overhead_.begin();
+         i != overhead_.end();
+         ++i)
+      {
+        const sum &s = i->second;
+        figure f = { i->first, s.count, s.total/s.count, s.max };
+        rv.push_back(f);
+      }
+    return rv;
+  }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef RUN_STATISTICS_HPP
+#define RUN_STATISTICS_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstddef>
+
+namespace crpcut {
+
+  // Timing statistics of a run, collected by the presenter, for the
+  // summary at the end. Slot time is the product of wall time and the
+  // number of slots, i.e. concurrently running test processes. A slot
+  // that is not running a test, while all tests that are yet to start
+  // wait for their dependencies, is idle for dependency blocking. The
+  // runner measures that time and sends it with the start of the next
+  // test. Other idle slot time, e.g. while the runner starts a test, or
+  // after the last start with tests blocked by failed dependencies, is
+  // idle for other reasons. With overhead, figures
+  // of the cost of running the tests, as measured by the runner and by
+  // the presenter, are summarised by their mean and max.
+  class run_statistics
+  {
+  public:
+    static const std::size_t num_slowest = 10;
+    struct test_time
+    {
+      std::string   name;
+      unsigned long duration_us;
+    };
+    struct distribution
+    {
+      std::string   name;
+      std::size_t   count;
+      unsigned long p50_us;
+      unsigned long p90_us;
+      unsigned long max_us;
+    };
+    struct figure
+    {
+      std::string   name;
+      std::size_t   count;
+      unsigned long mean;
+      unsigned long max;
+    };
+    typedef std::vector<test_time>    test_times;
+    typedef std::vector<distribution> distributions;
+    typedef std::vector<figure>       figures;
+
+    run_statistics(std::size_t num_slots, bool with_overhead = false);
+    // stalled_us is the slot time the runner was held up by dependencies
+    // since the last start.
+    void begin_test(unsigned long now_us, unsigned long stalled_us);
+    void end_test(unsigned long      now_us,
+                  const std::string &name,
+                  const std::string &tag,
+                  unsigned long      duration_us,
+                  unsigned long      cputime_us);
+    void add_overhead(const std::string &name, unsigned long value);
+    bool with_overhead() const { return with_overhead_; }
+    bool empty() const;
+    // The slowest tests, slowest first.
+    test_times slowest() const;
+    // Durations of tests in the same suite, i.e. in the same namespace
+    // or fixture, and with the same tag. Tests that are neither in a
+    // suite, nor tagged, are not counted.
+    distributions per_suite() const;
+    distributions per_tag() const;
+    figures overhead() const;
+    unsigned long cputime_us() const { return cputime_us_; }
+    unsigned long walltime_us() const { return walltime_us_; }
+    std::size_t num_slots() const { return num_slots_; }
+    unsigned long busy_slot_us() const { return busy_us_; }
+    unsigned long blocked_slot_us() const { return blocked_us_; }
+    unsigned long idle_slot_us() const { return idle_us_ + unclaimed_us_; }
+  private:
+    struct sample
+    {
+      std::string   name;
+      std::string   suite;
+      std::string   tag;
+      unsigned long duration_us;
+    };
+    typedef std::vector<sample> samples;
+    struct sum
+    {
+      std::size_t   count;
+      unsigned long total;
+      unsigned long max;
+    };
+    typedef std::map<std::string, sum> sums;
+    void advance(unsigned long now_us);
+    distributions group(std::string sample::*key) const;
+
+    std::size_t   num_slots_;
+    std::size_t   num_running_;
+    bool          started_;
+    unsigned long first_us_;
+    unsigned long last_us_;
+    unsigned long cputime_us_;
+    unsigned long walltime_us_;
+    unsigned long busy_us_;
+    unsigned long blocked_us_;
+    unsigned long idle_us_;
+    unsigned long unclaimed_us_; // idle since a test last started
+    samples       samples_;
+    bool          with_overhead_;
+    sums          overhead_;
+  };
+}
+
+#endif // RUN_STATISTICS_HPP
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "runner_stats.hpp"
+#include "clocks/clocks.hpp"
+#include <new>
+
+namespace crpcut {
+
+  std::size_t
+  runner_stats
+  ::space_for(std::size_t num_slots)
+  {
+    return buffer_vector<slot>::space_for(num_slots);
+  }
+
+  runner_stats
+  ::runner_stats(void *storage, std::size_t num_slots)
+    : slots_(storage, num_slots)
+  {
+    const slot s = { clocks::monotonic::timestamp_absolute(), 0, 0, 0 };
+    for (std::size_t i = 0; i < num_slots; ++i)
+      {
+        slots_.push_back(s);
+      }
+  }
+
+  void
+  runner_stats
+  ::begin_test(unsigned n)
+  {
+    slot &s = slots_.at(n);
+    s.start_latency_us = 0;
+    s.messages = 0;
+    s.message_bytes = 0;
+  }
+
+  void
+  runner_stats
+  ::enter_body(unsigned n)
+  {
+    slot &s = slots_.at(n);
+    s.start_latency_us = clocks::monotonic::timestamp_absolute() - s.free_us;
+  }
+
+  void
+  runner_stats
+  ::message(unsigned n, std::size_t len)
+  {
+    slot &s = slots_.at(n);
+    ++s.messages;
+    s.message_bytes += len;
+  }
+
+  void
+  runner_stats
+  ::end_test(unsigned n)
+  {
+    slots_.at(n).free_us = clocks::monotonic::timestamp_absolute();
+  }
+
+  unsigned long
+  runner_stats
+  ::start_latency_us(unsigned n) const
+  {
+    return slots_.at(n).start_latency_us;
+  }
+
+  unsigned long
+  runner_stats
+  ::messages(unsigned n) const
+  {
+    return slots_.at(n).messages;
+  }
+
+  unsigned long
+  runner_stats
+  ::message_bytes(unsigned n) const
+  {
+    return slots_.at(n).message_bytes;
+  }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef RUNNER_STATS_HPP
+#define RUNNER_STATS_HPP
+
+#include "buffer_vector.hpp"
+
+namespace crpcut {
+
+  // The cost of running tests, as paid by the process that runs them,
+  // per slot, i.e. per concurrently running test process. The start
+  // latency is the time from the slot was freed by the previous test,
+  // or from the start of the run, until the body of the test is
+  // entered. Messages are those passed on to the presenter for the
+  // test.
+  class runner_stats
+  {
+    struct slot
+    {
+      unsigned long free_us;
+      unsigned long start_latency_us;
+      unsigned long messages;
+      unsigned long message_bytes;
+    };
+  public:
+    static std::size_t space_for(std::size_t num_slots);
+    runner_stats(void *storage, std::size_t num_slots);
+    void begin_test(unsigned slot);
+    void enter_body(unsigned slot);
+    void message(unsigned slot, std::size_t len);
+    void end_test(unsigned slot);
+    unsigned long start_latency_us(unsigned slot) const;
+    unsigned long messages(unsigned slot) const;
+    unsigned long message_bytes(unsigned slot) const;
+  private:
+    runner_stats(const runner_stats&);
+    runner_stats& operator=(const runner_stats&);
+
+    buffer_vector<slot> slots_;
+  };
+}
+
+#endif // RUNNER_STATS_HPP
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include "../perf_counters.hpp"
+
+namespace crpcut {
+  namespace scope {
+    counter_base::counter_base(event                   e,
+                               unsigned long long      limit,
+                               datatypes::fixed_string location)
+      : fd_(-1),
+        owner_(true),
+        event_(e),
+        fallback_(false),
+        limit_(limit),
+        location_(location)
+    {
+      fd_ = perf::open(e, 0, false, fallback_);
+    }
+
+    counter_base::counter_base(const counter_base &r)
+      : fd_(r.fd_),
+        owner_(r.owner_),
+        event_(r.event_),
+        fallback_(r.fallback_),
+        limit_(r.limit_),
+        location_(r.location_)
+    {
+      r.fd_ = -1;
+      r.owner_ = false;
+    }
+
+    counter_base::~counter_base()
+    {
+      if (fd_ >= 0) wrapped::close(fd_);
+    }
+
+    bool counter_base::read(unsigned long long &count) const
+    {
+      return perf::read(fd_, count);
+    }
+
+    const char *counter_base::event_name() const
+    {
+      static const char *const names[] = {
+        "INSTRUCTIONS", "CYCLES", "BRANCH_MISSES", "CACHE_MISSES"
+      };
+      return names[event_];
+    }
+
+    const char *counter_base::fallback_name() const
+    {
+      return fallback_ ? perf::name(event_, true) : 0;
+    }
+
+    const char *counter_base::max::name()
+    {
+      return "MAX";
+    }
+
+    bool counter_base::max::busted(unsigned long long count,
+                                   unsigned long long limit)
+    {
+      return count > limit;
+    }
+  }
+}
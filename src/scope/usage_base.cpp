@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <crpcut.hpp>
+#include "../wrapped/posix_encapsulation.hpp"
+extern "C" {
+#  include <sys/resource.h>
+}
+
+namespace {
+  struct rusage thread_usage()
+  {
+#ifdef RUSAGE_THREAD
+    static const int who = RUSAGE_THREAD;
+#else
+    static const int who = RUSAGE_SELF;
+#endif
+    struct rusage usage = rusage();
+    crpcut::wrapped::getrusage(who, &usage);
+    return usage;
+  }
+}
+
+namespace crpcut {
+  namespace scope {
+    usage_base::usage_base(unsigned long           start,
+                           datatypes::fixed_string location)
+      : start_(start),
+        location_(location)
+    {
+    }
+
+    const char *usage_base::max::name()
+    {
+      return "MAX";
+    }
+
+    bool usage_base::max::busted(unsigned long count, unsigned long limit)
+    {
+      return count > limit;
+    }
+
+    const char *usage_base::major_faults::name()
+    {
+      return "MAJOR_FAULTS";
+    }
+
+    unsigned long usage_base::major_faults::now()
+    {
+      return (unsigned long)thread_usage().ru_majflt;
+    }
+
+    const char *usage_base::minor_faults::name()
+    {
+      return "MINOR_FAULTS";
+    }
+
+    unsigned long usage_base::minor_faults::now()
+    {
+      return (unsigned long)thread_usage().ru_minflt;
+    }
+
+    const char *usage_base::voluntary_switches::name()
+    {
+      return "VOLUNTARY_SWITCHES";
+    }
+
+    unsigned long usage_base::voluntary_switches::now()
+    {
+      return (unsigned long)thread_usage().ru_nvcsw;
+    }
+
+    const char *usage_base::involuntary_switches::name()
+    {
+      return "INVOLUNTARY_SWITCHES";
+    }
+
+    unsigned long usage_base::involuntary_switches::now()
+    {
+      return (unsigned long)thread_usage().ru_nivcsw;
+    }
+  }
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "stack_snapshot.hpp"
+#include "clocks/clocks.hpp"
+#include "fsfuncs.hpp"
+#include "symbols.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#include <cstdlib>
+#include <sstream>
+extern "C" {
+#  include <sys/mman.h>
+#  include <sys/select.h>
+#  include <signal.h>
+#  include <errno.h>
+#ifdef USE_BACKTRACE
+#  include <execinfo.h>
+#endif
+}
+
+namespace crpcut {
+
+  namespace {
+    // frames[0] is stack_snapshot::on_signal() and frames[1] the signal
+    // trampoline
+    const int handler_frames = 2;
+
+    // Whether signo is in the signal mask field of a /proc status file.
+    bool has_signal(const std::string &name, const char *field, int signo)
+    {
+      std::string status;
+      if (!read_file(name, status)) return false;
+      std::string::size_type begin = status.find(field);
+      if (begin == std::string::npos) return false;
+      begin = status.find_first_not_of(" \t", begin + wrapped::strlen(field));
+      if (begin == std::string::npos) return false;
+      std::string::size_type end
+        = status.find_first_not_of("0123456789abcdefABCDEF", begin);
+      if (end == std::string::npos) end = status.length();
+      const std::size_t bit = std::size_t(signo - 1);
+      if (bit / 4 >= end - begin) return false;
+      const char c = status[end - 1 - bit / 4];
+      const int nibble = c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+      return (nibble >> (bit % 4)) & 1;
+    }
+  }
+
+  const int stack_snapshot::max_threads;
+  stack_snapshot *stack_snapshot::current_;
+
+  stack_snapshot *
+  stack_snapshot
+  ::create(std::size_t num)
+  {
+    void *addr = wrapped::mmap(0, num * sizeof(stack_snapshot),
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_ANONYMOUS,
+                               -1, 0);
+    if (addr == MAP_FAILED) return 0;
+    return static_cast<stack_snapshot*>(addr);
+  }
+
+  void
+  stack_snapshot
+  ::destroy(stack_snapshot *snapshots, std::size_t num)
+  {
+    if (snapshots) wrapped::munmap(snapshots, num * sizeof(stack_snapshot));
+  }
+
+  void
+  stack_snapshot
+  ::reset()
+  {
+    num_signalled_ = 0;
+    num_claimed_ = 0;
+    num_done_ = 0;
+    for (int i = 0; i < max_threads; ++i)
+      {
+        stacks_[i].depth = 0;
+      }
+  }
+
+  void
+  stack_snapshot
+  ::arm()
+  {
+#if defined(USE_BACKTRACE) && defined(HAVE_TGKILL)
+    // The first calls of backtrace() and gettid() may load code, which
+    // must not happen in the signal handler.
+    void *frame;
+    ::backtrace(&frame, 1);
+    wrapped::gettid();
+    current_ = this;
+    wrapped::signal(SIGURG, &stack_snapshot::on_signal);
+#endif
+  }
+
+  void
+  stack_snapshot
+  ::on_signal(int)
+  {
+#if defined(USE_BACKTRACE) && defined(HAVE_TGKILL)
+    stack_snapshot *p = current_;
+    if (!p) return;
+    const int e = errno;
+    const int n = __sync_fetch_and_add(&p->num_claimed_, 1);
+    if (n < max_threads)
+      {
+        stack &s = p->stacks_[n];
+        s.tid = wrapped::gettid();
+        const int depth = ::backtrace(s.frames, max_depth);
+        __sync_synchronize();
+        s.depth = depth;
+      }
+    __sync_fetch_and_add(&p->num_done_, 1);
+    errno = e;
+#endif
+  }
+
+  std::size_t
+  stack_snapshot
+  ::capture(pid_t pid)
+  {
+#if defined(USE_BACKTRACE) && defined(HAVE_TGKILL)
+    // In a pid namespace, the test is not the process group leader, so
+    // look for the processes that have the handler installed.
+    const std::vector<pid_t> procs = process_group(pid);
+    for (std::size_t p = 0; p < procs.size(); ++p)
+      {
+        std::ostringstream os;
+        os << "/proc/" << procs[p];
+        const std::string dir = os.str();
+        if (!has_signal(dir + "/status", "SigCgt:", SIGURG)) continue;
+        const std::string task = dir + "/task";
+        const std::vector<std::string> tids = dir_entries(task.c_str());
+        for (std::size_t i = 0; i < tids.size(); ++i)
+          {
+            if (num_signalled_ == max_threads) break;
+            const std::string status = task + "/" + tids[i] + "/status";
+            if (has_signal(status, "SigBlk:", SIGURG)) continue;
+            const pid_t tid = pid_t(std::atoi(tids[i].c_str()));
+            if (wrapped::tgkill(procs[p], tid, SIGURG) != 0) continue;
+            ++num_signalled_;
+          }
+      }
+    if (num_signalled_ == 0) return 0;
+    const unsigned long deadline_us
+      = clocks::monotonic::timestamp_absolute() + timeout_us;
+    while (num_done_ < num_signalled_
+           && clocks::monotonic::timestamp_absolute() < deadline_us)
+      {
+        struct timeval tv = { 0, 1000 };
+        wrapped::select(0, 0, 0, 0, &tv);
+      }
+    __sync_synchronize();
+    std::size_t num = 0;
+    const int claimed = num_claimed_ < max_threads ? num_claimed_ : max_threads;
+    for (int i = 0; i < claimed; ++i)
+      {
+        if (stacks_[i].depth > handler_frames) ++num;
+      }
+    return num;
+#else
+    (void)pid;
+    return 0;
+#endif
+  }
+
+  void
+  stack_snapshot
+  ::write(std::ostream &os) const
+  {
+    const int claimed = num_claimed_ < max_threads ? num_claimed_ : max_threads;
+    for (int i = 0; i < claimed; ++i)
+      {
+        const stack &s = stacks_[i];
+        if (s.depth <= handler_frames) continue;
+        os << "thread " << s.tid << ":\n";
+        for (int j = handler_frames; j < s.depth; ++j)
+          {
+            // the rest is the harness
+            const std::string name = symbol_name(s.frames[j]);
+            if (is_test_wrapper(name)) break;
+            os << "  " << name << '\n';
+          }
+      }
+    if (num_done_ < num_signalled_)
+      {
+        os << num_signalled_ - num_done_ << " of " << num_signalled_
+           << " threads did not respond\n";
+      }
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef STACK_SNAPSHOT_HPP
+#define STACK_SNAPSHOT_HPP
+
+#include <crpcut.hpp>
+
+namespace crpcut {
+
+  // The stacks of the threads of a test process, taken just before the
+  // runner kills it, in memory shared between the runner and the test
+  // process of one slot. The runner signals the threads with SIGURG,
+  // and the handler in the test process writes the stack of the thread.
+  // Only processes in the process group of the test that handle SIGURG,
+  // and only their threads that do not block it, are signalled, so the
+  // runner does not wait for threads that will never answer.
+  class stack_snapshot
+  {
+  public:
+    static const unsigned long timeout_us = 200000;
+
+    static stack_snapshot *create(std::size_t num);
+    static void destroy(stack_snapshot *snapshots, std::size_t num);
+    void reset();
+
+    // Installs the signal handler in the test process.
+    void arm();
+
+    // Signals the threads of the processes in process group pid, and
+    // waits at most timeout_us for them. Returns at once if none has the
+    // handler installed. Returns the number of stacks written.
+    std::size_t capture(pid_t pid);
+
+    // Writes the stacks, innermost frame first. Frames of the harness
+    // below the test are left out.
+    void write(std::ostream &os) const;
+  private:
+    stack_snapshot();
+    stack_snapshot(const stack_snapshot&);
+    stack_snapshot& operator=(const stack_snapshot&);
+    static void on_signal(int);
+
+    static const int max_threads = 64;
+    static const int max_depth   = 64;
+    struct stack
+    {
+      pid_t        tid;
+      volatile int depth;
+      void        *frames[max_depth];
+    };
+
+    static stack_snapshot *current_;
+    int                    num_signalled_;
+    volatile int           num_claimed_;
+    volatile int           num_done_;
+    stack                  stacks_[max_threads];
+  };
+}
+
+#endif // STACK_SNAPSHOT_HPP
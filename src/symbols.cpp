@@ -0,0 +1,75 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "symbols.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#include <cstdlib>
+#include <sstream>
+#include <cxxabi.h>
+extern "C" {
+#  include <dlfcn.h>
+}
+
+namespace crpcut {
+
+  bool in_libcrpcut(void *addr)
+  {
+    Dl_info info;
+    return ::dladdr(addr, &info)
+      && info.dli_fname
+      && wrapped::strstr(info.dli_fname, "libcrpcut");
+  }
+
+  std::string symbol_name(void *addr)
+  {
+    std::ostringstream os;
+    Dl_info info;
+    if (!::dladdr(addr, &info) || !info.dli_fname)
+      {
+        os << addr;
+      }
+    else if (info.dli_sname)
+      {
+        int status;
+        char *demangled = abi::__cxa_demangle(info.dli_sname, 0, 0, &status);
+        os << (demangled ? demangled : info.dli_sname);
+        free(demangled);
+      }
+    else
+      {
+        const std::string file(info.dli_fname);
+        os << file.substr(file.rfind('/') + 1) << "+0x" << std::hex
+           << (static_cast<char*>(addr) - static_cast<char*>(info.dli_fbase));
+      }
+    return os.str();
+  }
+
+  bool is_test_wrapper(const std::string &name)
+  {
+    static const char prefix[] = "crpcut::test_wrapper<";
+    return name.compare(0, sizeof(prefix) - 1, prefix) == 0;
+  }
+}
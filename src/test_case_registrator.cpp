@@ -31,31 +31,53 @@
 #include "process_control.hpp"
 #include "clocks/clocks.hpp"
 #include "fsfuncs.hpp"
+#include "cgroup.hpp"
+#include "perf_counters.hpp"
+#include "output_capture.hpp"
+#include "output_cap.hpp"
+#include "timeline.hpp"
+#include "runner_stats.hpp"
+#include "stack_snapshot.hpp"
 extern "C" {
 #include <sys/time.h>
 }
 
 
 #include <cassert>
+#include <cstddef>
+#include <iomanip>
 #include <limits>
 
 namespace {
-  ::siginfo_t get_siginfo(pid_t pid, crpcut::process_control *process)
+  ::siginfo_t get_siginfo(pid_t                    pid,
+                          crpcut::process_control *process,
+                          struct rusage           &usage)
   {
     ::siginfo_t info;
     for (;;)
       {
         ::siginfo_t local;
-        int rv = process->waitid(P_PGID, id_t(pid), &local, WEXITED);
+        struct rusage local_usage;
+        int rv = process->waitid(P_PGID, id_t(pid), &local, WEXITED,
+                                 &local_usage);
         int n = errno;
         if (rv == -1 && n == EINTR) continue;
-        if (local.si_pid == pid) info = local;
+        if (rv == 0 && local.si_pid == pid)
+          {
+            info = local;
+            usage = local_usage;
+          }
         if (rv == 0) continue;
         break;
       }
     return info;
   }
 
+  unsigned long microseconds(const struct timeval &tv)
+  {
+    return (unsigned long)tv.tv_sec * 1000000UL + (unsigned long)tv.tv_usec;
+  }
+
   void set_location(std::ostream& os, crpcut::datatypes::fixed_string location)
   {
     assert(location.len);
@@ -86,6 +108,14 @@ namespace crpcut {
   ::set_phase(test_phase p)
   {
     phase_ = p;
+    if (p != child && runner_->timeline_)
+      {
+        runner_->timeline_->enter(dirnum_, p);
+      }
+    if (p == running && runner_->runner_stats_)
+      {
+        runner_->runner_stats_->enter_body(dirnum_);
+      }
   }
 
   bool
@@ -114,6 +144,11 @@ namespace crpcut {
   crpcut_test_case_registrator
   ::send_to_presentation(comm::type t, size_t len, const char *buff) const
   {
+    if (cap_ && !cap_->admit(t, len, buff)) return;
+    if (runner_->runner_stats_)
+      {
+        runner_->runner_stats_->message(dirnum_, len);
+      }
     runner_->present(get_pid(), t, get_phase(), len, buff);
   }
 
@@ -198,7 +233,13 @@ namespace crpcut {
       env_(0),
       reporter_(0),
       process_(0),
-      filesystem_(0)
+      filesystem_(0),
+      cgroup_(0),
+      counters_(0),
+      capture_(0),
+      cap_(0),
+      profile_(0),
+      stack_snapshot_(0)
   {
   }
 
@@ -228,7 +269,13 @@ namespace crpcut {
       env_(0),
       reporter_(reporter),
       process_(process),
-      filesystem_(filesystem)
+      filesystem_(filesystem),
+      cgroup_(0),
+      counters_(0),
+      capture_(0),
+      cap_(0),
+      profile_(0),
+      stack_snapshot_(0)
   {
     link_before(runner_->reg_);
   }
@@ -241,6 +288,54 @@ namespace crpcut {
     assert(pid_ == 0);
     pid_ = pid;
   }
+
+  void
+  crpcut_test_case_registrator
+  ::set_cgroup(cgroup *c)
+  {
+    assert(cgroup_ == 0);
+    cgroup_ = c;
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::set_perf_counters(perf_counters *c)
+  {
+    assert(counters_ == 0);
+    counters_ = c;
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::set_output_capture(output_capture *c)
+  {
+    assert(capture_ == 0);
+    capture_ = c;
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::set_output_cap(output_cap *c)
+  {
+    assert(cap_ == 0);
+    cap_ = c;
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::set_profile(profile *p)
+  {
+    assert(profile_ == 0);
+    profile_ = p;
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::set_stack_snapshot(stack_snapshot *s)
+  {
+    assert(stack_snapshot_ == 0);
+    stack_snapshot_ = s;
+  }
   void
   crpcut_test_case_registrator
   ::prepare_construction(unsigned long deadline_us)
@@ -341,8 +436,48 @@ namespace crpcut {
   ::kill()
   {
     assert(pid_);
-    process_->killpg(pid_, SIGKILL);
+    if (stack_snapshot_ && phase_ != child && !killed_)
+      {
+        report_stacks();
+      }
+    // killpg misses processes that have left the process group, while
+    // the cgroup holds everything the test has spawned
+    if (!cgroup_ || !cgroup_->kill())
+      {
+        process_->killpg(pid_, SIGKILL);
+      }
     killed_ = true;
+    if (runner_->timeline_)
+      {
+        runner_->timeline_->instant(dirnum_,
+                                    phase_ == child ? "killed" : "timeout");
+      }
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::suspected_deadlock(unsigned long      idle_ms,
+                       const std::string &threads,
+                       bool               kill_test)
+  {
+    std::ostringstream out;
+    set_location(out, get_location());
+    out << "Suspected deadlock: no CPU time used for " << idle_ms
+        << "ms with all threads blocked\n" << threads;
+    if (runner_->timeline_)
+      {
+        runner_->timeline_->instant(dirnum_, "suspected deadlock");
+      }
+    std::string s = out.str();
+    if (!kill_test)
+      {
+        send_to_presentation(comm::info, s.length(), s.c_str());
+        return;
+      }
+    crpcut_register_success(false);
+    send_to_presentation(comm::exit_fail, s.length(), s.c_str());
+    set_death_note();
+    kill();
   }
 
   void
@@ -462,14 +597,154 @@ namespace crpcut {
     return true;
   }
 
+  void
+  crpcut_test_case_registrator
+  ::report_cgroup_usage()
+  {
+    if (!cgroup_) return;
+    cgroup::usage usage;
+    cgroup_->read_usage(usage);
+    for (cgroup::usage::const_iterator i = usage.begin();
+         i != usage.end();
+         ++i)
+      {
+        std::ostringstream os;
+        set_location(os, datatypes::fixed_string::make(i->first,
+                                                     wrapped::strlen(i->first)));
+        os << i->second;
+        std::string s = os.str();
+        send_to_presentation(comm::metric, s.length(), s.c_str());
+      }
+    delete cgroup_;
+    cgroup_ = 0;
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::report_perf_counters()
+  {
+    if (!counters_) return;
+    perf_counters::usage usage;
+    counters_->read_usage(usage);
+    for (perf_counters::usage::const_iterator i = usage.begin();
+         i != usage.end();
+         ++i)
+      {
+        std::ostringstream os;
+        set_location(os, datatypes::fixed_string::make(i->first,
+                                                     wrapped::strlen(i->first)));
+        os << i->second;
+        std::string s = os.str();
+        send_to_presentation(comm::metric, s.length(), s.c_str());
+      }
+    delete counters_;
+    counters_ = 0;
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::report_stacks()
+  {
+    if (stack_snapshot_->capture(pid_) == 0) return;
+    std::ostringstream out;
+    set_location(out, get_location());
+    out << "Stacks when killed:\n";
+    stack_snapshot_->write(out);
+    std::string s = out.str();
+    send_to_presentation(comm::info, s.length(), s.c_str());
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::report_runner_stats(unsigned long death_us)
+  {
+    runner_stats *stats = runner_->runner_stats_;
+    if (!stats) return;
+    using datatypes::fixed_string;
+    std::ostringstream os[4];
+    set_location(os[0], fixed_string::make("runner.start_latency_us"));
+    os[0] << stats->start_latency_us(dirnum_);
+    set_location(os[1], fixed_string::make("runner.messages"));
+    os[1] << stats->messages(dirnum_);
+    set_location(os[2], fixed_string::make("runner.message_bytes"));
+    os[2] << stats->message_bytes(dirnum_);
+    set_location(os[3], fixed_string::make("runner.post_mortem_us"));
+    os[3] << clocks::monotonic::timestamp_absolute() - death_us;
+    for (std::size_t i = 0; i < 4; ++i)
+      {
+        std::string s = os[i].str();
+        send_to_presentation(comm::metric, s.length(), s.c_str());
+      }
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::report_rusage(const struct rusage &usage, unsigned long cputime_us)
+  {
+    using datatypes::fixed_string;
+    std::ostringstream os[8];
+    set_location(os[0], fixed_string::make("rusage.user_us"));
+    os[0] << microseconds(usage.ru_utime);
+    set_location(os[1], fixed_string::make("rusage.system_us"));
+    os[1] << microseconds(usage.ru_stime);
+    set_location(os[2], fixed_string::make("rusage.max_rss_kb"));
+    os[2] << usage.ru_maxrss;
+    set_location(os[3], fixed_string::make("rusage.minor_faults"));
+    os[3] << usage.ru_minflt;
+    set_location(os[4], fixed_string::make("rusage.major_faults"));
+    os[4] << usage.ru_majflt;
+    set_location(os[5], fixed_string::make("rusage.voluntary_switches"));
+    os[5] << usage.ru_nvcsw;
+    set_location(os[6], fixed_string::make("rusage.involuntary_switches"));
+    os[6] << usage.ru_nivcsw;
+    std::size_t num = 7;
+    if (unsigned long wall_us = duration_us())
+      {
+        set_location(os[7], fixed_string::make("rusage.cpu_wall_ratio"));
+        os[7] << std::fixed << std::setprecision(3)
+              << double(cputime_us) / double(wall_us);
+        ++num;
+      }
+    for (std::size_t i = 0; i < num; ++i)
+      {
+        std::string s = os[i].str();
+        send_to_presentation(comm::metric, s.length(), s.c_str());
+      }
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::present_captured_output()
+  {
+    if (!capture_) return;
+    capture_->present(*this);
+    delete capture_;
+    capture_ = 0;
+  }
+
+  void
+  crpcut_test_case_registrator
+  ::present_truncated_output()
+  {
+    if (!cap_) return;
+    // what is kept is presented as is
+    output_cap *cap = cap_;
+    cap_ = 0;
+    cap->present(*this);
+    delete cap;
+  }
+
   void
   crpcut_test_case_registrator
   ::manage_death()
   {
-    ::siginfo_t info = get_siginfo(pid_, process_);
+    const unsigned long death_us = clocks::monotonic::timestamp_absolute();
+    struct rusage usage = rusage();
+    ::siginfo_t info = get_siginfo(pid_, process_, usage);
 
-    unsigned long cputime_us = runner_->calc_cputime(cpu_time_at_start_);
-    if (!killed_ && deadline_is_set())
+    unsigned long cputime_us = runner_->calc_cputime(cpu_time_at_start_, usage);
+    if (runner_->timeline_) runner_->timeline_->enter(dirnum_, post_mortem);
+    if (deadline_is_set())
       {
         clear_deadline();
       }
@@ -527,18 +802,38 @@ namespace crpcut {
           }
         t = comm::exit_fail;
       }
+    present_captured_output();
+    present_truncated_output();
+    report_cgroup_usage();
+    report_perf_counters();
+    report_rusage(usage, cputime_us);
     std::string s = out.str();
     send_to_presentation(t, s.length(), s.c_str());
     crpcut_register_success(t == comm::exit_ok);
+    if (profile_)
+      {
+        runner_->save_profile(this, *profile_);
+        profile_ = 0;
+      }
+    stack_snapshot_ = 0;
+    if (runner_->timeline_)
+      {
+        runner_->timeline_->end_test(dirnum_, pid_, !crpcut_failed());
+      }
+    report_runner_stats(death_us);
     runner_->return_dir(dirnum_);
-    struct {
+    struct end_data {
       unsigned long critical;
       unsigned long duration_us;
+      unsigned long sent_us; // only with runner stats, for presenter lag
     } end_msg;
     end_msg.critical = crpcut_tag().get_importance() == tag::critical;
     end_msg.duration_us = duration_us();
-    send_to_presentation(comm::end_test,
-                         sizeof(end_msg), (const char*)&end_msg);
+    end_msg.sent_us = clocks::monotonic::timestamp_absolute();
+    const std::size_t len = runner_->runner_stats_
+      ? sizeof(end_msg)
+      : offsetof(end_data, sent_us);
+    send_to_presentation(comm::end_test, len, (const char*)&end_msg);
     assert(crpcut_succeeded() || crpcut_failed());
   }
 
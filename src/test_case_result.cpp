@@ -24,17 +24,19 @@
  * SUCH DAMAGE.
  */
 
-#include "wrapped/posix_encapsulation.hpp"
 #include "test_case_result.hpp"
+#include <new>
 
 namespace crpcut {
 
   test_case_result
   ::test_case_result(pid_t pid)
-    :id(pid),
+    :arena(),
+     id(pid),
      explicit_fail(false),
      success(false),
      nonempty_dir(false),
+     phase(running),
      test(0),
      termination(datatypes::fixed_string::make("")),
      location(datatypes::fixed_string::make(""))
@@ -44,10 +46,22 @@ namespace crpcut {
   test_case_result
   ::~test_case_result()
   {
-    if (termination) wrapped::free(termination.str);
     while (event *e = history.first())
       {
-        delete e;
+        e->~event();
       }
+    while (event *e = metrics.first())
+      {
+        e->~event();
+      }
+  }
+
+  event *
+  test_case_result
+  ::make_event(comm::type              t,
+               datatypes::fixed_string msg,
+               datatypes::fixed_string event_location)
+  {
+    return new (arena.allocate(sizeof(event))) event(t, msg, event_location);
   }
 }
@@ -28,22 +28,31 @@
 #define TEST_CASE_RESULT_HPP
 
 #include "event.hpp"
+#include "result_arena.hpp"
 namespace crpcut {
 
   class crpcut_test_case_registrator;
-  struct test_case_result : public datatypes::list_elem<test_case_result>
+  // Everything presented from a test is kept in its arena, including the
+  // events, until the test ends.
+  struct test_case_result
   {
     test_case_result(pid_t pid);
     ~test_case_result();
+    event *make_event(comm::type              t,
+                      datatypes::fixed_string msg,
+                      datatypes::fixed_string event_location);
+    result_arena                  arena;
     pid_t                         id;
     bool                          explicit_fail;
     bool                          success;
     bool                          nonempty_dir;
+    test_phase                    phase;
 
     crpcut_test_case_registrator *test;
     datatypes::fixed_string       termination;
     datatypes::fixed_string       location;
     datatypes::list_elem<event>   history;
+    datatypes::list_elem<event>   metrics;
   private:
     test_case_result(const test_case_result& r);
     test_case_result& operator=(const test_case_result&r);
@@ -31,8 +31,9 @@
 #include "poll_buffer_vector.hpp"
 #include "fsfuncs.hpp"
 #include "pipe_pair.hpp"
-#include "output/heap_buffer.hpp"
+#include "output/pooled_buffer.hpp"
 #include <algorithm>
+#include <fstream>
 #include "presentation.hpp"
 #include "output/xml_formatter.hpp"
 #include "output/text_formatter.hpp"
@@ -42,6 +43,26 @@
 #include "working_dir_allocator.hpp"
 #include "deadline_monitor.hpp"
 #include "heap.hpp"
+#include "program_watcher.hpp"
+#include "request_server.hpp"
+#include "journal.hpp"
+#include "namespace_isolation.hpp"
+#include "cgroup.hpp"
+#include "report_ring.hpp"
+#include "packet_writer.hpp"
+#include "output_capture.hpp"
+#include "output_cap.hpp"
+#include "inline_presentation.hpp"
+#include "comm/failure_filter.hpp"
+#include "clocks/clocks.hpp"
+#include "perf_counters.hpp"
+#include "profile.hpp"
+#include "stack_snapshot.hpp"
+#include "timeline.hpp"
+#include "event_stream.hpp"
+#include "run_statistics.hpp"
+#include "runner_stats.hpp"
+#include "hang_watch.hpp"
 
 extern "C" {
 #  include <sys/time.h>
@@ -104,6 +125,46 @@ namespace {
     return fd;
   }
 
+  // A target of digits only is a file descriptor the test program was
+  // started with, e.g. --events=3 with 3>&1 in the shell.
+  int open_events_target(const char *target, std::ostream &err_os)
+  {
+    const char *p = target;
+    while (*p >= '0' && *p <= '9') ++p;
+    if (p == target || *p) return open_report_file(target, err_os);
+    int fd = 0;
+    for (p = target; *p; ++p) fd = fd*10 + (*p - '0');
+    if (crpcut::wrapped::fcntl(fd, F_GETFL, 0) < 0)
+      {
+        err_os << "File descriptor " << target << " is not open\n";
+        throw cli_exception();
+      }
+    return fd;
+  }
+
+  // A journal resumed from is continued in place if it is the one this run
+  // is to keep, after cutting off any record torn by the interruption.
+  int open_journal_file(const std::string &name,
+                        const char        *resumed,
+                        long               resumed_len,
+                        bool              &continued,
+                        std::ostream      &err_os)
+  {
+    continued = resumed && name == resumed;
+    int flags = continued ? O_WRONLY | O_APPEND : O_CREAT | O_WRONLY | O_TRUNC;
+    int fd = crpcut::wrapped::open(name.c_str(), flags, 0666);
+    if (fd >= 0 && continued && crpcut::wrapped::ftruncate(fd, resumed_len))
+      {
+        crpcut::wrapped::close(fd);
+        fd = -1;
+      }
+    if (fd < 0)
+      {
+        err_os << "Failed to open " << name << " for writing\n";
+        throw cli_exception();
+      }
+    return fd;
+  }
 }
 
 namespace crpcut {
@@ -112,9 +173,20 @@ namespace crpcut {
     : env_(0),
       cli_(0),
       num_pending_children_(0),
+      stalled_slot_us_(0),
       presenter_pipe_(-1),
       deadlines_(0),
-      working_dirs_(0)
+      working_dirs_(0),
+      cgroups_(0),
+      profiles_(0),
+      profile_dir_(),
+      profile_failed_only_(false),
+      snapshots_(0),
+      timeline_(0),
+      trace_fd_(-1),
+      runner_stats_(0),
+      hang_watch_(0),
+      inline_(0)
   {
     lib::strcpy(dirbase_, "/tmp/crpcutXXXXXX");
   }
@@ -134,11 +206,33 @@ namespace crpcut {
       {
         int timeout_ms = deadlines_->ms_until_deadline();
 
+        presenter_pipe_.flush();
+        if (inline_ && !inline_->write_output())
+          {
+            // output blocked, try again soon
+            const int retry_ms = 10;
+            if (timeout_ms < 0 || timeout_ms > retry_ms) timeout_ms = retry_ms;
+          }
+        if (hang_watch_)
+          {
+            const int check_ms = hang_watch_->ms_until_check();
+            if (check_ms >= 0 && (timeout_ms < 0 || timeout_ms > check_ms))
+              {
+                timeout_ms = check_ms;
+              }
+          }
+
         poll<fdreader>::descriptor desc = poller.wait(timeout_ms);
+        if (hang_watch_) hang_watch_->check();
 
         if (desc.timeout())
           {
+            // the wait may have been cut short to retry the output, or
+            // to check for hung tests
+            if (deadlines_->ms_until_deadline() != 0) continue;
             timeboxed *t = deadlines_->remove_first();
+            // the test may still cancel its deadline before it dies
+            t->clear_deadline();
             t->kill();
             continue;
           }
@@ -165,11 +259,51 @@ namespace crpcut {
   test_runner
   ::start_test(crpcut_test_case_registrator *i, poll<fdreader>& poller)
   {
-    pipe_pair c2p("communication pipe test-case to main process");
+    pipe_pair c2p("communication pipe test-case to main process",
+                  pipe_pair::packets);
+    const bool packets = c2p.get_kind() == pipe_pair::packets;
     pipe_pair stderr("communication pipe for test-case stderr");
     pipe_pair stdout("communication pipe for test-case stdout");
 
-    i->set_wd(working_dirs_->allocate());
+    const unsigned slot = working_dirs_->allocate();
+    i->set_wd(slot);
+    report_ring *ring = report_ring::create();
+    if (timeline_) timeline_->begin_test(slot, *i);
+    if (runner_stats_) runner_stats_->begin_test(slot);
+    profile *prof = profiles_ ? profiles_ + slot : 0;
+    if (prof)
+      {
+        prof->reset();
+        i->set_profile(prof);
+      }
+    stack_snapshot *snapshot = snapshots_ ? snapshots_ + slot : 0;
+    if (snapshot)
+      {
+        snapshot->reset();
+        i->set_stack_snapshot(snapshot);
+      }
+    cgroup *leaf = cgroups_->create_leaf();
+    bool memory_unlimited = i->crpcut_memory_max() != 0;
+    bool cpu_unlimited = i->crpcut_cpu_quota_us() != 0;
+    if (leaf)
+      {
+        memory_unlimited = !leaf->limit_memory(i->crpcut_memory_max());
+        cpu_unlimited = !leaf->limit_cpu(i->crpcut_cpu_quota_us(),
+                                         i->crpcut_cpu_period_us());
+        i->set_cgroup(leaf);
+      }
+    if (unsigned limit = cli_->output_limit())
+      {
+        std::ostringstream name;
+        name << *i;
+        i->set_output_cap(new output_cap(limit, name.str()));
+      }
+    output_capture *capture = 0;
+    if (cli_->capture_output())
+      {
+        capture = new output_capture;
+        i->set_output_capture(capture);
+      }
     pid_t pid;
     do { pid = wrapped::fork(); } while (pid == -1 && errno == EINTR);
 
@@ -177,20 +311,53 @@ namespace crpcut {
 
     if (pid == 0) // child
       {
+        if (leaf) leaf->enter();
         wrapped::setpgid(0, 0);
         heap::control::enable();
         try {
           typedef comm::wfile_descriptor wfd;
-          wfd report_fd(c2p.for_writing(pipe_pair::release_ownership));
-          comm::report.set_writer(&report_fd);
+          int report_fd = c2p.for_writing(pipe_pair::release_ownership);
+          wfd report_pipe(packets ? -1 : report_fd);
+          packet_writer report_packets(packets ? report_fd : -1);
+          comm::data_writer &report_out
+            = packets
+            ? static_cast<comm::data_writer&>(report_packets)
+            : report_pipe;
+          report_ring_writer ring_writer(report_out, ring);
+          if (ring)
+            {
+              comm::report.set_writer(&ring_writer);
+            }
+          else
+            {
+              comm::report.set_writer(&report_out);
+            }
+          comm::failure_filter failures(cli_->failure_limit());
+          comm::report.set_failure_filter(&failures);
           crpcut_test_monitor::make_current(i);
-          wrapped::dup2(stdout.for_writing(), 1);
-          wrapped::dup2(stderr.for_writing(), 2);
+          if (capture)
+            {
+              wrapped::dup2(capture->fd(comm::stdout), 1);
+              wrapped::dup2(capture->fd(comm::stderr), 2);
+            }
+          else
+            {
+              wrapped::dup2(stdout.for_writing(), 1);
+              wrapped::dup2(stderr.for_writing(), 2);
+            }
           stdout.close();
           stderr.close();
           c2p.close();
+          report_unapplied_limits(memory_unlimited, cpu_unlimited,
+                                  i->get_location());
+          if (unsigned ns = i->crpcut_isolated_namespaces())
+            {
+              enter_namespaces(ns, i->get_location());
+            }
           i->set_pid(wrapped::getpid());
           i->goto_wd();
+          if (prof) prof->start();
+          if (snapshot) snapshot->arm();
           i->run_test_case();
         }
         catch (...)
@@ -203,10 +370,19 @@ namespace crpcut {
     // parent
     ++num_pending_children_;
     i->set_pid(pid);
+    if (timeline_) timeline_->enter(slot, creating);
+    if (hang_watch_) hang_watch_->begin_test(slot, i, pid);
+    if (cli_->perf_counters())
+      {
+        // counting starts here, while the child sets itself up
+        i->set_perf_counters(new perf_counters(pid));
+      }
     i->setup(poller,
              c2p.for_reading(pipe_pair::release_ownership),
-             stdout.for_reading(pipe_pair::release_ownership),
-             stderr.for_reading(pipe_pair::release_ownership));
+             capture ? -1 : stdout.for_reading(pipe_pair::release_ownership),
+             capture ? -1 : stderr.for_reading(pipe_pair::release_ownership),
+             ring,
+             packets);
     introduce_test(pid, i);
   }
 
@@ -214,15 +390,18 @@ namespace crpcut {
   test_runner
   ::introduce_test(pid_t pid, const crpcut_test_case_registrator *reg)
   {
+    // With the test goes the slot time that was held up by dependencies
+    // since the last test started.
+    struct
+    {
+      const crpcut_test_case_registrator *test;
+      unsigned long                       stalled_slot_us;
+    } data = { reg, stalled_slot_us_ };
+    stalled_slot_us_ = 0;
     const comm::type t   = comm::begin_test;
     const test_phase p   = running;
-    const size_t     len = sizeof(reg);
-    presenter_pipe_
-      .write_loop(&pid)
-      .write_loop(&t)
-      .write_loop(&p)
-      .write_loop(&len)
-      .write_loop(&reg, len);
+    const size_t     len = sizeof(data);
+    presenter_pipe_.write_frame(pid, t, p, len, &data);
   }
 
   int
@@ -277,6 +456,8 @@ namespace crpcut {
   test_runner
   ::return_dir(unsigned num)
   {
+    if (runner_stats_) runner_stats_->end_test(num);
+    if (hang_watch_) hang_watch_->end_test(num);
     working_dirs_->free(num);
   }
 
@@ -290,15 +471,7 @@ namespace crpcut {
             size_t      len,
             const char *buff)
   {
-    presenter_pipe_
-      .write_loop(&pid)
-      .write_loop(&t)
-      .write_loop(&phase)
-      .write_loop(&len);
-    if (len)
-      {
-        presenter_pipe_.write_loop(buff, len);
-      }
+    presenter_pipe_.write_frame(pid, t, phase, len, buff);
   }
 
   void setup_dirbase(const char   *program_name,
@@ -325,7 +498,7 @@ namespace crpcut {
   void cleanup_directories(std::size_t        num_parallel,
                            const char        *working_dir,
                            const char        *dirbase,
-                           comm::data_writer &presenter_pipe)
+                           presentation_pipe &presenter_pipe)
   {
     for (unsigned n = 0; n < num_parallel; ++n)
       {
@@ -338,16 +511,8 @@ namespace crpcut {
 
     if (!is_dir_empty("."))
       {
-        static const pid_t dummy = 0;
-        static const comm::type nonempty_dir = comm::dir;
-        static const test_phase phase = post_mortem;
-        static const size_t len = wrapped::strlen(dirbase) + 1;
-        presenter_pipe
-          .write_loop(&dummy)
-          .write_loop(&nonempty_dir)
-          .write_loop(&phase)
-          .write_loop(&len)
-          .write_loop(dirbase, len);
+        const size_t len = wrapped::strlen(dirbase) + 1;
+        presenter_pipe.write_frame(0, comm::dir, post_mortem, len, dirbase);
       }
     else if (working_dir == 0)
       {
@@ -363,19 +528,24 @@ namespace crpcut {
   void test_runner
   ::schedule_tests(std::size_t num_parallel, poll<fdreader> &poller)
   {
+    typedef crpcut_test_case_registrator reg;
     for (;;)
       {
         bool progress = false;
-        typedef crpcut_test_case_registrator reg;
+        bool waiting = false;
         for (reg *i = reg_.first(); i;)
           {
             reg *reg_obj = i;
             i = reg_.next_after(i);
-            if (   (cli_->honour_dependencies() && !reg_obj->crpcut_can_run())
-                || reg_obj->get_importance() == crpcut::tag::disabled)
+            if (reg_obj->get_importance() == crpcut::tag::disabled)
               {
                 continue;
               }
+            if (cli_->honour_dependencies() && !reg_obj->crpcut_can_run())
+              {
+                waiting = true;
+                continue;
+              }
             progress = true;
             reg_obj->set_test_environment(env_);
             start_test(reg_obj, poller);
@@ -385,28 +555,36 @@ namespace crpcut {
         if (!progress)
           {
             if (num_pending_children_ == 0) break;
+            if (!waiting)
+              {
+                manage_children(1, poller);
+                continue;
+              }
+            // The free slots are held up by dependencies until a test
+            // ends.
+            if (timeline_) timeline_->stall(num_pending_children_);
+            const unsigned long idle = num_parallel - num_pending_children_;
+            const unsigned long begin_us
+              = clocks::monotonic::timestamp_absolute();
             manage_children(1, poller);
+            stalled_slot_us_ += idle*(clocks::monotonic::timestamp_absolute()
+                                      - begin_us);
           }
       }
     if (num_pending_children_) manage_children(1, poller);
-  }
-
-  int
-  test_runner::spawn_test_runner()
-  {
-    pipe_pair p("communication pipe for presenter process");
-
-    pid_t pid = wrapped::fork();
-    if (pid < 0)
+    if (!timeline_) return;
+    for (reg *i = reg_.first(); i; i = reg_.next_after(i))
       {
-        throw posix_error(errno, "forking presenter process");
-      }
-    if (pid != 0)
-      {
-        return p.for_reading(pipe_pair::release_ownership);
+        if (i->get_importance() != crpcut::tag::disabled)
+          {
+            timeline_->blocked(*i);
+          }
       }
-    comm::wfile_descriptor(p.for_writing()).swap(presenter_pipe_);
+  }
 
+  void
+  test_runner::run_tests()
+  {
     const std::size_t num_parallel = cli_->num_parallel_tests();
     typedef poll_buffer_vector<fdreader> poll_reader;
     void *poll_memory = alloca(poll_reader::space_for(num_parallel*3U));
@@ -420,12 +598,57 @@ namespace crpcut {
     working_dir_allocator dir_allocator(wd_space, num_parallel);
     working_dirs_ = &dir_allocator;
 
-    schedule_tests(num_parallel, poller);
+    void *stats_space = alloca(runner_stats::space_for(num_parallel));
+    runner_stats costs(stats_space, num_parallel);
+    runner_stats_ = cli_->runner_stats() ? &costs : 0;
+
+    void *watch_space = alloca(hang_watch::space_for(num_parallel));
+    hang_watch watch(watch_space, num_parallel,
+                     cli_->hang_watch_ms(), cli_->hang_kill());
+    hang_watch_ = cli_->hang_watch_ms() ? &watch : 0;
+
+    profiles_ = profile_dir_.empty() ? 0 : profile::create(num_parallel);
+#ifdef USE_BACKTRACE
+    snapshots_ = cli_->timeout_stacks()
+      ? stack_snapshot::create(num_parallel)
+      : 0;
+#endif
+    {
+      cgroup_tree cgroups;
+      cgroups_ = &cgroups;
+      timeline trace(trace_fd_, num_parallel);
+      timeline_ = &trace;
+      schedule_tests(num_parallel, poller);
+      timeline_ = 0;
+    }
+    runner_stats_ = 0;
+    hang_watch_ = 0;
+    profile::destroy(profiles_, num_parallel);
+    stack_snapshot::destroy(snapshots_, num_parallel);
 
     cleanup_directories(num_parallel,
                         cli_->working_dir(),
                         dirbase_,
                         presenter_pipe_);
+    presenter_pipe_.flush();
+  }
+
+  int
+  test_runner::spawn_test_runner()
+  {
+    pipe_pair p("communication pipe for presenter process");
+
+    pid_t pid = wrapped::fork();
+    if (pid < 0)
+      {
+        throw posix_error(errno, "forking presenter process");
+      }
+    if (pid != 0)
+      {
+        return p.for_reading(pipe_pair::release_ownership);
+      }
+    comm::wfile_descriptor(p.for_writing()).swap(presenter_pipe_);
+    run_tests();
     wrapped::exit(0);
     return 0;
   }
@@ -447,6 +670,26 @@ namespace crpcut {
             tags.print_to(std::cout);
             throw cli_exception(0);
           }
+        if (cli_->serve_path())
+          {
+            const char *const *request_argv
+              = serve_requests(cli_->program_name(),
+                               cli_->serve_path(),
+                               err_os);
+            cli::interpreter request(request_argv);
+            if (request.serve_path())
+              {
+                err_os << "A run request cannot start another server\n";
+                throw cli_exception(-1);
+              }
+            return do_run(&request, err_os, tags);
+          }
+#ifdef HAVE_INOTIFY
+        if (cli_->watch_mode())
+          {
+            rerun_on_change(cli_->argv(), err_os);
+          }
+#endif
         tags.configure_importance(cli_->tag_specification());
         std::pair<unsigned, unsigned> rv =
             reg_.filter_out_or_throw(test_names, err_os, cli_exception(-1));
@@ -462,11 +705,38 @@ namespace crpcut {
           {
             lib::strcpy(dirbase_, cli_->working_dir());
           }
+        journal::entry_list completed;
+        long resumed_len = 0;
+        if (const char *resumed = cli_->resume_journal())
+          {
+            resumed_len = journal::load(resumed, completed);
+            if (resumed_len < 0)
+              {
+                err_os << "Failed to read journal " << resumed << '\n';
+                throw cli_exception(-1);
+              }
+            journal::skip_completed(reg_, completed);
+          }
 #ifdef USE_BACKTRACE
         if (cli_->backtrace_enabled())
           {
             heap::enable_backtrace();
           }
+        if (const char *dir = cli_->profile_dir())
+          {
+            profile_dir_ = dir;
+            if (dir[0] != '/')
+              {
+                profile_dir_ = std::string(env_->get_start_dir()) + '/' + dir;
+              }
+            if (wrapped::mkdir(profile_dir_.c_str(), 0777) != 0
+                && errno != EEXIST)
+              {
+                err_os << "Failed to create profile directory " << dir << '\n';
+                throw cli_exception(-1);
+              }
+            profile_failed_only_ = cli_->profile_failed_only();
+          }
 #endif
         if (cli_->single_shot_mode())
           {
@@ -489,12 +759,35 @@ namespace crpcut {
 
         int output_fd = open_report_file(cli_->report_file(), err_os);
 
+        bool continued = false;
+        int journal_fd = -1;
+        if (cli_->checkpoint_interval())
+          {
+            journal_fd = open_journal_file(std::string(cli_->report_file())
+                                           + ".journal",
+                                           cli_->resume_journal(),
+                                           resumed_len,
+                                           continued,
+                                           err_os);
+          }
+        journal log(journal_fd, cli_->checkpoint_interval(), continued);
+        if (cli_->trace_file())
+          {
+            trace_fd_ = open_report_file(cli_->trace_file(), err_os);
+          }
+        int events_fd = -1;
+        if (const char *target = cli_->events_target())
+          {
+            events_fd = open_events_target(target, err_os);
+          }
+        event_stream events(events_fd);
+
         using output::formatter;
         typedef output::text_formatter tf;
         typedef output::xml_formatter  xf;
         typedef output::nil_formatter  nf;
 
-        output::heap_buffer buffer;
+        output::pooled_buffer buffer;
         formatter &fmt =
           select_output_formatter<xf, tf>(buffer,
                                           cli_->xml_output(),
@@ -503,7 +796,7 @@ namespace crpcut {
                                           tags,
                                           num_registered_tests,
                                           num_selected_tests);
-        output::heap_buffer summary_buffer;
+        output::pooled_buffer summary_buffer;
         formatter &summary_fmt =
           select_output_formatter<nf, tf>(summary_buffer,
                                           cli_->quiet() || output_fd == 1,
@@ -517,6 +810,30 @@ namespace crpcut {
                       cli_->working_dir(),
                       dirbase_,
                       err_os);
+        run_statistics stats(cli_->num_parallel_tests(),
+                             cli_->runner_stats());
+        if (cli_->inline_presenter())
+          {
+            inline_presentation presentation(buffer,
+                                             fmt,
+                                             output_fd,
+                                             summary_buffer,
+                                             summary_fmt,
+                                             output_fd == 1 ? -1 : 1,
+                                             cli_->verbose_mode(),
+                                             dirbase_,
+                                             reg_,
+                                             journal_fd < 0 ? 0 : &log,
+                                             completed,
+                                             &stats,
+                                             events_fd < 0 ? 0 : &events);
+            presenter_pipe_.deliver_to(&presentation.reader());
+            inline_ = &presentation;
+            run_tests();
+            presenter_pipe_.deliver_to(0);
+            inline_ = 0;
+            return int(presentation.finish());
+          }
         int runner_fd = spawn_test_runner();
         unsigned num_failed = show_test_results(runner_fd,
                                                 output_fd,
@@ -526,7 +843,11 @@ namespace crpcut {
                                                 summary_fmt,
                                                 cli_->verbose_mode(),
                                                 dirbase_,
-                                                reg_);
+                                                reg_,
+                                                journal_fd < 0 ? 0 : &log,
+                                                completed,
+                                                &stats,
+                                                events_fd < 0 ? 0 : &events);
         siginfo_t info;
         wrapped::waitid(P_ALL, WEXITED, &info, 0);
         return int(num_failed);
@@ -546,18 +867,25 @@ namespace crpcut {
     return -1;
   }
 
+  void
+  test_runner::save_profile(crpcut_test_case_registrator *i,
+                            const profile                &p)
+  {
+    if (profile_failed_only_ && !i->crpcut_failed()) return;
+    std::ostringstream name;
+    name << profile_dir_ << '/' << *i << ".folded";
+    std::ofstream os(name.str().c_str());
+    p.write_folded(os);
+  }
+
   unsigned long
-  test_runner::calc_cputime(const struct timeval& t)
+  test_runner::calc_cputime(const struct timeval &start,
+                            const struct rusage  &usage)
   {
-    struct rusage usage;
-    int rv = wrapped::getrusage(RUSAGE_CHILDREN, &usage);
-    assert(rv == 0);
-    struct timeval prev = accumulated_cputime_;
-    timeradd(&usage.ru_utime, &usage.ru_stime, &accumulated_cputime_);
     struct timeval child_time;
-    timersub(&accumulated_cputime_, &prev, &child_time);
+    timeradd(&usage.ru_utime, &usage.ru_stime, &child_time);
     struct timeval child_test_time;
-    timersub(&child_time, &t, &child_test_time);
+    timersub(&child_time, &start, &child_test_time);
     return (unsigned long)(((child_test_time.tv_sec))) * 1000000UL
            + (unsigned long)(((child_test_time.tv_usec)));
   }
@@ -28,15 +28,23 @@
 #define TEST_RUNNER_HPP_
 
 #include <crpcut.hpp>
+#include "presentation_pipe.hpp"
 #include "registrator_list.hpp"
 #include "test_environment.hpp"
 
 namespace crpcut {
 
   class working_dir_allocator;
+  class cgroup_tree;
+  class profile;
+  class stack_snapshot;
+  class timeline;
+  class runner_stats;
+  class hang_watch;
   class deadline_monitor;
   class test_case_registrator;
   class test_environment;
+  class inline_presentation;
 
   class test_runner
   {
@@ -59,8 +67,12 @@ namespace crpcut {
     virtual void set_deadline(crpcut_test_case_registrator *i);
     virtual void clear_deadline(crpcut_test_case_registrator *i);
     virtual void return_dir(unsigned num);
-    virtual unsigned long calc_cputime(const struct timeval&);
+    virtual unsigned long calc_cputime(const struct timeval &start,
+                                       const struct rusage  &usage);
+    virtual void save_profile(crpcut_test_case_registrator *i,
+                              const profile                &p);
     void schedule_tests(std::size_t num_parallel, poll<fdreader> &poller);
+    void run_tests();
     int  spawn_test_runner();
     void manage_children(std::size_t max_pending_children, poll<fdreader> &poller);
     void start_test(crpcut_test_case_registrator *i, poll<fdreader> &poller);
@@ -70,12 +82,22 @@ namespace crpcut {
 
     test_environment        *env_;
     cli::interpreter        *cli_;
-    struct timeval           accumulated_cputime_;
     registrator_list         reg_;
     unsigned                 num_pending_children_;
-    comm::wfile_descriptor   presenter_pipe_;
+    unsigned long            stalled_slot_us_; // since the last start
+    presentation_pipe        presenter_pipe_;
     deadline_monitor        *deadlines_;
     working_dir_allocator   *working_dirs_;
+    cgroup_tree             *cgroups_;
+    profile                 *profiles_;
+    std::string              profile_dir_;
+    bool                     profile_failed_only_;
+    stack_snapshot          *snapshots_;
+    timeline                *timeline_;
+    int                      trace_fd_;
+    runner_stats            *runner_stats_;
+    hang_watch              *hang_watch_;
+    inline_presentation     *inline_;
     char                     dirbase_[PATH_MAX];
   };
 
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "timeline.hpp"
+#include "clocks/clocks.hpp"
+#include "wrapped/posix_encapsulation.hpp"
+#include <string>
+#include <sstream>
+
+namespace {
+#define QSTR(s) "\"" #s "\""
+  static const char *phase_name[] = { CRPCUT_TEST_PHASES(QSTR) };
+#undef QSTR
+
+  // Test names are identifiers, but the names of parametrised tests
+  // need not be.
+  std::string quoted(const std::string &s)
+  {
+    std::string rv("\"");
+    for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+      {
+        if (*i == '"' || *i == '\\') rv += '\\';
+        rv += *i;
+      }
+    return rv + '"';
+  }
+}
+
+namespace crpcut {
+
+  timeline
+  ::timeline(int fd, std::size_t num_slots)
+    : fd_(fd),
+      start_us_(clocks::monotonic::timestamp_absolute()),
+      pid_(wrapped::getpid()),
+      first_(true)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    os << "{\"traceEvents\":[\n";
+    header(os, 'M', 0)
+      << ",\"name\":\"process_name\",\"args\":{\"name\":\"crpcut\"}}";
+    for (unsigned slot = 0; slot < num_slots; ++slot)
+      {
+        header(os, 'M', slot)
+          << ",\"name\":\"thread_name\",\"args\":{\"name\":\"slot "
+          << slot << "\"}}";
+      }
+    write(os.str());
+  }
+
+  timeline
+  ::~timeline()
+  {
+    if (fd_ < 0) return;
+    write("\n]}\n");
+    wrapped::close(fd_);
+  }
+
+  std::ostream &
+  timeline
+  ::header(std::ostream &os, char ph, unsigned slot)
+  {
+    if (!first_) os << ",\n";
+    first_ = false;
+    return os << "{\"ph\":\"" << ph << "\",\"pid\":" << pid_
+              << ",\"tid\":" << slot
+              << ",\"ts\":"
+              << clocks::monotonic::timestamp_absolute() - start_us_;
+  }
+
+  void
+  timeline
+  ::write(const std::string &s) const
+  {
+    const char *p = s.data();
+    std::size_t len = s.length();
+    while (len)
+      {
+        ssize_t rv = wrapped::write(fd_, p, len);
+        if (rv < 0 && errno == EINTR) continue;
+        if (rv <= 0) return;
+        p += rv;
+        len -= std::size_t(rv);
+      }
+  }
+
+  void
+  timeline
+  ::begin_test(unsigned slot, const crpcut_test_case_registrator &t)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream name;
+    name << t;
+    std::ostringstream os;
+    header(os, 'B', slot) << ",\"cat\":\"test\",\"name\":"
+                          << quoted(name.str()) << '}';
+    header(os, 'B', slot) << ",\"cat\":\"phase\",\"name\":\"fork\"}";
+    write(os.str());
+  }
+
+  void
+  timeline
+  ::enter(unsigned slot, test_phase phase)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    header(os, 'E', slot) << '}';
+    header(os, 'B', slot) << ",\"cat\":\"phase\",\"name\":"
+                          << phase_name[phase] << '}';
+    write(os.str());
+  }
+
+  void
+  timeline
+  ::end_test(unsigned slot, pid_t pid, bool pass)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    header(os, 'E', slot) << '}';
+    header(os, 'E', slot) << ",\"args\":{\"pid\":" << pid
+                          << ",\"result\":\"" << (pass ? "PASSED" : "FAILED")
+                          << "\"}}";
+    write(os.str());
+  }
+
+  void
+  timeline
+  ::instant(unsigned slot, const char *name)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    header(os, 'i', slot) << ",\"s\":\"t\",\"name\":\"" << name << "\"}";
+    write(os.str());
+  }
+
+  void
+  timeline
+  ::stall(std::size_t num_running)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream os;
+    header(os, 'i', 0) << ",\"s\":\"g\",\"name\":\"dependency stall\""
+                       << ",\"args\":{\"running\":" << num_running << "}}";
+    write(os.str());
+  }
+
+  void
+  timeline
+  ::blocked(const crpcut_test_case_registrator &t)
+  {
+    if (fd_ < 0) return;
+    std::ostringstream name;
+    name << t;
+    std::ostringstream os;
+    header(os, 'i', 0) << ",\"s\":\"g\",\"name\":\"blocked\""
+                       << ",\"args\":{\"test\":" << quoted(name.str()) << "}}";
+    write(os.str());
+  }
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef TIMELINE_HPP
+#define TIMELINE_HPP
+
+#include <crpcut.hpp>
+
+namespace crpcut {
+
+  // A timeline of the run in the trace event format of chrome://tracing
+  // and Perfetto, with one track per slot, i.e. per concurrently running
+  // test process. Each test is a span on the track of its slot, with a
+  // nested span for each phase, beginning with the fork. Kills, timeouts
+  // and dependency stalls are instant events. Events are written as they
+  // happen, unbuffered, since test processes are forked from the process
+  // that writes them. Nothing is written if fd is -1.
+  class timeline
+  {
+  public:
+    timeline(int fd, std::size_t num_slots);
+    ~timeline();
+    void begin_test(unsigned slot, const crpcut_test_case_registrator &t);
+    void enter(unsigned slot, test_phase phase);
+    void end_test(unsigned slot, pid_t pid, bool pass);
+    void instant(unsigned slot, const char *name);
+    // No test could be started, for waiting on running tests they
+    // depend on.
+    void stall(std::size_t num_running);
+    // t was never run, since tests it depends on failed.
+    void blocked(const crpcut_test_case_registrator &t);
+  private:
+    timeline(const timeline&);
+    timeline& operator=(const timeline&);
+    std::ostream &header(std::ostream &os, char ph, unsigned slot);
+    void write(const std::string &s) const;
+
+    int           fd_;
+    unsigned long start_us_;
+    pid_t         pid_;
+    bool          first_;
+  };
+}
+
+#endif // TIMELINE_HPP
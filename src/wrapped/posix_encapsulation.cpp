@@ -37,6 +37,10 @@ extern "C"
 #include <sys/wait.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sched.h>
 #include <dirent.h>
 }
 #include "posix_encapsulation.hpp"
@@ -158,6 +162,61 @@ namespace crpcut {
 }
 #endif
 
+#if defined(HAVE_INOTIFY)
+extern "C" {
+#  include <sys/inotify.h>
+}
+namespace crpcut {
+  namespace wrapped {
+    CRPCUT_WRAP_FUNC(libc, inotify_init1, int, (int flags), (flags))
+    CRPCUT_WRAP_FUNC(libc, inotify_add_watch,
+                     int,
+                     (int fd, const char *n, uint32_t m),
+                     (fd, n, m))
+  }
+}
+#endif
+
+#if defined(HAVE_UNSHARE)
+extern "C" {
+#  include <sched.h>
+#  include <sys/mount.h>
+}
+namespace crpcut {
+  namespace wrapped {
+    CRPCUT_WRAP_FUNC(libc, mount,
+                     int,
+                     (const char *s, const char *t, const char *fs,
+                      unsigned long f, const void *d),
+                     (s, t, fs, f, d))
+    CRPCUT_WRAP_FUNC(libc, unshare, int, (int flags), (flags))
+  }
+}
+#endif
+
+#if defined(HAVE_MEMFD_CREATE)
+extern "C" {
+#  include <sys/mman.h>
+}
+namespace crpcut {
+  namespace wrapped {
+    CRPCUT_WRAP_FUNC(libc, memfd_create,
+                     int,
+                     (const char *n, unsigned f),
+                     (n, f))
+  }
+}
+#endif
+
+#if defined(HAVE_TGKILL)
+namespace crpcut {
+  namespace wrapped {
+    CRPCUT_WRAP_FUNC(libc, gettid, pid_t, (void), ())
+    CRPCUT_WRAP_FUNC(libc, tgkill, int, (pid_t p, pid_t t, int s), (p, t, s))
+  }
+}
+#endif
+
 #if defined(HAVE_EPOLL)
 extern "C" {
  #include <sys/epoll.h>
@@ -186,15 +245,38 @@ namespace crpcut {
     CRPCUT_WRAP_FUNC(rtld_next, calloc, void *, (size_t n, size_t s), (n, s))
     CRPCUT_WRAP_FUNC(rtld_next, realloc, void *, (void *m, size_t n), (m, n))
 
+    CRPCUT_WRAP_FUNC(libc, accept, int,
+                     (int fd, struct sockaddr *a, socklen_t *l),
+                     (fd, a, l))
+    CRPCUT_WRAP_FUNC(libc, bind, int,
+                     (int fd, const struct sockaddr *a, socklen_t l),
+                     (fd, a, l))
     CRPCUT_WRAP_FUNC(libc, chdir, int, (const char *n), (n))
     CRPCUT_WRAP_FUNC(libc, close, int, (int fd), (fd))
     CRPCUT_WRAP_FUNC(libc, closedir, int, (DIR *d), (d))
+    CRPCUT_WRAP_FUNC(libc, connect, int,
+                     (int fd, const struct sockaddr *a, socklen_t l),
+                     (fd, a, l))
     CRPCUT_WRAP_FUNC(libc, dup2, int, (int f1, int f2), (f1, f2))
+    CRPCUT_WRAP_FUNC(libc, execv, int,
+                     (const char *p, char *const argv[]),
+                     (p, argv))
+    // fcntl is variadic, so it must be called through a variadic pointer
+    extern "C" typedef int (*f_fcntl_t)(int, int, ...);
+    int fcntl(int fd, int cmd, long arg)
+    {
+      static f_fcntl_t f_fcntl
+        = libwrapper::loader<libs::libc>::obj().sym<f_fcntl_t>("fcntl");
+      return f_fcntl(fd, cmd, arg);
+    }
     CRPCUT_WRAP_FUNC(libc, fork, int, (void), ())
+    CRPCUT_WRAP_FUNC(libc, fsync, int, (int fd), (fd))
+    CRPCUT_WRAP_FUNC(libc, ftruncate, int, (int fd, off_t l), (fd, l))
     CRPCUT_WRAP_FUNC(libc, getcwd, char*, (char *buf, size_t size), (buf, size))
     CRPCUT_WRAP_FUNC(libc, getenv, char*, (const char*n), (n))
     CRPCUT_WRAP_FUNC(libc, gethostname, int, (char *n, size_t s), (n, s))
     CRPCUT_WRAP_FUNC(libc, getitimer, int, (int i, struct itimerval *v), (i, v))
+    CRPCUT_WRAP_FUNC(libc, getgid, gid_t, (void), ())
     CRPCUT_WRAP_FUNC(libc, getpgid, pid_t, (pid_t p), (p))
     CRPCUT_WRAP_FUNC(libc, getpid, int, (void), ())
     CRPCUT_WRAP_FUNC(libc, getrusage, int, (int w, struct rusage *u), (w, u))
@@ -202,8 +284,20 @@ namespace crpcut {
                      int,
                      (struct timeval *tv, struct timezone *tz),
                      (tv, tz))
+    CRPCUT_WRAP_FUNC(libc, getuid, uid_t, (void), ())
     CRPCUT_WRAP_FUNC(libc, gmtime, struct tm*, (const time_t *t), (t))
+    // ioctl is variadic, so it must be called through a variadic pointer
+    extern "C" typedef int (*f_ioctl_t)(int, unsigned long, ...);
+    int ioctl(int fd, unsigned long r, void *p)
+    {
+      static f_ioctl_t f_ioctl
+        = libwrapper::loader<libs::libc>::obj().sym<f_ioctl_t>("ioctl");
+      return f_ioctl(fd, r, p);
+    }
+    CRPCUT_WRAP_FUNC(libc, kill, int, (pid_t p, int s), (p, s))
     CRPCUT_WRAP_FUNC(libc, killpg, int, (int p, int s), (p, s))
+    CRPCUT_WRAP_FUNC(libc, listen, int, (int fd, int b), (fd, b))
+    CRPCUT_WRAP_FUNC(libc, lseek, off_t, (int fd, off_t o, int w), (fd, o, w))
     CRPCUT_WRAP_FUNC(libc, memcpy, void*,
                      (void *d, const void *s, size_t n), (d, s, n))
     CRPCUT_WRAP_FUNC(libc, mkdir, int, (const char *n, mode_t m), (n, m))
@@ -211,6 +305,11 @@ namespace crpcut {
     CRPCUT_WRAP_FUNC(libc, open, int,
                      (const char *n, int m, mode_t t),
                      (n, m, t))
+    CRPCUT_WRAP_FUNC(libc, mmap,
+                     void*,
+                     (void *a, size_t l, int p, int f, int fd, off_t o),
+                     (a, l, p, f, fd, o))
+    CRPCUT_WRAP_FUNC(libc, munmap, int, (void *a, size_t l), (a, l))
     CRPCUT_WRAP_FUNC(libc, opendir, DIR*, (const char *n), (n))
     CRPCUT_WRAP_FUNC(libc, pipe, int, (int p[2]), (p))
     CRPCUT_WRAP_FUNC(libc, read, ssize_t,
@@ -220,6 +319,9 @@ namespace crpcut {
                      int,
                      (DIR *d, struct dirent *e, struct dirent **r),
                      (d, e, r))
+    CRPCUT_WRAP_FUNC(libc, readlink, ssize_t,
+                     (const char *n, char *buf, size_t size),
+                     (n, buf, size))
     CRPCUT_WRAP_FUNC(libc, regcomp, int, (regex_t* r, const char *e, int f), (r, e, f))
     CRPCUT_WRAP_FUNC(libc, regexec,
                      int,
@@ -236,6 +338,7 @@ namespace crpcut {
     CRPCUT_WRAP_FUNC(libc, remove, int, (const char *n), (n))
     CRPCUT_WRAP_FUNC(libc, rename, int, (const char *o, const char *n), (o, n))
     CRPCUT_WRAP_FUNC(libc, rmdir, int, (const char *n), (n))
+    CRPCUT_WRAP_FUNC(libc, sched_yield, int, (void), ())
     CRPCUT_WRAP_FUNC(libc, select,
                      int,
                      (int n, fd_set *r, fd_set *w, fd_set *e, struct timeval *t),
@@ -250,6 +353,11 @@ namespace crpcut {
                      (int n, const struct rlimit *r),
                      (n, r))
     CRPCUT_WRAP_FUNC(libc, signal, sighandler_t, (int s, sighandler_t h), (s, h))
+    CRPCUT_WRAP_FUNC(libc, socket, int, (int d, int t, int p), (d, t, p))
+    CRPCUT_WRAP_FUNC(libc, socketpair,
+                     int,
+                     (int d, int t, int p, int s[2]),
+                     (d, t, p, s))
     CRPCUT_WRAP_FUNC(libc, strcmp, int, (const char *l, const char *r), (l, r))
     CRPCUT_WRAP_FUNC(libc, strerror, char *, (int n), (n))
     CRPCUT_WRAP_FUNC(libc, strlen, size_t, (const char *p), (p))
@@ -261,6 +369,10 @@ namespace crpcut {
     CRPCUT_WRAP_FUNC(libc, strstr, char *, (const char *h, const char *n),
                      (h, n))
     CRPCUT_WRAP_FUNC(libc, time, time_t, (time_t *p), (p))
+    CRPCUT_WRAP_FUNC(libc, wait4,
+                     pid_t,
+                     (pid_t p, int *s, int o, struct rusage *u),
+                     (p, s, o, u))
     CRPCUT_WRAP_FUNC(libc, waitid,
                      int,
                      (idtype_t t, id_t i, siginfo_t *s, int o),
@@ -269,6 +381,10 @@ namespace crpcut {
                      ssize_t,
                      (int f, const void *p, size_t s),
                      (f, p, s))
+    CRPCUT_WRAP_FUNC(libc, writev,
+                     ssize_t,
+                     (int f, const struct iovec *v, int n),
+                     (f, v, n))
     CRPCUT_WRAP_V_FUNC(libc, _Exit, CRPCUT_NORETURN void, (int n), (n))
     CRPCUT_WRAP_V_FUNC(libc, abort, CRPCUT_NORETURN void, (void),  ())
     CRPCUT_WRAP_V_FUNC(libc, exit,  CRPCUT_NORETURN void, (int n), (n))
@@ -280,4 +396,11 @@ namespace crpcut {
   {
     return wrapped::write(fd, p, n);
   }
+
+  ssize_t
+  libc_write
+  ::do_writev(int fd, const struct iovec *v, int count)
+  {
+    return wrapped::writev(fd, v, count);
+  }
 }
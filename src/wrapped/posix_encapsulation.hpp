@@ -33,6 +33,8 @@ extern "C" {
 #  include <dirent.h>
 #  include <signal.h>
 #  include <sys/resource.h>
+#  include <sys/socket.h>
+#  include <sys/uio.h>
 }
 
 #include "../posix_write.hpp"
@@ -43,46 +45,88 @@ namespace crpcut {
   namespace wrapped {
     CRPCUT_NORETURN void _Exit(int c);
     CRPCUT_NORETURN void abort();
+    int                  accept(int fd, struct sockaddr *a, socklen_t *l);
+    int                  bind(int fd, const struct sockaddr *a, socklen_t l);
     int                  chdir(const char *n);
     int                  close(int);
     int                  closedir(DIR* p);
+    int                  connect(int fd, const struct sockaddr *a, socklen_t l);
     int                  dup2(int o, int n);
+    int                  execv(const char *p, char *const argv[]);
     CRPCUT_NORETURN void exit(int c);
+    int                  fcntl(int fd, int cmd, long arg);
     int                  fork(void);
+    int                  fsync(int fd);
+    int                  ftruncate(int fd, off_t len);
     void                 free(const void*);
     char *               getcwd(char *buf, size_t size);
     char *               getenv(const char*);
     int                  gethostname(char *n, size_t l);
+    gid_t                getgid();
     pid_t                getpgid(pid_t);
     pid_t                getpid();
+#ifdef HAVE_TGKILL
+    pid_t                gettid();
+#endif
     int                  getrusage(int, struct rusage *);
+    uid_t                getuid();
     struct tm *          gmtime(const time_t *t);
+#ifdef HAVE_INOTIFY
+    int                  inotify_add_watch(int fd, const char *n, uint32_t m);
+    int                  inotify_init1(int flags);
+#endif
+    int                  ioctl(int fd, unsigned long r, void *p);
+    int                  kill(pid_t p, int s);
     int                  killpg(int p, int s);
+    int                  listen(int fd, int backlog);
     void *               malloc(size_t);
+    off_t                lseek(int fd, off_t o, int w);
     void *               memcpy(void *d, const void *s, size_t n);
+#ifdef HAVE_MEMFD_CREATE
+    int                  memfd_create(const char *n, unsigned f);
+#endif
     int                  mkdir(const char *n, mode_t m);
     char *               mkdtemp(char *t);
+    void *               mmap(void *a, size_t l, int p, int f, int fd, off_t o);
+#ifdef HAVE_UNSHARE
+    int                  mount(const char *s, const char *t, const char *fs,
+                               unsigned long f, const void *d);
+#endif
+    int                  munmap(void *a, size_t l);
     DIR*                 opendir(const char *n);
     int                  open(const char *, int, mode_t);
     int                  pipe(int p[2]);
     int                  readdir_r(DIR* p, struct dirent* e, struct dirent** r);
+    ssize_t              readlink(const char *n, char *buf, size_t size);
     int                  rename(const char *o, const char *n);
     int                  remove(const char *n);
     int                  rmdir(const char *n);
+    int                  sched_yield();
     int                  select(int, fd_set*, fd_set*, fd_set*, timeval *);
     int                  setpgid(pid_t pid, pid_t pgid);
     int                  setrlimit(int, const struct rlimit*);
     sighandler_t         signal(int, sighandler_t);
+    int                  socket(int domain, int type, int protocol);
+    int                  socketpair(int d, int t, int p, int s[2]);
     int                  strncmp(const char *s1, const char *s2, size_t n);
     char *               strchr(const char *, int);
     char *               strstr(const char *, const char *);
+#ifdef HAVE_TGKILL
+    int                  tgkill(pid_t p, pid_t t, int s);
+#endif
     time_t               time(time_t *t);
+#ifdef HAVE_UNSHARE
+    int                  unshare(int flags);
+#endif
+    pid_t                wait4(pid_t p, int *s, int o, struct rusage *u);
     int                  waitid(idtype_t t, id_t i, siginfo_t *si, int o);
+    ssize_t              writev(int fd, const struct iovec *v, int n);
   }
 
   class libc_write : public posix_write
   {
     virtual ssize_t do_write(int fd, const void *p, std::size_t n);
+    virtual ssize_t do_writev(int fd, const struct iovec *v, int count);
   };
 }
 #endif // POSIX_ENCAPSULATION_HPP
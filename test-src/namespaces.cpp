@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 Bjorn Fahller <bjorn@fahller.se>
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+#include <crpcut.hpp>
+extern "C" {
+#include <unistd.h>
+#include <dirent.h>
+#include <net/if.h>
+}
+#include <cstring>
+
+// Hosts without namespaces run these tests without isolation, where they
+// fail. The tag lets the self test leave them out there.
+DEFINE_TEST_TAG(isolation);
+
+TESTSUITE(namespaces)
+{
+  TEST(should_succeed_as_second_process_in_pid_namespace,
+       ISOLATED_NAMESPACES(crpcut::isolate::pid),
+       WITH_TEST_TAG(isolation))
+  {
+    ASSERT_EQ(getpid(), 2);
+  }
+
+  TEST(should_succeed_with_only_loopback_in_network_namespace,
+       ISOLATED_NAMESPACES(crpcut::isolate::network),
+       WITH_TEST_TAG(isolation))
+  {
+    struct if_nameindex *interfaces = if_nameindex();
+    ASSERT_TRUE(interfaces);
+    const bool only_lo
+      = interfaces[0].if_name != 0
+      && std::strcmp(interfaces[0].if_name, "lo") == 0
+      && interfaces[1].if_name == 0;
+    if_freenameindex(interfaces);
+    ASSERT_TRUE(only_lo);
+  }
+
+  TEST(should_succeed_with_empty_tmp_in_mount_namespace,
+       ISOLATED_NAMESPACES(crpcut::isolate::tmp),
+       WITH_TEST_TAG(isolation))
+  {
+    DIR *d = opendir("/tmp");
+    ASSERT_TRUE(d);
+    int entries = 0;
+    while (struct dirent *e = readdir(d))
+      {
+        if (std::strcmp(e->d_name, ".") && std::strcmp(e->d_name, ".."))
+          ++entries;
+      }
+    closedir(d);
+    ASSERT_EQ(entries, 0);
+  }
+}